@@ -0,0 +1,507 @@
+// AhoCorasick.hpp
+
+#ifndef CPP_EX3_AHOCORASICK_HPP
+#define CPP_EX3_AHOCORASICK_HPP
+
+#define ROOT_STATE 0
+#define NO_STATE (-1)
+#define OTHER_BYTES_CLASS 0
+#define ALPHABET_SIZE 256
+#define FIRST_UPPER_CHAR 65
+#define LAST_UPPER_CHAR 92
+#define LOWER_CASE_OFFSET 32
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstring>
+
+// ------------------------------------------- class declaration -----------------------------------
+
+/**
+ * @brief a compiled multi-pattern matcher (Aho-Corasick automaton) over a table of scored phrases.
+ *        The automaton is built once and then scores a text in a single linear pass, counting
+ *        every (possibly overlapping) appearance of every phrase, case-insensitively, exactly
+ *        like a phrase-by-phrase scan of the text
+ */
+class AhoCorasick
+{
+public:
+
+    /**
+     * @brief the flat arrays that the automaton is made of. They are owned by the automaton when
+     *        it is built from phrases, or point into an external buffer (a mapped snapshot file)
+     */
+    struct Tables
+    {
+        int classCount;             // the number of byte classes (columns of the table)
+        int stateCount;             // the number of states (rows of the table)
+        int patternCount;           // the number of phrases
+        int patternBytesSize;       // the total length of the phrases
+        const int* byteClass;       // maps each byte to it's class (ALPHABET_SIZE items)
+        const int* delta;           // the transition table (stateCount * classCount items)
+        const int* outScore;        // the total score of the phrases that end in each state
+        const int* outLink;         // the closest suffix state that ends a phrase
+        const int* outBegin;        // the index of the first phrase that ends in each state
+        const int* outIds;          // the ids of the phrases that end in each state
+        const int* patternScores;   // the scores of the phrases, by id
+        const int* patternOffsets;  // where each phrase starts in patternBytes (patternCount + 1)
+        const char* patternBytes;   // the phrases one after the other
+    };
+
+    /**
+     * @brief builds the automaton from a map of phrases and their scores
+     * @tparam MapT - a map type that can be iterated over pairs of <std::string, int>
+     * @param phrases - the phrases and their scores
+     */
+    template <class MapT>
+    explicit AhoCorasick(const MapT& phrases);
+
+    /**
+     * @brief creates an automaton over tables that were already built (for example, in a mapped
+     *        snapshot file). Nothing is copied
+     * @param tables - the tables of the automaton
+     * @param storage - an object that keeps the memory of the tables alive
+     */
+    AhoCorasick(const Tables& tables, std::shared_ptr<const void> storage);
+
+    AhoCorasick(const AhoCorasick&) = delete;
+    AhoCorasick& operator=(const AhoCorasick&) = delete;
+    AhoCorasick(AhoCorasick&&) = default;
+    AhoCorasick& operator=(AhoCorasick&&) = default;
+
+    /**
+     * @brief returns the tables of the automaton
+     * @return the tables
+     */
+    const Tables& tables() const
+    {
+        return _tables;
+    }
+
+    /**
+     * @brief returns the byte the matcher compares instead of the given byte (upper case letters
+     *        are folded to lower case)
+     * @param c - the byte
+     * @return the folded byte
+     */
+    static unsigned char fold(unsigned char c)
+    {
+        return (c >= FIRST_UPPER_CHAR && c <= LAST_UPPER_CHAR) ? c + LOWER_CASE_OFFSET : c;
+    }
+
+    /**
+     * @brief calculates the total score of a text (times each phrase appears * it's score)
+     * @param text - the text to score
+     * @return the total score of the text
+     */
+    int score(const std::string& text) const;
+
+    /**
+     * @brief scans a piece of a text, starting from the given state of the automaton, and
+     *        returns the score of all phrases that end inside the piece. The state is updated so
+     *        the next piece of the same text can continue from where this one stopped
+     * @param state  - the state of the automaton, updated after the scan
+     * @param data   - the piece of text to scan
+     * @param length - the length of the piece
+     * @return the score of the phrases found
+     */
+    int scan(int& state, const char* data, size_t length) const;
+
+    /**
+     * @brief like scan, but the given byte is skipped as if it was not in the text (for example,
+     *        to scan the lines of a text as if they were joined)
+     * @param state   - the state of the automaton, updated after the scan
+     * @param data    - the piece of text to scan
+     * @param length  - the length of the piece
+     * @param skipped - the byte to skip
+     * @return the score of the phrases found
+     */
+    int scanSkipping(int& state, const char* data, size_t length, char skipped) const;
+
+    /**
+     * @brief like scan, but stops right after the byte where the total score reaches the target.
+     *        Scores are never negative, so the rest of the text can't bring the total back below
+     *        the target
+     * @param state  - the state of the automaton, updated after the scan
+     * @param data   - the piece of text to scan
+     * @param length - the length of the piece
+     * @param total  - the total score so far, updated after the scan
+     * @param target - the score to stop at
+     * @return the number of bytes that were scanned
+     */
+    size_t scanUntil(int& state, const char* data, size_t length, int& total, int target) const;
+
+    /**
+     * @brief like scanUntil, but the given byte is skipped as if it was not in the text (see
+     *        scanSkipping)
+     * @param state   - the state of the automaton, updated after the scan
+     * @param data    - the piece of text to scan
+     * @param length  - the length of the piece
+     * @param total   - the total score so far, updated after the scan
+     * @param target  - the score to stop at
+     * @param skipped - the byte to skip
+     * @return the number of bytes that were scanned (including the skipped bytes)
+     */
+    size_t scanSkippingUntil(int& state, const char* data, size_t length, int& total, int target,
+                             char skipped) const;
+
+    /**
+     * @brief counts the number of times each phrase appears in the text
+     * @param text - the text to scan
+     * @return a vector with the number of appearances of each phrase, by the phrase id
+     */
+    std::vector<int> countMatches(const std::string& text) const;
+
+    /**
+     * @brief scans a piece of a text like scan, and calls a function for every appearance of
+     *        every phrase (slower than scan, it goes over the phrases that end at each byte)
+     * @tparam F - a function (int id, size_t end)
+     * @param state - the state of the automaton, updated after the scan
+     * @param data - the piece of text to scan
+     * @param length - the length of the piece
+     * @param onMatch - called with the id of the phrase and the index in data of it's last byte
+     */
+    template <class F>
+    void forEachMatch(int& state, const char* data, size_t length, F onMatch) const;
+
+    /**
+     * @brief returns the number of phrases in the automaton
+     * @return the number of phrases
+     */
+    int patternCount() const
+    {
+        return _tables.patternCount;
+    }
+
+    /**
+     * @brief returns the number of states in the automaton
+     * @return the number of states
+     */
+    int stateCount() const
+    {
+        return _tables.stateCount;
+    }
+
+    /**
+     * @brief returns the phrase with the given id
+     * @param id - the id of the phrase
+     * @return the phrase
+     */
+    std::string_view pattern(int id) const
+    {
+        int begin = _tables.patternOffsets[id];
+        return std::string_view(_tables.patternBytes + begin,
+                                _tables.patternOffsets[id + 1] - begin);
+    }
+
+    /**
+     * @brief returns the score of the phrase with the given id
+     * @param id - the id of the phrase
+     * @return the score of the phrase
+     */
+    int patternScore(int id) const
+    {
+        return _tables.patternScores[id];
+    }
+
+private:
+    Tables _tables;                     // the arrays the automaton uses
+
+    // the arrays of an automaton that was built from phrases (empty for external tables)
+    int _classCount;                    // the number of byte classes while building
+    std::vector<int> _byteClass;        // maps each byte to it's class
+    std::vector<int> _delta;            // the transition table, stateCount * classCount
+    std::vector<int> _outScore;         // the total score of the phrases that end in each state
+    std::vector<int> _outLink;          // the closest suffix state that ends a phrase
+    std::vector<int> _outBegin;         // the index of the first phrase that ends in each state
+    std::vector<int> _outIds;           // the ids of the phrases that end in each state
+    std::vector<int> _patternScores;    // the scores of the phrases, by id
+    std::vector<int> _patternOffsets;   // where each phrase starts in _patternBytes
+    std::vector<char> _patternBytes;    // the phrases one after the other
+
+    std::shared_ptr<const void> _storage; // keeps external tables alive
+
+    // adds a new state with no transitions and returns it's index
+    int _addState();
+
+    // builds the trie, the failure transitions and the outputs of the automaton
+    void _build(const std::vector<std::string>& patterns);
+
+    // points the tables to the arrays that were built
+    void _setTables();
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+template <class MapT>
+AhoCorasick::AhoCorasick(const MapT& phrases): _tables(), _classCount(0),
+                                               _byteClass(ALPHABET_SIZE, 0)
+{
+    std::vector<std::string> patterns;
+    for (auto it = phrases.begin(); it != phrases.end(); it++)
+    {
+        patterns.push_back(std::string(it->first));
+        _patternScores.push_back(it->second);
+    }
+    _build(patterns);
+
+    // Saves the phrases one after the other
+    _patternOffsets.push_back(0);
+    for (const std::string& pattern : patterns)
+    {
+        _patternBytes.insert(_patternBytes.end(), pattern.begin(), pattern.end());
+        _patternOffsets.push_back((int)_patternBytes.size());
+    }
+    _setTables();
+}
+
+inline AhoCorasick::AhoCorasick(const Tables& tables, std::shared_ptr<const void> storage)
+        : _tables(tables), _classCount(tables.classCount), _storage(std::move(storage))
+{
+}
+
+inline void AhoCorasick::_setTables()
+{
+    _tables.classCount       = _classCount;
+    _tables.stateCount       = (int)_outScore.size();
+    _tables.patternCount     = (int)_patternScores.size();
+    _tables.patternBytesSize = (int)_patternBytes.size();
+    _tables.byteClass        = _byteClass.data();
+    _tables.delta            = _delta.data();
+    _tables.outScore         = _outScore.data();
+    _tables.outLink          = _outLink.data();
+    _tables.outBegin         = _outBegin.data();
+    _tables.outIds           = _outIds.data();
+    _tables.patternScores    = _patternScores.data();
+    _tables.patternOffsets   = _patternOffsets.data();
+    _tables.patternBytes     = _patternBytes.data();
+}
+
+inline int AhoCorasick::_addState()
+{
+    _delta.insert(_delta.end(), _classCount, NO_STATE);
+    _outScore.push_back(0);
+    return (int)_outScore.size() - 1;
+}
+
+inline void AhoCorasick::_build(const std::vector<std::string>& patterns)
+{
+    // Gives a class to every (folded) byte that appears in a phrase, all other bytes share a class
+    std::vector<int> classOfFolded(ALPHABET_SIZE, OTHER_BYTES_CLASS);
+    _classCount = 1;
+    for (const std::string& pattern : patterns)
+    {
+        for (char c : pattern)
+        {
+            unsigned char folded = fold((unsigned char)c);
+            if (classOfFolded[folded] == OTHER_BYTES_CLASS)
+            {
+                classOfFolded[folded] = _classCount++;
+            }
+        }
+    }
+    for (int b = 0; b < ALPHABET_SIZE; b++)
+    {
+        _byteClass[b] = classOfFolded[fold((unsigned char)b)];
+    }
+
+    // Builds the trie of the phrases and saves the state that ends each phrase
+    _addState();
+    std::vector<int> endState(patterns.size());
+    for (int id = 0; id < (int)patterns.size(); id++)
+    {
+        int state = ROOT_STATE;
+        for (char c : patterns[id])
+        {
+            int index = state * _classCount + _byteClass[(unsigned char)c];
+            if (_delta[index] == NO_STATE)
+            {
+                int next = _addState();
+                _delta[index] = next;
+            }
+            state = _delta[index];
+        }
+        endState[id] = state;
+        _outScore[state] += _patternScores[id];
+    }
+
+    // Saves the ids of the phrases that end in each state, grouped by the state
+    int numOfStates = (int)_outScore.size();
+    _outBegin.assign(numOfStates + 1, 0);
+    for (int state : endState)
+    {
+        _outBegin[state + 1]++;
+    }
+    for (int state = 0; state < numOfStates; state++)
+    {
+        _outBegin[state + 1] += _outBegin[state];
+    }
+    _outIds.resize(patterns.size());
+    std::vector<int> nextFree(_outBegin.begin(), _outBegin.end() - 1);
+    for (int id = 0; id < (int)patterns.size(); id++)
+    {
+        _outIds[nextFree[endState[id]]++] = id;
+    }
+
+    // Goes over the trie in BFS order, completes the missing transitions with the transitions of
+    // the failure state and accumulates the outputs of the suffixes of each state
+    std::vector<int> failure(numOfStates, ROOT_STATE);
+    _outLink.assign(numOfStates, NO_STATE);
+    std::vector<int> queue;
+    queue.reserve(numOfStates);
+    for (int c = 0; c < _classCount; c++)
+    {
+        int& next = _delta[c];
+        if (next == NO_STATE)
+        {
+            next = ROOT_STATE;
+        }
+        else
+        {
+            queue.push_back(next);
+        }
+    }
+    for (int head = 0; head < (int)queue.size(); head++)
+    {
+        int state = queue[head];
+        int fail = failure[state];
+        for (int c = 0; c < _classCount; c++)
+        {
+            int& next = _delta[state * _classCount + c];
+            int failNext = _delta[fail * _classCount + c];
+            if (next == NO_STATE)
+            {
+                next = failNext;
+                continue;
+            }
+            failure[next] = failNext;
+            _outScore[next] += _outScore[failNext];
+            _outLink[next] = (_outBegin[failNext] != _outBegin[failNext + 1]) ? failNext
+                                                                            : _outLink[failNext];
+            queue.push_back(next);
+        }
+    }
+}
+
+inline int AhoCorasick::scan(int& state, const char* data, size_t length) const
+{
+    int total = 0;
+    int curr = state;
+    const int classCount = _tables.classCount;
+    const int* delta = _tables.delta;
+    const int* byteClass = _tables.byteClass;
+    const int* outScore = _tables.outScore;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        curr = delta[curr * classCount + byteClass[(unsigned char)data[i]]];
+        total += outScore[curr];
+    }
+    state = curr;
+    return total;
+}
+
+inline int AhoCorasick::scanSkipping(int& state, const char* data, size_t length,
+                                     char skipped) const
+{
+    int total = 0;
+    const char* end = data + length;
+
+    // Scans the runs between the skipped bytes, memchr finds the next one much faster than a check
+    // of every byte inside the scan loop
+    while (data < end)
+    {
+        const char* found = static_cast<const char*>(std::memchr(data, skipped, end - data));
+        const char* runEnd = (found != nullptr) ? found : end;
+        total += scan(state, data, runEnd - data);
+        data = (found != nullptr) ? found + 1 : end;
+    }
+    return total;
+}
+
+inline size_t AhoCorasick::scanUntil(int& state, const char* data, size_t length, int& total,
+                                     int target) const
+{
+    int sum = total;
+    int curr = state;
+    const int classCount = _tables.classCount;
+    const int* delta = _tables.delta;
+    const int* byteClass = _tables.byteClass;
+    const int* outScore = _tables.outScore;
+
+    size_t i = 0;
+    while (i < length && sum < target)
+    {
+        curr = delta[curr * classCount + byteClass[(unsigned char)data[i]]];
+        sum += outScore[curr];
+        i++;
+    }
+    state = curr;
+    total = sum;
+    return i;
+}
+
+inline size_t AhoCorasick::scanSkippingUntil(int& state, const char* data, size_t length,
+                                             int& total, int target, char skipped) const
+{
+    const char* begin = data;
+    const char* end = data + length;
+    while (data < end && total < target)
+    {
+        const char* found = static_cast<const char*>(std::memchr(data, skipped, end - data));
+        const char* runEnd = (found != nullptr) ? found : end;
+        data += scanUntil(state, data, runEnd - data, total, target);
+        if (data < runEnd)
+        {
+            break;
+        }
+        data = (found != nullptr) ? found + 1 : end;
+    }
+    return data - begin;
+}
+
+inline int AhoCorasick::score(const std::string& text) const
+{
+    int state = ROOT_STATE;
+    return scan(state, text.data(), text.size());
+}
+
+template <class F>
+void AhoCorasick::forEachMatch(int& state, const char* data, size_t length, F onMatch) const
+{
+    int curr = state;
+    const Tables& t = _tables;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        curr = t.delta[curr * t.classCount + t.byteClass[(unsigned char)data[i]]];
+
+        // Goes over the state and all of it's suffixes that end a phrase
+        for (int out = curr; out != NO_STATE; out = t.outLink[out])
+        {
+            for (int k = t.outBegin[out]; k < t.outBegin[out + 1]; k++)
+            {
+                onMatch(t.outIds[k], i);
+            }
+        }
+    }
+    state = curr;
+}
+
+inline std::vector<int> AhoCorasick::countMatches(const std::string& text) const
+{
+    std::vector<int> counts(_tables.patternCount, 0);
+    int state = ROOT_STATE;
+    forEachMatch(state, text.data(), text.size(), [&counts](int id, size_t)
+    {
+        counts[id]++;
+    });
+    return counts;
+}
+
+#endif //CPP_EX3_AHOCORASICK_HPP
@@ -0,0 +1,162 @@
+// BloomFilter.hpp
+
+#ifndef CPP_EX3_BLOOMFILTER_HPP
+#define CPP_EX3_BLOOMFILTER_HPP
+
+#define BLOOM_WORD_BITS 64
+#define BLOOM_PROBES 4
+#define BLOOM_PROBE_SHIFT 6
+#define BLOOM_FIRST_PROBE_BIT 32
+#define BLOOM_MIX_SEED 0x2545f4914f6cdd1dULL
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include "FastHash.hpp"
+
+// ------------------------------------------- class declaration -----------------------------------
+
+template <class Alloc = std::allocator<uint64_t>>
+
+/**
+ * @brief a blocked Bloom filter over hash values: every hash sets BLOOM_PROBES bits in a single
+ *        64 bit word, so a lookup reads one word (one cache line at most) and a hash whose bits
+ *        are not all set was surely never added. Hashes can't be removed, a filter is reset and
+ *        filled again instead. The hashes are mixed again before they are used, so the bits don't
+ *        depend on the low bits that pick the bucket of a key in a power of two table
+ * @tparam Alloc - the allocator of the words
+ */
+class BloomFilter
+{
+public:
+
+    /**
+     * @brief creates a filter without words, it can't reject any hash until it is reset
+     * @param allocator - the allocator of the words
+     */
+    explicit BloomFilter(const Alloc& allocator = Alloc()) : _words(allocator), _mask(0)
+    {
+    }
+
+    /**
+     * @brief sizes the filter to at least the given number of bits (rounded up to a power of two
+     *        number of words) and clears it
+     * @param bits - the number of bits
+     */
+    void reset(size_t bits);
+
+    /**
+     * @brief frees the words of the filter, it can't reject any hash until it is reset
+     */
+    void release()
+    {
+        std::vector<uint64_t, Alloc>(_words.get_allocator()).swap(_words);
+        _mask = 0;
+    }
+
+    /**
+     * @brief clears all the bits, keeps the size of the filter
+     */
+    void clear()
+    {
+        std::fill(_words.begin(), _words.end(), 0);
+    }
+
+    /**
+     * @brief checks if the filter has words (was reset and not released)
+     * @return true if the filter has words, false otherwise
+     */
+    bool isSized() const
+    {
+        return !_words.empty();
+    }
+
+    /**
+     * @brief adds a hash to the filter, the filter must be sized
+     * @param hash - the hash
+     */
+    void add(size_t hash)
+    {
+        uint64_t mixed = _mix(hash);
+        _words[mixed & _mask] |= _bitsOf(mixed);
+    }
+
+    /**
+     * @brief checks if a hash may have been added to the filter
+     * @param hash - the hash
+     * @return false if the hash was surely not added, true otherwise (always true if the filter
+     *         is not sized)
+     */
+    bool mayContain(size_t hash) const
+    {
+        if (_words.empty())
+        {
+            return true;
+        }
+        uint64_t mixed = _mix(hash);
+        uint64_t bits = _bitsOf(mixed);
+        return (_words[mixed & _mask] & bits) == bits;
+    }
+
+    /**
+     * @brief returns the number of bytes of the words of the filter
+     * @return the number of bytes
+     */
+    size_t bytes() const
+    {
+        return _words.size() * sizeof(uint64_t);
+    }
+
+    /**
+     * @brief exchanges the words of two filters, the filters must have equal allocators
+     * @param other - the other filter
+     */
+    void swap(BloomFilter& other) noexcept
+    {
+        _words.swap(other._words);
+        std::swap(_mask, other._mask);
+    }
+
+private:
+    std::vector<uint64_t, Alloc> _words; // the bits of the filter
+    size_t _mask;                        // the number of words - 1
+
+    // mixes a hash, the low bits pick the word and the high bits pick the bits in it
+    static uint64_t _mix(size_t hash)
+    {
+        return FastHashCore::hashWord((uint64_t)hash, BLOOM_MIX_SEED);
+    }
+
+    // returns the bits of a mixed hash in it's word
+    static uint64_t _bitsOf(uint64_t mixed)
+    {
+        uint64_t bits = 0;
+        for (int probe = 0; probe < BLOOM_PROBES; probe++)
+        {
+            int shift = BLOOM_FIRST_PROBE_BIT + probe * BLOOM_PROBE_SHIFT;
+            bits |= (uint64_t)1 << ((mixed >> shift) & (BLOOM_WORD_BITS - 1));
+        }
+        return bits;
+    }
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+template <class Alloc>
+void BloomFilter<Alloc>::reset(size_t bits)
+{
+    size_t count = 1;
+    while (count * BLOOM_WORD_BITS < bits)
+    {
+        count *= 2;
+    }
+    _words.assign(count, 0);
+    _mask = count - 1;
+}
+
+#endif //CPP_EX3_BLOOMFILTER_HPP
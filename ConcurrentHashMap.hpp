@@ -0,0 +1,520 @@
+// ConcurrentHashMap.hpp
+
+#ifndef CPP_EX3_CONCURRENTHASHMAP_HPP
+#define CPP_EX3_CONCURRENTHASHMAP_HPP
+
+#define CONCURRENT_NUM_OF_STRIPES 64
+#define CONCURRENT_MIN_CAPACITY 64
+#define CONCURRENT_LOWER_LOAD_FACTOR 0.25
+#define CONCURRENT_HIGH_LOAD_FACTOR 0.75
+#define CONCURRENT_CACHE_LINE 64
+#define CONCURRENT_HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+#define CONCURRENT_HASH_SHIFT 32
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <functional>
+#include <stdexcept>
+#include "EpochReclaimer.hpp"
+
+// ------------------------------------------- class declaration -----------------------------------
+
+template <class KeyT, class ValueT>
+
+/**
+ * @brief a thread safe template Hash Map. Writers (insert, insert_or_assign, erase, clear) lock one
+ *        of CONCURRENT_NUM_OF_STRIPES stripes, picked by the hash of the key, so writers of
+ *        different keys rarely wait for each other. Readers (find, containsKey, at, forEach) take
+ *        no lock: the nodes are never changed after they are linked, a writer links a new node
+ *        instead, and unlinked nodes and tables are deleted by an EpochReclaimer only after the
+ *        readers that could see them are done. A resize locks all the stripes, builds a new table
+ *        and publishes it while the readers go on using the old one. Values are returned by copy
+ * @tparam KeyT - the template parameter that represents the key
+ * @tparam ValueT - the template parameter that represents the value
+ */
+class ConcurrentHashMap
+{
+private:
+
+    /**
+     * @brief an immutable pair in a bucket list
+     */
+    struct Node
+    {
+        const KeyT key;                // the key
+        const ValueT value;            // the value
+        const size_t hash;             // the hash of the key
+        std::atomic<Node*> next;       // the next node in the bucket
+
+        Node(const KeyT& key, const ValueT& value, size_t hash, Node* next)
+                : key(key), value(value), hash(hash), next(next)
+        {
+        }
+    };
+
+    /**
+     * @brief an array of buckets. When the table is retired by a resize it owns it's nodes (they
+     *        were copied into the new table)
+     */
+    struct Table
+    {
+        const int capacity;                           // the number of buckets, a power of 2
+        std::unique_ptr<std::atomic<Node*>[]> buckets; // the first node of each bucket
+        bool ownsNodes;                               // true if the nodes are deleted with it
+
+        explicit Table(int capacity) : capacity(capacity),
+                                       buckets(new std::atomic<Node*>[capacity]),
+                                       ownsNodes(false)
+        {
+            for (int i = 0; i < capacity; i++)
+            {
+                buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~Table()
+        {
+            if (!ownsNodes)
+            {
+                return;
+            }
+            for (int i = 0; i < capacity; i++)
+            {
+                Node* node = buckets[i].load(std::memory_order_relaxed);
+                while (node != nullptr)
+                {
+                    Node* next = node->next.load(std::memory_order_relaxed);
+                    delete node;
+                    node = next;
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief a lock of the writers, on it's own cache line
+     */
+    struct alignas(CONCURRENT_CACHE_LINE) Stripe
+    {
+        std::mutex mutex;
+    };
+
+    std::atomic<Table*> _table;                     // the current table
+    std::atomic<int> _size;                         // the number of pairs
+    Stripe _stripes[CONCURRENT_NUM_OF_STRIPES];     // the locks of the writers
+    mutable EpochReclaimer _reclaimer;              // deletes unlinked nodes and tables
+
+//-----------------------------------------private functions----------------------------------------
+
+    // Gets a key and calculates the (mixed) hash code of the key
+    static size_t _hashOf(const KeyT& key);
+
+    // returns the stripe that guards the buckets of the hash. The capacity is never smaller than
+    // the number of stripes, so every bucket belongs to a single stripe
+    std::mutex& _stripeOf(size_t hash)
+    {
+        return _stripes[hash & (CONCURRENT_NUM_OF_STRIPES - 1)].mutex;
+    }
+
+    // finds the link (a bucket or the next of a node) that points to the node of the key, in a
+    // table that the caller holds the stripe of. Points to a null link if the key doesn't exist
+    static std::atomic<Node*>* _findLink(Table* table, const KeyT& key, size_t hash);
+
+    // looks up the key without locks and calls found(node) with the node of the key (if any)
+    template <class F>
+    bool _read(const KeyT& key, F found) const;
+
+    // resizes the table if it's load factor is out of the bounds (locks all the stripes)
+    void _checkResize();
+
+    // replaces the table with a table of the given capacity, the caller holds all the stripes
+    void _resize(int newCapacity);
+
+public:
+
+    /**
+     * @brief constructor for an empty concurrent hash map
+     * @param capacity - the initial number of buckets (rounded up to a power of 2)
+     */
+    explicit ConcurrentHashMap(int capacity = CONCURRENT_MIN_CAPACITY);
+
+    /**
+     * @brief destructor, there must be no other threads that use the map
+     */
+    ~ConcurrentHashMap() noexcept;
+
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    /**
+     * @brief inserts a new pair<key, value> into the hash map
+     * @param key - the key to insert
+     * @param value - the value to insert
+     * @return true if the pair was inserted, false if the key already exists
+     */
+    bool insert(const KeyT& key, const ValueT& value);
+
+    /**
+     * @brief inserts a new pair, or replaces the value of the key if it already exists
+     * @param key - the key
+     * @param value - the value
+     * @return true if the pair was inserted, false if the value was replaced
+     */
+    bool insert_or_assign(const KeyT& key, const ValueT& value);
+
+    /**
+     * @brief erases the pair of the given key
+     * @param key - the key
+     * @return true if the pair was erased, false if the key doesn't exist
+     */
+    bool erase(const KeyT& key);
+
+    /**
+     * @brief erases all the pairs
+     */
+    void clear();
+
+    /**
+     * @brief looks up a key without taking a lock
+     * @param key - the key
+     * @param value - the value to copy the value of the key into (if it exists)
+     * @return true if the key exists, false otherwise
+     */
+    bool find(const KeyT& key, ValueT& value) const;
+
+    /**
+     * @brief checks if the key exists in the map, without taking a lock
+     * @param key - the key to check if exist
+     * @return true if the key exists, false otherwise
+     */
+    bool containsKey(const KeyT& key) const;
+
+    /**
+     * @brief gets a key, checks if the key exists in the map, if yes, returns (a copy of) it's value
+     * @param key - the key
+     * @return - the value of the key
+     * @throw std::invalid_argument if the key does not exist
+     */
+    ValueT at(const KeyT& key) const;
+
+    /**
+     * @brief calls a function with every pair of the map, without taking a lock. Pairs that are
+     *        inserted or erased during the call may or may not be visited
+     * @tparam F - a function type of void(const KeyT&, const ValueT&)
+     * @param function - the function
+     */
+    template <class F>
+    void forEach(F function) const;
+
+    /**
+     * @brief returns the number size
+     * @return - the size of the hash map (number of elements in the hash map)
+     */
+    int size() const
+    {
+        return _size.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief returns true if the hash map is empty
+     * @return true if the hash map is empty, false otherwise
+     */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief returns the number capacity
+     * @return - the capacity of the hash map
+     */
+    int capacity() const
+    {
+        EpochReclaimer::ReadGuard guard(_reclaimer);
+        return _table.load(std::memory_order_acquire)->capacity;
+    }
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+template <class KeyT, class ValueT>
+ConcurrentHashMap<KeyT, ValueT>::ConcurrentHashMap(int capacity) : _size(0)
+{
+    int actualCapacity = CONCURRENT_MIN_CAPACITY;
+    while (actualCapacity < capacity)
+    {
+        actualCapacity *= 2;
+    }
+    _table.store(new Table(actualCapacity), std::memory_order_release);
+}
+
+template <class KeyT, class ValueT>
+ConcurrentHashMap<KeyT, ValueT>::~ConcurrentHashMap() noexcept
+{
+    Table* table = _table.load(std::memory_order_relaxed);
+    table->ownsNodes = true;
+    delete table;
+}
+
+template <class KeyT, class ValueT>
+size_t ConcurrentHashMap<KeyT, ValueT>::_hashOf(const KeyT& key)
+{
+    // Mixes the hash, so both the stripe (low bits) and the bucket depend on all of it's bits
+    size_t hash = std::hash<KeyT>{}(key) * CONCURRENT_HASH_MULTIPLIER;
+    return hash ^ (hash >> CONCURRENT_HASH_SHIFT);
+}
+
+template <class KeyT, class ValueT>
+std::atomic<typename ConcurrentHashMap<KeyT, ValueT>::Node*>*
+ConcurrentHashMap<KeyT, ValueT>::_findLink(Table* table, const KeyT& key, size_t hash)
+{
+    std::atomic<Node*>* link = &table->buckets[hash & (table->capacity - 1)];
+    for (Node* node = link->load(std::memory_order_relaxed); node != nullptr;
+         node = link->load(std::memory_order_relaxed))
+    {
+        if (node->hash == hash && node->key == key)
+        {
+            break;
+        }
+        link = &node->next;
+    }
+    return link;
+}
+
+template <class KeyT, class ValueT>
+template <class F>
+bool ConcurrentHashMap<KeyT, ValueT>::_read(const KeyT& key, F found) const
+{
+    size_t hash = _hashOf(key);
+    EpochReclaimer::ReadGuard guard(_reclaimer);
+    while (true)
+    {
+        Table* table = _table.load(std::memory_order_acquire);
+        Node* node = table->buckets[hash & (table->capacity - 1)].load(std::memory_order_acquire);
+        while (node != nullptr && !(node->hash == hash && node->key == key))
+        {
+            node = node->next.load(std::memory_order_acquire);
+        }
+
+        // If a resize published a new table during the read, writes may have gone to the new
+        // table, so the read is done again there
+        if (_table.load(std::memory_order_acquire) != table)
+        {
+            continue;
+        }
+        if (node == nullptr)
+        {
+            return false;
+        }
+        found(node);
+        return true;
+    }
+}
+
+template <class KeyT, class ValueT>
+bool ConcurrentHashMap<KeyT, ValueT>::insert(const KeyT& key, const ValueT& value)
+{
+    size_t hash = _hashOf(key);
+    {
+        std::lock_guard<std::mutex> lock(_stripeOf(hash));
+        Table* table = _table.load(std::memory_order_relaxed);
+        std::atomic<Node*>* link = _findLink(table, key, hash);
+        if (link->load(std::memory_order_relaxed) != nullptr)
+        {
+            return false;
+        }
+
+        // Links the new node at the head of the bucket, readers see it complete (release)
+        std::atomic<Node*>& bucket = table->buckets[hash & (table->capacity - 1)];
+        Node* node = new Node(key, value, hash, bucket.load(std::memory_order_relaxed));
+        bucket.store(node, std::memory_order_release);
+        _size.fetch_add(1, std::memory_order_relaxed);
+    }
+    _checkResize();
+    return true;
+}
+
+template <class KeyT, class ValueT>
+bool ConcurrentHashMap<KeyT, ValueT>::insert_or_assign(const KeyT& key, const ValueT& value)
+{
+    size_t hash = _hashOf(key);
+    bool inserted = false;
+    {
+        std::lock_guard<std::mutex> lock(_stripeOf(hash));
+        Table* table = _table.load(std::memory_order_relaxed);
+        std::atomic<Node*>* link = _findLink(table, key, hash);
+        Node* old = link->load(std::memory_order_relaxed);
+        if (old != nullptr)
+        {
+            // Replaces the node with a new one, the readers of the old node still see a valid list
+            Node* node = new Node(key, value, hash, old->next.load(std::memory_order_relaxed));
+            link->store(node, std::memory_order_release);
+            _reclaimer.retire(old);
+        }
+        else
+        {
+            std::atomic<Node*>& bucket = table->buckets[hash & (table->capacity - 1)];
+            Node* node = new Node(key, value, hash, bucket.load(std::memory_order_relaxed));
+            bucket.store(node, std::memory_order_release);
+            _size.fetch_add(1, std::memory_order_relaxed);
+            inserted = true;
+        }
+    }
+    _reclaimer.collect();
+    _checkResize();
+    return inserted;
+}
+
+template <class KeyT, class ValueT>
+bool ConcurrentHashMap<KeyT, ValueT>::erase(const KeyT& key)
+{
+    size_t hash = _hashOf(key);
+    {
+        std::lock_guard<std::mutex> lock(_stripeOf(hash));
+        Table* table = _table.load(std::memory_order_relaxed);
+        std::atomic<Node*>* link = _findLink(table, key, hash);
+        Node* node = link->load(std::memory_order_relaxed);
+        if (node == nullptr)
+        {
+            return false;
+        }
+
+        // Unlinks the node, a reader that is on it can still go on to the next node
+        link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+        _reclaimer.retire(node);
+        _size.fetch_sub(1, std::memory_order_relaxed);
+    }
+    _reclaimer.collect();
+    _checkResize();
+    return true;
+}
+
+template <class KeyT, class ValueT>
+void ConcurrentHashMap<KeyT, ValueT>::clear()
+{
+    std::vector<std::unique_lock<std::mutex>> locks;
+    for (Stripe& stripe : _stripes)
+    {
+        locks.emplace_back(stripe.mutex);
+    }
+    Table* old = _table.load(std::memory_order_relaxed);
+    _table.store(new Table(CONCURRENT_MIN_CAPACITY), std::memory_order_release);
+    _size.store(0, std::memory_order_relaxed);
+    old->ownsNodes = true;
+    _reclaimer.retire(old);
+    locks.clear();
+    _reclaimer.reclaim();
+}
+
+template <class KeyT, class ValueT>
+bool ConcurrentHashMap<KeyT, ValueT>::find(const KeyT& key, ValueT& value) const
+{
+    return _read(key, [&value](const Node* node)
+    {
+        value = node->value;
+    });
+}
+
+template <class KeyT, class ValueT>
+bool ConcurrentHashMap<KeyT, ValueT>::containsKey(const KeyT& key) const
+{
+    return _read(key, [](const Node*)
+    {
+    });
+}
+
+template <class KeyT, class ValueT>
+ValueT ConcurrentHashMap<KeyT, ValueT>::at(const KeyT& key) const
+{
+    ValueT value;
+    if (!find(key, value))
+    {
+        throw std::invalid_argument("The key does not exist");
+    }
+    return value;
+}
+
+template <class KeyT, class ValueT>
+template <class F>
+void ConcurrentHashMap<KeyT, ValueT>::forEach(F function) const
+{
+    EpochReclaimer::ReadGuard guard(_reclaimer);
+    Table* table = _table.load(std::memory_order_acquire);
+    for (int i = 0; i < table->capacity; i++)
+    {
+        for (Node* node = table->buckets[i].load(std::memory_order_acquire); node != nullptr;
+             node = node->next.load(std::memory_order_acquire))
+        {
+            function(node->key, node->value);
+        }
+    }
+}
+
+template <class KeyT, class ValueT>
+void ConcurrentHashMap<KeyT, ValueT>::_checkResize()
+{
+    // Checks the load factor without the locks first, the table is read like a reader would
+    int capacity = this->capacity();
+    int size = _size.load(std::memory_order_relaxed);
+    if (size <= capacity * CONCURRENT_HIGH_LOAD_FACTOR &&
+        (capacity <= CONCURRENT_MIN_CAPACITY || size >= capacity * CONCURRENT_LOWER_LOAD_FACTOR))
+    {
+        return;
+    }
+
+    // Locks all the stripes (always in the same order), and checks again, another writer may
+    // have resized the table already
+    {
+        std::vector<std::unique_lock<std::mutex>> locks;
+        for (Stripe& stripe : _stripes)
+        {
+            locks.emplace_back(stripe.mutex);
+        }
+        Table* table = _table.load(std::memory_order_relaxed);
+        size = _size.load(std::memory_order_relaxed);
+        if (size > table->capacity * CONCURRENT_HIGH_LOAD_FACTOR)
+        {
+            _resize(table->capacity * 2);
+        }
+        else if (table->capacity > CONCURRENT_MIN_CAPACITY &&
+                 size < table->capacity * CONCURRENT_LOWER_LOAD_FACTOR)
+        {
+            _resize(table->capacity / 2);
+        }
+        else
+        {
+            return;
+        }
+    }
+    _reclaimer.reclaim();
+}
+
+template <class KeyT, class ValueT>
+void ConcurrentHashMap<KeyT, ValueT>::_resize(int newCapacity)
+{
+    // Copies the nodes into the new table, the nodes of the old table are not changed because
+    // readers may still go over them
+    Table* old = _table.load(std::memory_order_relaxed);
+    Table* table = new Table(newCapacity);
+    for (int i = 0; i < old->capacity; i++)
+    {
+        for (Node* node = old->buckets[i].load(std::memory_order_relaxed); node != nullptr;
+             node = node->next.load(std::memory_order_relaxed))
+        {
+            std::atomic<Node*>& bucket = table->buckets[node->hash & (newCapacity - 1)];
+            bucket.store(new Node(node->key, node->value, node->hash,
+                                  bucket.load(std::memory_order_relaxed)),
+                         std::memory_order_relaxed);
+        }
+    }
+    _table.store(table, std::memory_order_release);
+    old->ownsNodes = true;
+    _reclaimer.retire(old);
+}
+
+#endif //CPP_EX3_CONCURRENTHASHMAP_HPP
@@ -0,0 +1,305 @@
+/**
+* @file    ConcurrentHashMapTest.cpp
+* @author  user
+* @version 1.0
+* @brief   Tests for ConcurrentHashMap and EpochReclaimer
+* @section runs a seeded random sequence of insert, insert_or_assign, erase, find, at and clear on
+*          a ConcurrentHashMap and on a std::unordered_map (the reference) on one thread and
+*          compares them. Then runs STRESS_READERS reader threads (find, containsKey and forEach)
+*          against STRESS_WRITERS writer threads (insert, insert_or_assign, erase and clear, so the
+*          map grows and shrinks under the readers). Every value encodes it's key, a reader that
+*          sees a value of another key or a deleted node fails. Last, readers load objects that
+*          writers replace and retire through an EpochReclaimer directly. Build it with the thread
+*          sanitizer (and once with the address sanitizer) to check the races and the reclamation.
+*          Build: g++ -std=c++17 -O1 -g -pthread -fsanitize=thread ConcurrentHashMapTest.cpp
+*                 -o ConcurrentHashMapTest
+*                 g++ -std=c++17 -O1 -g -pthread -fsanitize=address,undefined
+*                 ConcurrentHashMapTest.cpp -o ConcurrentHashMapTest
+*          Usage: ConcurrentHashMapTest, exits with EXIT_FAILURE on the first failed check. A
+*          resize holds all the stripe locks, more than the deadlock detector of the thread
+*          sanitizer tracks, so run the thread sanitizer build with
+*          TSAN_OPTIONS=detect_deadlocks=0
+*/
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <random>
+#include "ConcurrentHashMap.hpp"
+#include "TestCheck.hpp"
+
+#define TEST_SEED 1
+#define RANDOM_STEPS 200000
+#define RANDOM_KEYS 3000
+#define CLEAR_EVERY 50000
+#define STRESS_READERS 3
+#define STRESS_WRITERS 2
+#define STRESS_WRITES 150000
+#define STRESS_KEYS 20000
+#define STRESS_INITIAL_KEYS 1000
+#define STRESS_CLEAR_EVERY 40000
+#define VALUE_VERSIONS 5
+#define FOR_EACH_EVERY 512
+#define RECLAIMER_WRITES 20000
+#define RECLAIMED_MAGIC 0x5A5A5A5A
+#define LIVE_MAGIC 0x11111111
+
+// ------------------------------------------- functions -------------------------------------------
+
+/**
+ * @brief the value a stress writer stores for a key, a reader can tell the key back from it
+ * @param key - the key
+ * @param version - the version of the value, in [0, VALUE_VERSIONS)
+ * @return the value
+ */
+static long valueOf(int key, int version)
+{
+    return (long)key * VALUE_VERSIONS + version;
+}
+
+/**
+ * @brief checks that a value was stored for the given key
+ * @param key - the key
+ * @param value - the value
+ * @return true if the value belongs to the key
+ */
+static bool belongsTo(int key, long value)
+{
+    return value / VALUE_VERSIONS == key;
+}
+
+/**
+ * @brief compares random operations on a ConcurrentHashMap with a std::unordered_map
+ */
+static void testRandomOperations()
+{
+    std::mt19937 random(TEST_SEED);
+    ConcurrentHashMap<int, long> map;
+    std::unordered_map<int, long> reference;
+    for (int step = 0; step < RANDOM_STEPS; step++)
+    {
+        int key = (int)(random() % RANDOM_KEYS);
+        long value = (long)random();
+        int operation = (int)(random() % 4);
+        if (operation == 0)
+        {
+            TEST_CHECK(map.insert(key, value) == reference.emplace(key, value).second);
+        }
+        else if (operation == 1)
+        {
+            TEST_CHECK(map.insert_or_assign(key, value) ==
+                       reference.insert_or_assign(key, value).second);
+        }
+        else if (operation == 2)
+        {
+            TEST_CHECK(map.erase(key) == (reference.erase(key) > 0));
+        }
+        else
+        {
+            long found = 0;
+            auto expected = reference.find(key);
+            TEST_CHECK(map.find(key, found) == (expected != reference.end()));
+            TEST_CHECK(expected == reference.end() || found == expected->second);
+            TEST_CHECK(map.containsKey(key) == (expected != reference.end()));
+        }
+        TEST_CHECK(map.size() == (int)reference.size());
+
+        if (step % CLEAR_EVERY == CLEAR_EVERY - 1)
+        {
+            map.clear();
+            reference.clear();
+            TEST_CHECK(map.empty());
+        }
+    }
+
+    int count = 0;
+    map.forEach([&reference, &count](const int& key, const long& value)
+    {
+        auto expected = reference.find(key);
+        TEST_CHECK(expected != reference.end() && expected->second == value);
+        count++;
+    });
+    TEST_CHECK(count == (int)reference.size());
+
+    ConcurrentHashMap<std::string, int> strings;
+    strings.insert("a", 1);
+    TEST_CHECK(strings.at("a") == 1);
+    TEST_THROWS(strings.at("b"), std::invalid_argument);
+}
+
+/**
+ * @brief runs reader threads against writer threads on one map, the readers check every value
+ *        they see
+ */
+static void testReadersAndWriters()
+{
+    ConcurrentHashMap<int, long> map;
+    for (int key = 0; key < STRESS_INITIAL_KEYS; key++)
+    {
+        map.insert(key, valueOf(key, 0));
+    }
+
+    std::atomic<int> writersLeft(STRESS_WRITERS);
+    std::atomic<bool> failed(false);
+    std::atomic<long> hits(0);
+    std::vector<std::thread> threads;
+    for (int r = 0; r < STRESS_READERS; r++)
+    {
+        threads.emplace_back([&map, &writersLeft, &failed, &hits, r]
+        {
+            std::mt19937 random(TEST_SEED + r);
+            long found = 0;
+            for (long read = 0; writersLeft.load() > 0; read++)
+            {
+                int key = (int)(random() % STRESS_KEYS);
+                long value = 0;
+                if (map.find(key, value))
+                {
+                    found++;
+                    if (!belongsTo(key, value))
+                    {
+                        failed = true;
+                    }
+                }
+                map.containsKey(key);
+                if (read % FOR_EACH_EVERY == 0)
+                {
+                    map.forEach([&failed](const int& key, const long& value)
+                    {
+                        if (!belongsTo(key, value))
+                        {
+                            failed = true;
+                        }
+                    });
+                }
+            }
+            hits += found;
+        });
+    }
+    for (int w = 0; w < STRESS_WRITERS; w++)
+    {
+        threads.emplace_back([&map, &writersLeft, w]
+        {
+            std::mt19937 random(TEST_SEED + STRESS_READERS + w);
+            for (int write = 0; write < STRESS_WRITES; write++)
+            {
+                int key = (int)(random() % STRESS_KEYS);
+                int operation = (int)(random() % 3);
+                if (operation == 0)
+                {
+                    map.insert(key, valueOf(key, 0));
+                }
+                else if (operation == 1)
+                {
+                    map.insert_or_assign(key, valueOf(key, (int)(random() % VALUE_VERSIONS)));
+                }
+                else
+                {
+                    map.erase(key);
+                }
+                if (w == 0 && write % STRESS_CLEAR_EVERY == STRESS_CLEAR_EVERY - 1)
+                {
+                    map.clear();
+                }
+            }
+            writersLeft--;
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    TEST_CHECK(!failed.load());
+    TEST_CHECK(hits.load() > 0);
+
+    // The size that the writers counted matches the pairs that are left
+    int count = 0;
+    map.forEach([&count](const int& key, const long& value)
+    {
+        TEST_CHECK(belongsTo(key, value));
+        count++;
+    });
+    TEST_CHECK(count == map.size());
+}
+
+/**
+ * @brief an object that is replaced by writers and read by readers
+ */
+struct Guarded
+{
+    std::atomic<int> magic;
+
+    Guarded() : magic(LIVE_MAGIC)
+    {
+    }
+
+    ~Guarded()
+    {
+        magic.store(RECLAIMED_MAGIC, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief runs readers that load an object while writers replace it and retire the old one, no
+ *        reader may see an object that was deleted
+ */
+static void testReclaimer()
+{
+    EpochReclaimer reclaimer;
+    std::atomic<Guarded*> current(new Guarded());
+    std::atomic<int> writersLeft(STRESS_WRITERS);
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> threads;
+    for (int r = 0; r < STRESS_READERS; r++)
+    {
+        threads.emplace_back([&reclaimer, &current, &writersLeft, &failed]
+        {
+            while (writersLeft.load() > 0)
+            {
+                EpochReclaimer::ReadGuard guard(reclaimer);
+                Guarded* object = current.load(std::memory_order_acquire);
+                if (object->magic.load(std::memory_order_relaxed) != LIVE_MAGIC)
+                {
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (int w = 0; w < STRESS_WRITERS; w++)
+    {
+        threads.emplace_back([&reclaimer, &current, &writersLeft]
+        {
+            for (int write = 0; write < RECLAIMER_WRITES; write++)
+            {
+                Guarded* old = current.exchange(new Guarded(), std::memory_order_acq_rel);
+                reclaimer.retire(old);
+                reclaimer.collect();
+            }
+            writersLeft--;
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    TEST_CHECK(!failed.load());
+    reclaimer.reclaim();
+    delete current.load();
+}
+
+/**
+ * @brief runs the tests of ConcurrentHashMap and EpochReclaimer
+ * @return EXIT_SUCCESS if all the checks passed
+ */
+int main()
+{
+    testRandomOperations();
+    testReadersAndWriters();
+    testReclaimer();
+    std::cout << "ConcurrentHashMapTest: all checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
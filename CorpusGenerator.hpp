@@ -0,0 +1,207 @@
+// CorpusGenerator.hpp
+
+#ifndef CPP_EX3_CORPUSGENERATOR_HPP
+#define CPP_EX3_CORPUSGENERATOR_HPP
+
+#define CORPUS_MIN_WORD_LENGTH 2
+#define CORPUS_MAX_WORD_LENGTH 9
+#define CORPUS_LINE_LENGTH 72
+#define CORPUS_MAX_SCORE 9
+#define CORPUS_KILOBYTE 1024.0
+#define CORPUS_UPPER_CASE_OFFSET 32
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <fstream>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+// ------------------------------------------- class declaration -----------------------------------
+
+/**
+ * @brief a deterministic generator of synthetic phrase databases and emails for the benchmarks.
+ *        Everything is derived from the seed with a splitmix64 sequence and plain integer
+ *        arithmetic (no std:: distributions, their results differ between standard libraries), so
+ *        the same seed gives byte for byte the same files on every machine
+ */
+class CorpusGenerator
+{
+public:
+
+    /**
+     * @brief creates a generator
+     * @param seed - the seed of the sequence
+     */
+    explicit CorpusGenerator(uint64_t seed) : _state(seed)
+    {
+    }
+
+    /**
+     * @brief generates distinct lower case phrases of random words
+     * @param count - the number of phrases
+     * @param minLength - the shortest phrase length
+     * @param maxLength - the longest phrase length
+     * @return the phrases
+     */
+    std::vector<std::string> phrases(int count, size_t minLength, size_t maxLength);
+
+    /**
+     * @brief generates the text of an email: lines of random words, with phrases of the database
+     *        (the first letter in upper case half of the time) spread over it
+     * @param size - the size of the email in bytes
+     * @param hitsPerKilobyte - the average number of phrases in a kilobyte of the email
+     * @param phrases - the phrases to spread over the email
+     * @return the text of the email
+     */
+    std::string email(size_t size, double hitsPerKilobyte, const std::vector<std::string>& phrases);
+
+    /**
+     * @brief writes a database file: a line "<phrase>,<score>" for each phrase, with a random
+     *        score from 0 to CORPUS_MAX_SCORE
+     * @param filePath - the path of the file
+     * @param phrases - the phrases
+     * @throw std::runtime_error if the file can't be written
+     */
+    void writeDatabase(const std::string& filePath, const std::vector<std::string>& phrases);
+
+    /**
+     * @brief writes a text into a file, as it is
+     * @param filePath - the path of the file
+     * @param text - the text
+     * @throw std::runtime_error if the file can't be written
+     */
+    static void writeText(const std::string& filePath, const std::string& text);
+
+private:
+    uint64_t _state; // the state of the splitmix64 sequence
+
+    // returns the next number of the sequence
+    uint64_t _next();
+
+    // returns a number in [0, bound)
+    uint64_t _below(uint64_t bound)
+    {
+        return _next() % bound;
+    }
+
+    // appends a random lower case word
+    void _appendWord(std::string& text);
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+inline uint64_t CorpusGenerator::_next()
+{
+    uint64_t z = (_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+inline void CorpusGenerator::_appendWord(std::string& text)
+{
+    size_t length = CORPUS_MIN_WORD_LENGTH +
+                    _below(CORPUS_MAX_WORD_LENGTH - CORPUS_MIN_WORD_LENGTH + 1);
+    for (size_t i = 0; i < length; i++)
+    {
+        text.push_back((char)('a' + _below(26)));
+    }
+}
+
+inline std::vector<std::string> CorpusGenerator::phrases(int count, size_t minLength,
+                                                         size_t maxLength)
+{
+    std::vector<std::string> result;
+    std::unordered_set<std::string> seen;
+    result.reserve(count);
+    while ((int)result.size() < count)
+    {
+        // Joins words until the length is reached, and cuts the last word at the length
+        size_t length = minLength + _below(maxLength - minLength + 1);
+        std::string phrase;
+        while (phrase.size() < length)
+        {
+            if (!phrase.empty())
+            {
+                phrase.push_back(' ');
+            }
+            _appendWord(phrase);
+        }
+        phrase.resize(length);
+        if (phrase.back() == ' ')
+        {
+            phrase.back() = 'a';
+        }
+        if (seen.insert(phrase).second)
+        {
+            result.push_back(std::move(phrase));
+        }
+    }
+    return result;
+}
+
+inline std::string CorpusGenerator::email(size_t size, double hitsPerKilobyte,
+                                          const std::vector<std::string>& phrases)
+{
+    std::string text;
+    text.reserve(size + CORPUS_LINE_LENGTH);
+
+    // The gaps between the phrases are uniform around the average gap
+    bool hasHits = hitsPerKilobyte > 0 && !phrases.empty();
+    uint64_t averageGap = hasHits ? (uint64_t)(CORPUS_KILOBYTE / hitsPerKilobyte) + 1 : 0;
+    size_t nextHit = hasHits ? averageGap / 2 + _below(averageGap) : size;
+    size_t lineStart = 0;
+    while (text.size() < size)
+    {
+        if (!text.empty())
+        {
+            bool newLine = text.size() - lineStart >= CORPUS_LINE_LENGTH;
+            text.push_back(newLine ? '\n' : ' ');
+            lineStart = newLine ? text.size() : lineStart;
+        }
+        if (text.size() < nextHit)
+        {
+            _appendWord(text);
+            continue;
+        }
+
+        size_t start = text.size();
+        text += phrases[_below(phrases.size())];
+        if (_below(2) == 0 && text[start] >= 'a' && text[start] <= 'z')
+        {
+            text[start] = (char)(text[start] - CORPUS_UPPER_CASE_OFFSET);
+        }
+        nextHit = text.size() + averageGap / 2 + _below(averageGap);
+    }
+    text.resize(size);
+    return text;
+}
+
+inline void CorpusGenerator::writeDatabase(const std::string& filePath,
+                                           const std::vector<std::string>& phrases)
+{
+    std::string text;
+    for (const std::string& phrase : phrases)
+    {
+        text += phrase;
+        text += ',';
+        text += std::to_string(_below(CORPUS_MAX_SCORE + 1));
+        text += '\n';
+    }
+    writeText(filePath, text);
+}
+
+inline void CorpusGenerator::writeText(const std::string& filePath, const std::string& text)
+{
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.write(text.data(), (std::streamsize)text.size()))
+    {
+        throw std::runtime_error("Can't write " + filePath);
+    }
+}
+
+#endif //CPP_EX3_CORPUSGENERATOR_HPP
@@ -0,0 +1,280 @@
+/**
+* @file    DatabaseLoaderTest.cpp
+* @author  user
+* @version 1.0
+* @brief   Tests for the database loader of SpamDetector (readDataBaseFile and
+*          parseDataBaseLines)
+* @section writes random database files (with repeated sentences, sentences in other cases,
+*          scores with leading zeros and scores above INT_MAX, with and without a last line
+*          separator) and compares the map that readDataBaseFile loads with a reference that
+*          parses the file one line at a time (the last score of a sentence is kept, a score
+*          above INT_MAX is INT_MAX). Then breaks one random line of a valid file in every way the
+*          format forbids and checks that the load fails, and parses a large file in pieces split
+*          at random line separators and checks that the pieces give the lines of the whole file.
+*          The files are written into a temporary directory that is removed at the end.
+*          Build: g++ -std=c++17 -O1 -g -pthread -fsanitize=address,undefined
+*                 DatabaseLoaderTest.cpp -o DatabaseLoaderTest -lboost_filesystem
+*          Usage: DatabaseLoaderTest, exits with EXIT_FAILURE on the first failed check
+*/
+
+// -------------------------------------- includes -------------------------------------------------
+
+// The functions of the program, without it's main
+#define SPAM_DETECTOR_NO_MAIN
+#include "SpamDetector.cpp"
+#include "TestCheck.hpp"
+#include <unordered_map>
+#include <random>
+
+#define TEST_SEED 5
+#define NUM_OF_FILES 40
+#define MAX_LINES 3000
+#define SENTENCE_CHARS "abcABC !?"
+#define NUM_OF_SENTENCE_CHARS 9
+#define MAX_SENTENCE_LENGTH 6
+#define MAX_SCORE_DIGITS 12
+#define NUM_OF_BROKEN_FILES 200
+#define BROKEN_FILE_LINES 50
+#define LARGE_FILE_LINES 400000
+#define NUM_OF_SPLITS 20
+
+// ------------------------------------------- functions -------------------------------------------
+
+/**
+ * @brief parses the lines of a valid database the simple way, one line at a time
+ * @param content - the content of the database file
+ * @return the sentences and their scores
+ */
+static std::unordered_map<std::string, int> referenceParse(const std::string& content)
+{
+    std::unordered_map<std::string, int> result;
+    std::istringstream lines(content);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        size_t comma = line.find(',');
+        std::string digits = line.substr(comma + 1);
+        size_t firstDigit = std::min(digits.find_first_not_of('0'), digits.size());
+        digits = digits.substr(firstDigit);
+        std::string maxDigits = std::to_string(INT_MAX);
+        bool fits = digits.size() < maxDigits.size() ||
+                    (digits.size() == maxDigits.size() && digits <= maxDigits);
+        result[line.substr(0, comma)] = fits ? (digits.empty() ? 0 : std::stoi(digits)) : INT_MAX;
+    }
+    return result;
+}
+
+/**
+ * @brief makes a random valid line of a database (without the line separator)
+ * @param random - the random generator
+ * @return the line
+ */
+static std::string randomLine(std::mt19937& random)
+{
+    std::string line;
+    int length = 1 + (int)(random() % MAX_SENTENCE_LENGTH);
+    for (int i = 0; i < length; i++)
+    {
+        line += SENTENCE_CHARS[random() % NUM_OF_SENTENCE_CHARS];
+    }
+    line += ',';
+    int digits = 1 + (int)(random() % MAX_SCORE_DIGITS);
+    for (int i = 0; i < digits; i++)
+    {
+        line += (char)('0' + random() % 10);
+    }
+    return line;
+}
+
+/**
+ * @brief makes the content of a random valid database
+ * @param random - the random generator
+ * @param numOfLines - the number of lines
+ * @return the content
+ */
+static std::vector<std::string> randomLines(std::mt19937& random, int numOfLines)
+{
+    std::vector<std::string> lines;
+    for (int i = 0; i < numOfLines; i++)
+    {
+        lines.push_back(randomLine(random));
+    }
+    return lines;
+}
+
+/**
+ * @brief joins lines into the content of a file
+ * @param lines - the lines
+ * @param lastSeparator - true to end the last line with a line separator
+ * @return the content
+ */
+static std::string joinLines(const std::vector<std::string>& lines, bool lastSeparator)
+{
+    std::string content;
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        content += lines[i];
+        if (i + 1 < lines.size() || lastSeparator)
+        {
+            content += LINE_SEPARATOR;
+        }
+    }
+    return content;
+}
+
+/**
+ * @brief writes a file
+ * @param filePath - the path of the file
+ * @param content - the content
+ */
+static void writeFile(const std::string& filePath, const std::string& content)
+{
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    file << content;
+    TEST_CHECK(file.good());
+}
+
+/**
+ * @brief loads a database file with readDataBaseFile
+ * @param filePath - the path of the file
+ * @param table - the table to load the database into
+ * @return true if the file was loaded, false if it was rejected
+ */
+static bool load(std::string filePath, PhraseTable& table)
+{
+    try
+    {
+        readDataBaseFile(filePath, table);
+        return true;
+    }
+    catch (std::exception& e)
+    {
+        return false;
+    }
+}
+
+/**
+ * @brief loads random valid databases and compares them with the reference
+ * @param directory - the directory to write the files into
+ */
+static void testValidFiles(const std::string& directory)
+{
+    std::mt19937 random(TEST_SEED);
+    std::string filePath = directory + "/valid.txt";
+    for (int i = 0; i < NUM_OF_FILES; i++)
+    {
+        std::vector<std::string> lines = randomLines(random, (int)(random() % MAX_LINES));
+        lines.push_back("sentence,2147483647");
+        lines.push_back("Sentence,2147483648");
+        lines.push_back("long score,99999999999999999999999");
+        lines.push_back("zeros,000000000000000000000042");
+        std::shuffle(lines.begin(), lines.end(), random);
+        std::string content = joinLines(lines, random() % 2 == 0);
+        writeFile(filePath, content);
+
+        PhraseTable table;
+        TEST_CHECK(load(filePath, table));
+        std::unordered_map<std::string, int> expected = referenceParse(content);
+        TEST_CHECK(table.size() == (int)expected.size());
+        for (const auto& item : expected)
+        {
+            TEST_CHECK(table.containsKey(item.first) && table.at(item.first) == item.second);
+        }
+        TEST_CHECK(table.at("sentence") == INT_MAX && table.at("Sentence") == INT_MAX);
+        TEST_CHECK(table.at("long score") == INT_MAX && table.at("zeros") == 42);
+    }
+
+    PhraseTable table;
+    writeFile(filePath, "");
+    TEST_CHECK(load(filePath, table) && table.empty());
+    TEST_CHECK(!load(directory + "/missing.txt", table));
+}
+
+/**
+ * @brief breaks one line of valid databases and checks that they are rejected
+ * @param directory - the directory to write the files into
+ */
+static void testInvalidFiles(const std::string& directory)
+{
+    const std::vector<std::string> brokenLines{"no comma", "two,commas,1", ",1", "sentence,",
+                                               "sentence,-1", "sentence,1a", "sentence,1\r",
+                                               "sentence, 1", "", ","};
+    std::mt19937 random(TEST_SEED);
+    std::string filePath = directory + "/invalid.txt";
+    for (int i = 0; i < NUM_OF_BROKEN_FILES; i++)
+    {
+        std::vector<std::string> lines = randomLines(random, BROKEN_FILE_LINES);
+        const std::string& broken = brokenLines[i % brokenLines.size()];
+        size_t index = random() % lines.size();
+        // An empty last line is the end of the file, so it is broken in the middle only
+        index = broken.empty() ? index % (lines.size() - 1) : index;
+        lines[index] = broken;
+        writeFile(filePath, joinLines(lines, random() % 2 == 0));
+
+        PhraseTable table;
+        TEST_CHECK(!load(filePath, table));
+    }
+}
+
+/**
+ * @brief parses a large database in pieces split at random line separators, the pieces must give
+ *        the lines of the whole database in order, and loads it
+ * @param directory - the directory to write the file into
+ */
+static void testPieces(const std::string& directory)
+{
+    std::mt19937 random(TEST_SEED);
+    std::string content = joinLines(randomLines(random, LARGE_FILE_LINES), true);
+    std::vector<std::string_view> wholeKeys;
+    std::vector<int> wholeValues;
+    const char* begin = content.data();
+    const char* end = begin + content.size();
+    TEST_CHECK(parseDataBaseLines(begin, end, wholeKeys, wholeValues));
+    TEST_CHECK(wholeKeys.size() == LARGE_FILE_LINES);
+
+    for (int split = 0; split < NUM_OF_SPLITS; split++)
+    {
+        std::vector<std::string_view> keys;
+        std::vector<int> values;
+        const char* piece = begin;
+        while (piece < end)
+        {
+            const char* from = std::min(end, piece + random() % (content.size() / 4 + 1));
+            const char* separator = static_cast<const char*>(std::memchr(from, LINE_SEPARATOR,
+                                                                         end - from));
+            const char* pieceEnd = (separator != nullptr) ? separator + 1 : end;
+            TEST_CHECK(parseDataBaseLines(piece, pieceEnd, keys, values));
+            piece = pieceEnd;
+        }
+        TEST_CHECK(keys == wholeKeys && values == wholeValues);
+    }
+
+    std::string filePath = directory + "/large.txt";
+    writeFile(filePath, content);
+    PhraseTable table;
+    TEST_CHECK(load(filePath, table));
+    std::unordered_map<std::string, int> expected = referenceParse(content);
+    TEST_CHECK(table.size() == (int)expected.size());
+    for (const auto& item : expected)
+    {
+        TEST_CHECK(table.at(item.first) == item.second);
+    }
+}
+
+/**
+ * @brief runs the tests of the database loader
+ * @return EXIT_SUCCESS if all the checks passed
+ */
+int main()
+{
+    std::string directory = (boost::filesystem::temp_directory_path() /
+                             boost::filesystem::unique_path("DatabaseLoaderTest-%%%%-%%%%"))
+                                    .string();
+    boost::filesystem::create_directories(directory);
+    testValidFiles(directory);
+    testInvalidFiles(directory);
+    testPieces(directory);
+    boost::filesystem::remove_all(directory);
+    std::cout << "DatabaseLoaderTest: all checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
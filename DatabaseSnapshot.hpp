@@ -0,0 +1,372 @@
+// DatabaseSnapshot.hpp
+
+#ifndef CPP_EX3_DATABASESNAPSHOT_HPP
+#define CPP_EX3_DATABASESNAPSHOT_HPP
+
+#define SNAPSHOT_MAGIC "SPAMSNAP"
+#define SNAPSHOT_MAGIC_SIZE 8
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ALIGNMENT 8
+#define SNAPSHOT_NUM_OF_SECTIONS 10
+#define SNAPSHOT_CHECKSUM_SEED 0x27D4EB2F165667C5ULL
+#define SNAPSHOT_CHECKSUM_PRIME 0x9E3779B97F4A7C15ULL
+#define SNAPSHOT_CHECKSUM_SHIFT 29
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "AhoCorasick.hpp"
+#include "MappedFile.hpp"
+
+// ------------------------------------------- declarations ----------------------------------------
+
+/**
+ * @brief the header of a compiled database snapshot. A snapshot is the header followed by the
+ *        payload: the arrays of the AhoCorasick tables, in the order of SnapshotSection, each one
+ *        aligned to SNAPSHOT_ALIGNMENT bytes. The numbers are saved in the byte order of the
+ *        machine that compiled the snapshot
+ */
+struct SnapshotHeader
+{
+    char magic[SNAPSHOT_MAGIC_SIZE]; // SNAPSHOT_MAGIC
+    uint32_t version;                // SNAPSHOT_VERSION
+    uint32_t headerSize;             // sizeof(SnapshotHeader)
+    uint64_t payloadSize;            // the number of bytes after the header
+    uint64_t checksum;               // snapshotChecksum of the payload
+    int32_t classCount;              // AhoCorasick::Tables::classCount
+    int32_t stateCount;              // AhoCorasick::Tables::stateCount
+    int32_t patternCount;            // AhoCorasick::Tables::patternCount
+    int32_t patternBytesSize;        // AhoCorasick::Tables::patternBytesSize
+    uint8_t reserved[16];            // zeros
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "the snapshot header must be 64 bytes");
+static_assert(sizeof(int) == sizeof(int32_t), "the snapshot tables are arrays of 32 bit ints");
+
+/**
+ * @brief the sections of the payload of a snapshot, in the order they are saved
+ */
+enum SnapshotSection
+{
+    BYTE_CLASS_SECTION,
+    DELTA_SECTION,
+    OUT_SCORE_SECTION,
+    OUT_LINK_SECTION,
+    OUT_BEGIN_SECTION,
+    OUT_IDS_SECTION,
+    PATTERN_SCORES_SECTION,
+    PATTERN_OFFSETS_SECTION,
+    PATTERN_BYTES_SECTION,
+    END_SECTION
+};
+
+/**
+ * @brief calculates the checksum of a buffer (a fast 64 bit multiply-xor hash, for detecting
+ *        damaged or truncated files, not for security)
+ * @param data - the buffer
+ * @param size - the size of the buffer
+ * @return the checksum
+ */
+inline uint64_t snapshotChecksum(const char* data, size_t size)
+{
+    uint64_t hash = SNAPSHOT_CHECKSUM_SEED ^ size;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * SNAPSHOT_CHECKSUM_PRIME;
+        hash ^= hash >> SNAPSHOT_CHECKSUM_SHIFT;
+    }
+    for (; i < size; i++)
+    {
+        hash = (hash ^ (unsigned char)data[i]) * SNAPSHOT_CHECKSUM_PRIME;
+        hash ^= hash >> SNAPSHOT_CHECKSUM_SHIFT;
+    }
+    return hash;
+}
+
+/**
+ * @brief calculates where each section starts in the payload of a snapshot
+ * @param header - the header with the sizes of the tables
+ * @param offsets - the array to save the offsets into (the last one is the size of the payload)
+ */
+inline void snapshotLayout(const SnapshotHeader& header, uint64_t offsets[SNAPSHOT_NUM_OF_SECTIONS])
+{
+    uint64_t sizes[END_SECTION];
+    sizes[BYTE_CLASS_SECTION]      = (uint64_t)ALPHABET_SIZE * sizeof(int32_t);
+    sizes[DELTA_SECTION]           = (uint64_t)header.stateCount * header.classCount
+                                     * sizeof(int32_t);
+    sizes[OUT_SCORE_SECTION]       = (uint64_t)header.stateCount * sizeof(int32_t);
+    sizes[OUT_LINK_SECTION]        = (uint64_t)header.stateCount * sizeof(int32_t);
+    sizes[OUT_BEGIN_SECTION]       = ((uint64_t)header.stateCount + 1) * sizeof(int32_t);
+    sizes[OUT_IDS_SECTION]         = (uint64_t)header.patternCount * sizeof(int32_t);
+    sizes[PATTERN_SCORES_SECTION]  = (uint64_t)header.patternCount * sizeof(int32_t);
+    sizes[PATTERN_OFFSETS_SECTION] = ((uint64_t)header.patternCount + 1) * sizeof(int32_t);
+    sizes[PATTERN_BYTES_SECTION]   = (uint64_t)header.patternBytesSize;
+
+    uint64_t offset = 0;
+    for (int i = 0; i < END_SECTION; i++)
+    {
+        offsets[i] = offset;
+        offset += (sizes[i] + SNAPSHOT_ALIGNMENT - 1) / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT;
+    }
+    offsets[END_SECTION] = offset;
+}
+
+/**
+ * @brief checks that every index in the tables of a snapshot is in the range of the table it
+ *        indexes, so a damaged or crafted snapshot (with a valid checksum) can't make a scan read
+ *        outside the tables. Every phrase must be non-empty (like in a database file), and the
+ *        score of every state must be the sum of the scores of the phrases on it's output chain,
+ *        so the scores of a scan match the phrases that are reported. A single pass over the
+ *        tables
+ * @param tables - the tables, with their sizes
+ * @throw std::runtime_error if an index is out of it's range, a phrase is empty or a score of a
+ *        state doesn't match it's phrases
+ */
+inline void validateSnapshotTables(const AhoCorasick::Tables& tables)
+{
+    for (int i = 0; i < ALPHABET_SIZE; i++)
+    {
+        if (tables.byteClass[i] < 0 || tables.byteClass[i] >= tables.classCount)
+        {
+            throw std::runtime_error("Invalid byte class in snapshot");
+        }
+    }
+    uint64_t deltaSize = (uint64_t)tables.stateCount * tables.classCount;
+    for (uint64_t i = 0; i < deltaSize; i++)
+    {
+        if (tables.delta[i] < 0 || tables.delta[i] >= tables.stateCount)
+        {
+            throw std::runtime_error("Invalid transition in snapshot");
+        }
+    }
+
+    // The output links must end (in NO_STATE) without a cycle, every state is walked once: a
+    // chain stops at a state that is already known to end
+    std::vector<char> linkEnds(tables.stateCount, 0);
+    std::vector<int> chain;
+    for (int state = 0; state < tables.stateCount; state++)
+    {
+        chain.clear();
+        int curr = state;
+        while (curr != NO_STATE)
+        {
+            if (curr < 0 || curr >= tables.stateCount || chain.size() >= (size_t)tables.stateCount)
+            {
+                throw std::runtime_error("Invalid output link in snapshot");
+            }
+            if (linkEnds[curr])
+            {
+                break;
+            }
+            chain.push_back(curr);
+            curr = tables.outLink[curr];
+        }
+        for (int linked : chain)
+        {
+            linkEnds[linked] = 1;
+        }
+    }
+
+    if (tables.outBegin[0] < 0 || tables.outBegin[tables.stateCount] > tables.patternCount)
+    {
+        throw std::runtime_error("Invalid outputs in snapshot");
+    }
+    for (int state = 0; state < tables.stateCount; state++)
+    {
+        if (tables.outBegin[state] > tables.outBegin[state + 1])
+        {
+            throw std::runtime_error("Invalid outputs in snapshot");
+        }
+    }
+    for (int i = 0; i < tables.patternCount; i++)
+    {
+        if (tables.outIds[i] < 0 || tables.outIds[i] >= tables.patternCount)
+        {
+            throw std::runtime_error("Invalid output id in snapshot");
+        }
+    }
+
+    if (tables.patternOffsets[0] < 0 ||
+        tables.patternOffsets[tables.patternCount] > tables.patternBytesSize)
+    {
+        throw std::runtime_error("Invalid phrase offsets in snapshot");
+    }
+    for (int id = 0; id < tables.patternCount; id++)
+    {
+        if (tables.patternOffsets[id] >= tables.patternOffsets[id + 1])
+        {
+            throw std::runtime_error("Invalid phrase offsets in snapshot");
+        }
+    }
+
+    // The score of a state is the scores of the phrases that end in it and the score of it's
+    // output link (that already sums the rest of the chain). The sums wrap around like the sums of
+    // the automaton builder
+    for (int state = 0; state < tables.stateCount; state++)
+    {
+        uint32_t sum = 0;
+        for (int i = tables.outBegin[state]; i < tables.outBegin[state + 1]; i++)
+        {
+            sum += (uint32_t)tables.patternScores[tables.outIds[i]];
+        }
+        int link = tables.outLink[state];
+        if (link != NO_STATE)
+        {
+            sum += (uint32_t)tables.outScore[link];
+        }
+        if (sum != (uint32_t)tables.outScore[state])
+        {
+            throw std::runtime_error("Invalid state score in snapshot");
+        }
+    }
+}
+
+/**
+ * @brief writes the phrases and the compiled automaton into a snapshot file
+ * @param matcher - the automaton
+ * @param filePath - the path of the snapshot file
+ * @throw std::runtime_error if the file can't be written
+ */
+inline void writeSnapshot(const AhoCorasick& matcher, const std::string& filePath)
+{
+    const AhoCorasick::Tables& tables = matcher.tables();
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+    header.version          = SNAPSHOT_VERSION;
+    header.headerSize       = sizeof(SnapshotHeader);
+    header.classCount       = tables.classCount;
+    header.stateCount       = tables.stateCount;
+    header.patternCount     = tables.patternCount;
+    header.patternBytesSize = tables.patternBytesSize;
+
+    uint64_t offsets[SNAPSHOT_NUM_OF_SECTIONS];
+    snapshotLayout(header, offsets);
+
+    // Copies every table into it's section, the padding stays zero
+    std::vector<char> payload(offsets[END_SECTION], 0);
+    const void* sources[END_SECTION] = {tables.byteClass, tables.delta, tables.outScore,
+                                        tables.outLink, tables.outBegin, tables.outIds,
+                                        tables.patternScores, tables.patternOffsets,
+                                        tables.patternBytes};
+    uint64_t sizes[END_SECTION] = {
+            (uint64_t)ALPHABET_SIZE * sizeof(int32_t),
+            (uint64_t)tables.stateCount * tables.classCount * sizeof(int32_t),
+            (uint64_t)tables.stateCount * sizeof(int32_t),
+            (uint64_t)tables.stateCount * sizeof(int32_t),
+            ((uint64_t)tables.stateCount + 1) * sizeof(int32_t),
+            (uint64_t)tables.patternCount * sizeof(int32_t),
+            (uint64_t)tables.patternCount * sizeof(int32_t),
+            ((uint64_t)tables.patternCount + 1) * sizeof(int32_t),
+            (uint64_t)tables.patternBytesSize};
+    for (int i = 0; i < END_SECTION; i++)
+    {
+        if (sizes[i] > 0)
+        {
+            std::memcpy(payload.data() + offsets[i], sources[i], sizes[i]);
+        }
+    }
+    header.payloadSize = payload.size();
+    header.checksum = snapshotChecksum(payload.data(), payload.size());
+
+    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(payload.data(), (std::streamsize)payload.size());
+    out.close();
+    if (!out)
+    {
+        throw std::runtime_error("Can't write " + filePath);
+    }
+}
+
+/**
+ * @brief checks if a file starts with the magic of a snapshot
+ * @param filePath - the path of the file
+ * @return true if the file is a snapshot, false otherwise
+ */
+inline bool isSnapshotFile(const std::string& filePath)
+{
+    std::ifstream in(filePath, std::ios::binary);
+    char magic[SNAPSHOT_MAGIC_SIZE];
+    return in.read(magic, SNAPSHOT_MAGIC_SIZE) &&
+           std::memcmp(magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) == 0;
+}
+
+/**
+ * @brief maps a snapshot file and returns the automaton saved in it. The tables are used in place,
+ *        nothing is parsed or allocated per phrase
+ * @param filePath - the path of the snapshot file
+ * @return the automaton (it keeps the file mapped)
+ * @throw std::runtime_error if the file is not a valid snapshot of this version, or it's tables
+ *        index out of their ranges
+ */
+inline AhoCorasick loadSnapshot(const std::string& filePath)
+{
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(filePath);
+
+    SnapshotHeader header;
+    if (file->size() < sizeof(header))
+    {
+        throw std::runtime_error("Truncated snapshot " + filePath);
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) != 0)
+    {
+        throw std::runtime_error("Not a snapshot " + filePath);
+    }
+    if (header.version != SNAPSHOT_VERSION || header.headerSize != sizeof(header))
+    {
+        throw std::runtime_error("Unsupported snapshot version " + filePath);
+    }
+    if (header.classCount < 1 || header.stateCount < 1 || header.patternCount < 0 ||
+        header.patternBytesSize < 0)
+    {
+        throw std::runtime_error("Invalid snapshot " + filePath);
+    }
+
+    uint64_t offsets[SNAPSHOT_NUM_OF_SECTIONS];
+    snapshotLayout(header, offsets);
+    const char* payload = file->data() + sizeof(header);
+    if (header.payloadSize != offsets[END_SECTION] ||
+        file->size() - sizeof(header) != header.payloadSize)
+    {
+        throw std::runtime_error("Truncated snapshot " + filePath);
+    }
+    if (snapshotChecksum(payload, header.payloadSize) != header.checksum)
+    {
+        throw std::runtime_error("Bad checksum of snapshot " + filePath);
+    }
+
+    AhoCorasick::Tables tables;
+    tables.classCount       = header.classCount;
+    tables.stateCount       = header.stateCount;
+    tables.patternCount     = header.patternCount;
+    tables.patternBytesSize = header.patternBytesSize;
+    tables.byteClass      = reinterpret_cast<const int*>(payload + offsets[BYTE_CLASS_SECTION]);
+    tables.delta          = reinterpret_cast<const int*>(payload + offsets[DELTA_SECTION]);
+    tables.outScore       = reinterpret_cast<const int*>(payload + offsets[OUT_SCORE_SECTION]);
+    tables.outLink        = reinterpret_cast<const int*>(payload + offsets[OUT_LINK_SECTION]);
+    tables.outBegin       = reinterpret_cast<const int*>(payload + offsets[OUT_BEGIN_SECTION]);
+    tables.outIds         = reinterpret_cast<const int*>(payload + offsets[OUT_IDS_SECTION]);
+    tables.patternScores  = reinterpret_cast<const int*>(payload +
+                                                         offsets[PATTERN_SCORES_SECTION]);
+    tables.patternOffsets = reinterpret_cast<const int*>(payload +
+                                                         offsets[PATTERN_OFFSETS_SECTION]);
+    tables.patternBytes   = payload + offsets[PATTERN_BYTES_SECTION];
+
+    // The checksum only catches damage, the indexes are checked before any of them is used
+    validateSnapshotTables(tables);
+    return AhoCorasick(tables, file);
+}
+
+#endif //CPP_EX3_DATABASESNAPSHOT_HPP
@@ -0,0 +1,409 @@
+/**
+* @file    DetectorBenchmark.cpp
+* @author  user
+* @version 1.0
+* @brief   End to end benchmark of the SpamDetector pipeline on a synthetic corpus
+* @section generates phrase databases (of different numbers and lengths of phrases) and emails (of
+*          different sizes and densities of phrases) with a seeded CorpusGenerator, so every run on
+*          every machine scans the same bytes. Then times each stage of the pipeline: the load of
+*          the database (readDataBaseFile, the build of the automaton and of the rolling hash
+*          matcher, and the load of a snapshot) and the scan of the emails (readEmailFile, the
+*          reference findStringsInEmail, the automaton and the rolling hash matcher on a string, and
+*          scoreEmailFile with each read mode), and prints the time, MB/s and emails/s of each one.
+*          The reference, the automaton and the rolling hash scores of every email are compared, a
+*          difference fails the run. Everything runs locally, on temporary files.
+*          Build: make DetectorBenchmark, or
+*                 g++ -std=c++17 -O2 -pthread DetectorBenchmark.cpp -o DetectorBenchmark
+*                 -lboost_filesystem
+*          Usage: DetectorBenchmark [--seed=<n>] [--quick] [corpus directory]
+*          The corpus is written into the directory and kept, or into a temporary directory that
+*          is removed at the end. --quick runs the small databases and emails only.
+*/
+
+// -------------------------------------- includes -------------------------------------------------
+
+// The functions of the program, without it's main
+#define SPAM_DETECTOR_NO_MAIN
+#include "SpamDetector.cpp"
+#include "CorpusGenerator.hpp"
+#include <iomanip>
+#include <chrono>
+
+#define DEFAULT_SEED 1
+#define SEED_OPTION "--seed="
+#define QUICK_OPTION "--quick"
+#define EMAILS_PER_CONFIG 8
+#define TARGET_SCANNED_BYTES (32 << 20)
+#define QUICK_TARGET_SCANNED_BYTES (4 << 20)
+#define LOAD_REPEATS 3
+#define REFERENCE_BUDGET 2000000000.0
+#define QUICK_MAX_PHRASES 10000
+#define QUICK_MAX_EMAIL_SIZE 65536
+#define BYTES_IN_MB (1024.0 * 1024.0)
+#define BENCH_USAGE_ERR "Usage: DetectorBenchmark [--seed=<n>] [--quick] [corpus directory]"
+#define NO_VALUE "-"
+
+typedef std::chrono::steady_clock benchClock;
+
+// The results of the timed stages are added here, so the compiler can't drop them
+static volatile long long benchSink = 0;
+
+/**
+ * @brief the settings of a generated database
+ */
+struct DatabaseConfig
+{
+    int phrases;      // the number of phrases
+    size_t minLength; // the shortest phrase
+    size_t maxLength; // the longest phrase
+};
+
+/**
+ * @brief the settings of a group of generated emails
+ */
+struct EmailConfig
+{
+    size_t size;            // the size of every email
+    double hitsPerKilobyte; // the average number of phrases in a kilobyte
+};
+
+static const DatabaseConfig DATABASE_CONFIGS[] = {{100, 8, 24}, {10000, 8, 40}, {100000, 8, 60}};
+static const EmailConfig EMAIL_CONFIGS[] = {{4096, 0.5}, {4096, 8}, {65536, 0.5}, {65536, 8},
+                                            {1 << 20, 0.5}, {1 << 20, 8}};
+
+// ------------------------------------------- function declaration --------------------------------
+
+/**
+ * @brief runs a timed function
+ * @param function - the function
+ * @return the time it took, in seconds
+ */
+template <class F>
+double secondsOf(F function)
+{
+    auto start = benchClock::now();
+    function();
+    std::chrono::duration<double> elapsed = benchClock::now() - start;
+    return elapsed.count();
+}
+
+/**
+ * @brief prints the header of the results table
+ */
+void printHeader()
+{
+    std::cout << std::left << std::setw(22) << "stage" << std::right << std::setw(9) << "phrases"
+              << std::setw(10) << "email" << std::setw(8) << "hits/KB" << std::setw(8) << "count"
+              << std::setw(11) << "seconds" << std::setw(11) << "MB/s" << std::setw(12)
+              << "emails/s" << std::endl;
+}
+
+/**
+ * @brief prints a row of the results table
+ * @param stage - the name of the stage
+ * @param phrases - the number of phrases of the database
+ * @param email - the email config, or nullptr for a stage of the database
+ * @param count - the number of emails (or loads) that were timed
+ * @param seconds - the time of all of them
+ * @param bytes - the number of bytes of all of them
+ */
+void printRow(const std::string& stage, int phrases, const EmailConfig* email, long long count,
+              double seconds, double bytes)
+{
+    std::cout << std::left << std::setw(22) << stage << std::right << std::setw(9) << phrases;
+    if (email == nullptr)
+    {
+        std::cout << std::setw(10) << NO_VALUE << std::setw(8) << NO_VALUE;
+    }
+    else
+    {
+        std::cout << std::setw(10) << email->size << std::fixed << std::setprecision(1)
+                  << std::setw(8) << email->hitsPerKilobyte;
+    }
+    std::cout << std::setw(8) << count << std::fixed << std::setprecision(4) << std::setw(11)
+              << seconds << std::setprecision(1) << std::setw(11) << bytes / BYTES_IN_MB / seconds;
+    if (email == nullptr)
+    {
+        std::cout << std::setw(12) << NO_VALUE << std::endl;
+        return;
+    }
+    std::cout << std::setw(12) << (double)count / seconds << std::endl;
+}
+
+/**
+ * @brief generates a group of emails, times every stage of the scan on them and compares the
+ *        reference, the automaton and the rolling hash scores
+ * @param generator - the generator of the corpus
+ * @param directory - the directory to write the emails into
+ * @param database - the settings of the database
+ * @param phrases - the phrases of the database
+ * @param stringsMap - the loaded database
+ * @param matcher - the automaton of the database
+ * @param rolling - the rolling hash matcher of the database
+ * @param email - the settings of the emails
+ * @param targetBytes - the number of bytes to scan in each stage (at least one email per file)
+ * @return true if the scores of the reference, the automaton and the rolling hash matcher are the
+ *         same, false otherwise
+ */
+bool benchmarkEmails(CorpusGenerator& generator, const std::string& directory,
+                     const DatabaseConfig& database, const std::vector<std::string>& phrases,
+                     PhraseTable& stringsMap, const AhoCorasick& matcher,
+                     const RollingHashMatcher& rolling, const EmailConfig& email,
+                     size_t targetBytes)
+{
+    std::vector<std::string> paths;
+    for (int i = 0; i < EMAILS_PER_CONFIG; i++)
+    {
+        std::string path = directory + "/email_" + std::to_string(database.phrases) + "_" +
+                           std::to_string(email.size) + "_" +
+                           std::to_string((int)(email.hitsPerKilobyte * 10)) + "_" +
+                           std::to_string(i) + ".txt";
+        CorpusGenerator::writeText(path, generator.email(email.size, email.hitsPerKilobyte,
+                                                         phrases));
+        paths.push_back(path);
+    }
+    long long count = std::max((long long)EMAILS_PER_CONFIG,
+                               (long long)(targetBytes / email.size));
+    double bytes = (double)count * (double)email.size;
+
+    // Every stage goes over the files in turn, the results are summed so nothing is dropped
+    long long sink = 0;
+    std::vector<std::string> texts(paths.size());
+    double seconds = secondsOf([&]
+    {
+        for (long long i = 0; i < count; i++)
+        {
+            std::string& text = texts[i % paths.size()];
+            text.clear();
+            readEmailFile(paths[i % paths.size()], text);
+            sink += (long long)text.size();
+        }
+    });
+    printRow("readEmailFile", database.phrases, &email, count, seconds, bytes);
+
+    // The reference scans the email once per phrase, it gets a bounded amount of work
+    std::vector<int> referenceScores(texts.size());
+    long long referenceCount = std::min(count, (long long)(REFERENCE_BUDGET / (double)email.size /
+                                                           database.phrases));
+    if (referenceCount < (long long)texts.size())
+    {
+        referenceCount = (long long)texts.size();
+    }
+    seconds = secondsOf([&]
+    {
+        for (long long i = 0; i < referenceCount; i++)
+        {
+            referenceScores[i % texts.size()] = findStringsInEmail(stringsMap,
+                                                                   texts[i % texts.size()]);
+        }
+    });
+    printRow("findStringsInEmail", database.phrases, &email, referenceCount, seconds,
+             (double)referenceCount * (double)email.size);
+
+    bool same = true;
+    for (size_t i = 0; i < texts.size(); i++)
+    {
+        if (matcher.score(texts[i]) != referenceScores[i] ||
+            rolling.score(texts[i]) != referenceScores[i])
+        {
+            std::cerr << "Scores differ on " << paths[i] << std::endl;
+            same = false;
+        }
+    }
+
+    seconds = secondsOf([&]
+    {
+        for (long long i = 0; i < count; i++)
+        {
+            sink += matcher.score(texts[i % texts.size()]);
+        }
+    });
+    printRow("AhoCorasick::score", database.phrases, &email, count, seconds, bytes);
+
+    seconds = secondsOf([&]
+    {
+        for (long long i = 0; i < count; i++)
+        {
+            sink += rolling.score(texts[i % texts.size()]);
+        }
+    });
+    printRow("RollingHash::score", database.phrases, &email, count, seconds, bytes);
+
+    const std::pair<EmailReadMode, std::string> modes[] = {{READ_WHOLE, "scoreEmailFile"},
+                                                           {READ_MAPPED, "scoreEmailFile mmap"},
+                                                           {READ_STREAMED, "scoreEmailFile stream"}};
+    for (const auto& mode : modes)
+    {
+        seconds = secondsOf([&]
+        {
+            for (long long i = 0; i < count; i++)
+            {
+                sink += scoreEmailFile(paths[i % paths.size()], matcher, mode.first,
+                                       NO_SCORE_TARGET).totalScore;
+            }
+        });
+        printRow(mode.second, database.phrases, &email, count, seconds, bytes);
+    }
+
+    benchSink = benchSink + sink;
+    return same;
+}
+
+/**
+ * @brief generates a database, times the stages of it's load and then the scan of all the email
+ *        groups with it
+ * @param generator - the generator of the corpus
+ * @param directory - the directory to write the files into
+ * @param database - the settings of the database
+ * @param quick - true to scan the small emails only
+ * @return true if the scores of the reference, the automaton and the rolling hash matcher are the
+ *         same, false otherwise
+ */
+bool benchmarkDatabase(CorpusGenerator& generator, const std::string& directory,
+                       const DatabaseConfig& database, bool quick)
+{
+    std::vector<std::string> phrases = generator.phrases(database.phrases, database.minLength,
+                                                         database.maxLength);
+    std::string dataBasePath = directory + "/db_" + std::to_string(database.phrases) + ".csv";
+    std::string snapshotPath = directory + "/db_" + std::to_string(database.phrases) + ".snap";
+    generator.writeDatabase(dataBasePath, phrases);
+    double dataBaseBytes = (double)boost::filesystem::file_size(dataBasePath);
+
+    // The loads are repeated, the best time is printed
+    PhraseTable stringsMap;
+    double best = 0;
+    for (int i = 0; i < LOAD_REPEATS; i++)
+    {
+        PhraseTable loaded;
+        double seconds = secondsOf([&]
+        {
+            readDataBaseFile(dataBasePath, loaded);
+        });
+        best = (i == 0) ? seconds : std::min(best, seconds);
+        stringsMap = std::move(loaded);
+    }
+    printRow("readDataBaseFile", database.phrases, nullptr, LOAD_REPEATS, best, dataBaseBytes);
+
+    std::unique_ptr<AhoCorasick> matcher;
+    for (int i = 0; i < LOAD_REPEATS; i++)
+    {
+        double seconds = secondsOf([&]
+        {
+            matcher.reset(new AhoCorasick(stringsMap));
+        });
+        best = (i == 0) ? seconds : std::min(best, seconds);
+    }
+    printRow("AhoCorasick build", database.phrases, nullptr, LOAD_REPEATS, best, dataBaseBytes);
+
+    std::unique_ptr<RollingHashMatcher> rolling;
+    for (int i = 0; i < LOAD_REPEATS; i++)
+    {
+        double seconds = secondsOf([&]
+        {
+            rolling.reset(new RollingHashMatcher(stringsMap));
+        });
+        best = (i == 0) ? seconds : std::min(best, seconds);
+    }
+    printRow("RollingHash build", database.phrases, nullptr, LOAD_REPEATS, best, dataBaseBytes);
+
+    writeSnapshot(*matcher, snapshotPath);
+    for (int i = 0; i < LOAD_REPEATS; i++)
+    {
+        std::unique_ptr<AhoCorasick> mapped;
+        double seconds = secondsOf([&]
+        {
+            mapped = loadMatcher(snapshotPath);
+        });
+        best = (i == 0) ? seconds : std::min(best, seconds);
+    }
+    printRow("snapshot load", database.phrases, nullptr, LOAD_REPEATS, best, dataBaseBytes);
+
+    bool same = true;
+    for (const EmailConfig& email : EMAIL_CONFIGS)
+    {
+        if (quick && email.size > QUICK_MAX_EMAIL_SIZE)
+        {
+            continue;
+        }
+        same &= benchmarkEmails(generator, directory, database, phrases, stringsMap, *matcher,
+                                *rolling, email,
+                                quick ? QUICK_TARGET_SCANNED_BYTES : TARGET_SCANNED_BYTES);
+    }
+    return same;
+}
+
+/**
+ * @brief runs the benchmark
+ * @param argc - the number of arguments
+ * @param argv - the arguments: [--seed=<n>] [--quick] [corpus directory]
+ * @return 0 if success, 1 if failure
+ */
+int main(int argc, char *argv[])
+{
+    uint64_t seed = DEFAULT_SEED;
+    bool quick = false;
+    std::string directory;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg.compare(0, std::strlen(SEED_OPTION), SEED_OPTION) == 0)
+        {
+            std::string value = arg.substr(std::strlen(SEED_OPTION));
+            if (value.empty() || !isValidString(value))
+            {
+                std::cout << BENCH_USAGE_ERR << std::endl;
+                return EXIT_FAILURE;
+            }
+            seed = std::stoull(value);
+        }
+        else if (arg == QUICK_OPTION)
+        {
+            quick = true;
+        }
+        else if (directory.empty() && arg.compare(0, std::strlen(OPTION_PREFIX), OPTION_PREFIX) != 0)
+        {
+            directory = arg;
+        }
+        else
+        {
+            std::cout << BENCH_USAGE_ERR << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Without a directory, the corpus is written into a temporary directory and removed
+    bool temporary = directory.empty();
+    if (temporary)
+    {
+        directory = (boost::filesystem::temp_directory_path() /
+                     boost::filesystem::unique_path("DetectorBenchmark-%%%%-%%%%")).string();
+    }
+    boost::filesystem::create_directories(directory);
+
+    std::cout << "seed " << seed << ", corpus in " << directory << std::endl;
+    printHeader();
+    bool same = true;
+    try
+    {
+        CorpusGenerator generator(seed);
+        for (const DatabaseConfig& database : DATABASE_CONFIGS)
+        {
+            if (quick && database.phrases > QUICK_MAX_PHRASES)
+            {
+                continue;
+            }
+            same &= benchmarkDatabase(generator, directory, database, quick);
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        same = false;
+    }
+
+    if (temporary)
+    {
+        boost::filesystem::remove_all(directory);
+    }
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
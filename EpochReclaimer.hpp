@@ -0,0 +1,230 @@
+// EpochReclaimer.hpp
+
+#ifndef CPP_EX3_EPOCHRECLAIMER_HPP
+#define CPP_EX3_EPOCHRECLAIMER_HPP
+
+#define RECLAIMER_NUM_OF_SLOTS 64
+#define RECLAIMER_CACHE_LINE 64
+#define RECLAIMER_BATCH_SIZE 128
+#define RECLAIMER_NUM_OF_FLIPS 2
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+
+// ------------------------------------------- class declaration -----------------------------------
+
+/**
+ * @brief a deferred reclamation scheme for lock-free readers (in the style of SRCU). Readers mark
+ *        the start and end of every read with a counter of the current epoch parity, without any
+ *        lock or wait. A writer that unlinks an object retires it instead of deleting it, and the
+ *        retired objects are deleted only after every reader that could still see them is done.
+ *        The counters are spread over cache line padded slots, so readers on different threads
+ *        don't write the same line
+ */
+class EpochReclaimer
+{
+public:
+
+    /**
+     * @brief marks a read (an RAII guard): the objects a reader loads while the guard is alive are
+     *        not deleted until the guard is destroyed
+     */
+    class ReadGuard
+    {
+    public:
+        /**
+         * @brief starts a read
+         * @param reclaimer - the reclaimer that guards the objects
+         */
+        explicit ReadGuard(EpochReclaimer& reclaimer) : _counter(reclaimer._enter())
+        {
+        }
+
+        /**
+         * @brief ends the read
+         */
+        ~ReadGuard() noexcept
+        {
+            _counter->fetch_sub(1, std::memory_order_release);
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        std::atomic<int64_t>* _counter; // the counter that was incremented by the read
+    };
+
+    /**
+     * @brief creates a reclaimer with no readers and no retired objects
+     */
+    EpochReclaimer();
+
+    /**
+     * @brief deletes all the retired objects. There must be no readers
+     */
+    ~EpochReclaimer() noexcept;
+
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    /**
+     * @brief retires an object that was unlinked, it is deleted when no reader can see it. Doesn't
+     *        wait, the deletion happens in a later call to collect() or reclaim()
+     * @tparam T - the type of the object
+     * @param object - the object (created with new)
+     */
+    template <class T>
+    void retire(T* object)
+    {
+        std::lock_guard<std::mutex> lock(_retiredMutex);
+        _retired.push_back(Retired{object, [](void* p)
+        {
+            delete static_cast<T*>(p);
+        }});
+    }
+
+    /**
+     * @brief waits until all the reads that started before the call are done
+     */
+    void synchronize();
+
+    /**
+     * @brief deletes all the objects that were retired before the call (waits for the readers)
+     */
+    void reclaim();
+
+    /**
+     * @brief deletes the retired objects if there are at least RECLAIMER_BATCH_SIZE of them, so the
+     *        wait for the readers is paid once per batch
+     */
+    void collect();
+
+private:
+
+    /**
+     * @brief a retired object and the function that deletes it
+     */
+    struct Retired
+    {
+        void* object;
+        void (*deleter)(void*);
+    };
+
+    /**
+     * @brief the read counters of a slot, one for each epoch parity
+     */
+    struct alignas(RECLAIMER_CACHE_LINE) Slot
+    {
+        std::atomic<int64_t> readers[2];
+    };
+
+    Slot _slots[RECLAIMER_NUM_OF_SLOTS];  // the read counters, threads are spread over the slots
+    std::atomic<uint64_t> _epoch;         // the current epoch, it's parity picks the counters
+    std::mutex _syncMutex;                // one synchronize at a time
+    std::mutex _retiredMutex;             // guards the retired objects
+    std::vector<Retired> _retired;        // the objects that wait to be deleted
+
+    // increments the counter of the current epoch in the slot of the thread and returns it
+    std::atomic<int64_t>* _enter();
+
+    // returns the slot of the calling thread
+    static int _slotOfThread();
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+inline EpochReclaimer::EpochReclaimer() : _epoch(0)
+{
+    for (Slot& slot : _slots)
+    {
+        slot.readers[0].store(0, std::memory_order_relaxed);
+        slot.readers[1].store(0, std::memory_order_relaxed);
+    }
+}
+
+inline EpochReclaimer::~EpochReclaimer() noexcept
+{
+    for (const Retired& retired : _retired)
+    {
+        retired.deleter(retired.object);
+    }
+}
+
+inline int EpochReclaimer::_slotOfThread()
+{
+    static std::atomic<int> nextSlot(0);
+    thread_local int slot = nextSlot.fetch_add(1, std::memory_order_relaxed) %
+                            RECLAIMER_NUM_OF_SLOTS;
+    return slot;
+}
+
+inline std::atomic<int64_t>* EpochReclaimer::_enter()
+{
+    // The fence pairs with the fence of synchronize: either synchronize sees the increment and
+    // waits for the reader, or the reader sees everything that was unlinked before synchronize
+    Slot& slot = _slots[_slotOfThread()];
+    std::atomic<int64_t>* counter = &slot.readers[_epoch.load(std::memory_order_relaxed) & 1];
+    counter->fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return counter;
+}
+
+inline void EpochReclaimer::synchronize()
+{
+    std::lock_guard<std::mutex> lock(_syncMutex);
+
+    // Flips the parity and waits for the readers of the old parity to leave, twice. A reader that
+    // read the parity just before an earlier flip may be counted on either parity, so both are
+    // waited for, each one after new readers were sent to the other
+    for (int flip = 0; flip < RECLAIMER_NUM_OF_FLIPS; flip++)
+    {
+        uint64_t old = _epoch.fetch_add(1, std::memory_order_relaxed) & 1;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (Slot& slot : _slots)
+        {
+            while (slot.readers[old].load(std::memory_order_acquire) != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+inline void EpochReclaimer::reclaim()
+{
+    std::vector<Retired> retired;
+    {
+        std::lock_guard<std::mutex> lock(_retiredMutex);
+        retired.swap(_retired);
+    }
+    if (retired.empty())
+    {
+        return;
+    }
+    synchronize();
+    for (const Retired& object : retired)
+    {
+        object.deleter(object.object);
+    }
+}
+
+inline void EpochReclaimer::collect()
+{
+    {
+        std::lock_guard<std::mutex> lock(_retiredMutex);
+        if (_retired.size() < RECLAIMER_BATCH_SIZE)
+        {
+            return;
+        }
+    }
+    reclaim();
+}
+
+#endif //CPP_EX3_EPOCHRECLAIMER_HPP
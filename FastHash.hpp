@@ -0,0 +1,280 @@
+// FastHash.hpp
+
+#ifndef CPP_EX3_FASTHASH_HPP
+#define CPP_EX3_FASTHASH_HPP
+
+#define FAST_HASH_P0 0xa0761d6478bd642fULL
+#define FAST_HASH_P1 0xe7037ed1a0b428dbULL
+#define FAST_HASH_P2 0x8ebc6af09c88c6e3ULL
+#define FAST_HASH_P3 0x589965cc75374cc3ULL
+#define FAST_HASH_DEFAULT_SEED 0
+#define FAST_HASH_SHORT_INPUT 16
+#define FAST_HASH_BLOCK 48
+
+// Compile with -DFAST_HASH_SEED_PER_PROCESS to seed the default hashes with a random seed that is
+// picked once per process, so the buckets of keys can't be predicted from outside
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <type_traits>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+// ------------------------------------------- class declaration -----------------------------------
+
+/**
+ * @brief the functions that FastHash is built from: a wyhash-style hash of bytes (a 64x64 bit
+ *        multiply folded to 64 bits per 16 bytes, so every input bit reaches the low bits), and
+ *        the seeds
+ */
+class FastHashCore
+{
+public:
+
+    /**
+     * @brief hashes bytes
+     * @param data - the bytes
+     * @param length - the number of bytes
+     * @param seed - the seed
+     * @return the hash
+     */
+    static uint64_t hashBytes(const char* data, size_t length, uint64_t seed);
+
+    /**
+     * @brief mixes a 64 bit value into a hash, every bit of the value changes the low bits
+     * @param value - the value
+     * @param seed - the seed
+     * @return the hash
+     */
+    static uint64_t hashWord(uint64_t value, uint64_t seed)
+    {
+        return mum(value ^ seed ^ FAST_HASH_P0, FAST_HASH_P1);
+    }
+
+    /**
+     * @brief returns a random seed that is picked once per process
+     * @return the seed of the process
+     */
+    static uint64_t processSeed();
+
+    /**
+     * @brief returns the seed of the default constructed hashes: FAST_HASH_DEFAULT_SEED, or the
+     *        seed of the process with FAST_HASH_SEED_PER_PROCESS
+     * @return the default seed
+     */
+    static uint64_t defaultSeed()
+    {
+#ifdef FAST_HASH_SEED_PER_PROCESS
+        return processSeed();
+#else
+        return FAST_HASH_DEFAULT_SEED;
+#endif
+    }
+
+    /**
+     * @brief multiplies two 64 bit numbers into 128 bits and xors the two halves
+     * @param a - the first number
+     * @param b - the second number
+     * @return the folded product
+     */
+    static uint64_t mum(uint64_t a, uint64_t b);
+
+private:
+
+    // multiplies two 64 bit numbers into 128 bits, a gets the low half and b the high half
+    static void _multiply(uint64_t& a, uint64_t& b);
+
+    // reads 8 or 4 bytes (in any alignment)
+    static uint64_t _read64(const unsigned char* p)
+    {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint64_t _read32(const unsigned char* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+};
+
+template <class K>
+
+/**
+ * @brief a fast, well mixed hash with a seed. Integers and enums are mixed with a multiply, other
+ *        keys are hashed with std::hash and then mixed (the low bits of std::hash of an integer
+ *        are the integer itself, which puts keys with the same low bits into the same bucket of a
+ *        power of two table)
+ * @tparam K - the type of the keys
+ */
+class FastHash
+{
+public:
+
+    /**
+     * @brief creates a hash
+     * @param seed - the seed, different seeds give unrelated hashes
+     */
+    explicit FastHash(uint64_t seed = FastHashCore::defaultSeed()) : _seed(seed)
+    {
+    }
+
+    /**
+     * @brief hashes a key
+     * @param key - the key
+     * @return the hash
+     */
+    size_t operator()(const K& key) const
+    {
+        if constexpr (std::is_integral<K>::value || std::is_enum<K>::value)
+        {
+            return (size_t)FastHashCore::hashWord((uint64_t)key, _seed);
+        }
+        else
+        {
+            return (size_t)FastHashCore::hashWord((uint64_t)std::hash<K>{}(key), _seed);
+        }
+    }
+
+private:
+    uint64_t _seed; // the seed
+};
+
+template <class Traits, class A>
+
+/**
+ * @brief the hash of strings: the bytes are hashed directly. A std::string_view (or a const char*)
+ *        with the same characters gets the same hash as the string, so strings can be looked up
+ *        by a view without building a string
+ */
+class FastHash<std::basic_string<char, Traits, A>>
+{
+public:
+
+    /**
+     * @brief creates a hash
+     * @param seed - the seed, different seeds give unrelated hashes
+     */
+    explicit FastHash(uint64_t seed = FastHashCore::defaultSeed()) : _seed(seed)
+    {
+    }
+
+    /**
+     * @brief hashes the characters of a string
+     * @param key - the string
+     * @return the hash
+     */
+    size_t operator()(std::basic_string_view<char, Traits> key) const
+    {
+        return (size_t)FastHashCore::hashBytes(key.data(), key.size(), _seed);
+    }
+
+private:
+    uint64_t _seed; // the seed
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+inline uint64_t FastHashCore::mum(uint64_t a, uint64_t b)
+{
+    _multiply(a, b);
+    return a ^ b;
+}
+
+inline void FastHashCore::_multiply(uint64_t& a, uint64_t& b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t)a * b;
+    a = (uint64_t)product;
+    b = (uint64_t)(product >> 64);
+#else
+    // The four 32x32 bit products of the halves
+    uint64_t aLow = (uint32_t)a;
+    uint64_t aHigh = a >> 32;
+    uint64_t bLow = (uint32_t)b;
+    uint64_t bHigh = b >> 32;
+    uint64_t lowLow = aLow * bLow;
+    uint64_t lowHigh = aLow * bHigh;
+    uint64_t highLow = aHigh * bLow;
+    uint64_t highHigh = aHigh * bHigh;
+    uint64_t middle = (lowLow >> 32) + (uint32_t)lowHigh + (uint32_t)highLow;
+    a = (middle << 32) | (uint32_t)lowLow;
+    b = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+#endif
+}
+
+inline uint64_t FastHashCore::hashBytes(const char* data, size_t length, uint64_t seed)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    seed ^= mum(seed ^ FAST_HASH_P0, FAST_HASH_P1);
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (length <= FAST_HASH_SHORT_INPUT)
+    {
+        // Up to 16 bytes are read as two overlapping pairs of 4 bytes (or 3 single bytes)
+        if (length >= 4)
+        {
+            size_t shift = (length >> 3) << 2;
+            a = (_read32(p) << 32) | _read32(p + shift);
+            b = (_read32(p + length - 4) << 32) | _read32(p + length - 4 - shift);
+        }
+        else if (length > 0)
+        {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+        }
+    }
+    else
+    {
+        // Longer inputs are consumed 48 bytes at a time in three independent lanes, then 16 bytes
+        // at a time, and the last 16 bytes are read as they are
+        size_t left = length;
+        if (left > FAST_HASH_BLOCK)
+        {
+            uint64_t lane1 = seed;
+            uint64_t lane2 = seed;
+            do
+            {
+                seed = mum(_read64(p) ^ FAST_HASH_P1, _read64(p + 8) ^ seed);
+                lane1 = mum(_read64(p + 16) ^ FAST_HASH_P2, _read64(p + 24) ^ lane1);
+                lane2 = mum(_read64(p + 32) ^ FAST_HASH_P3, _read64(p + 40) ^ lane2);
+                p += FAST_HASH_BLOCK;
+                left -= FAST_HASH_BLOCK;
+            } while (left > FAST_HASH_BLOCK);
+            seed ^= lane1 ^ lane2;
+        }
+        while (left > FAST_HASH_SHORT_INPUT)
+        {
+            seed = mum(_read64(p) ^ FAST_HASH_P1, _read64(p + 8) ^ seed);
+            p += FAST_HASH_SHORT_INPUT;
+            left -= FAST_HASH_SHORT_INPUT;
+        }
+        a = _read64(p + left - 16);
+        b = _read64(p + left - 8);
+    }
+    a ^= FAST_HASH_P1;
+    b ^= seed;
+    _multiply(a, b);
+    return mum(a ^ FAST_HASH_P0 ^ length, b ^ FAST_HASH_P1);
+}
+
+inline uint64_t FastHashCore::processSeed()
+{
+    static const uint64_t seed = []
+    {
+        std::random_device device;
+        uint64_t value = ((uint64_t)device() << 32) ^ device();
+        value ^= (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+        return mum(value ^ FAST_HASH_P2, FAST_HASH_P3);
+    }();
+    return seed;
+}
+
+#endif //CPP_EX3_FASTHASH_HPP
@@ -0,0 +1,928 @@
+// FlatHashMap.hpp
+
+#ifndef CPP_EX3_FLATHASHMAP_HPP
+#define CPP_EX3_FLATHASHMAP_HPP
+
+#define FLAT_GROUP_WIDTH 16
+#define FLAT_MIN_CAPACITY 16
+#define FLAT_MAX_LOAD_NUMERATOR 7
+#define FLAT_MAX_LOAD_DENOMINATOR 8
+#define FLAT_CTRL_EMPTY ((signed char)-128)
+#define FLAT_CTRL_DELETED ((signed char)-2)
+#define FLAT_H2_MASK 0x7F
+#define FLAT_H2_BITS 7
+#define FLAT_HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+#define FLAT_HASH_SHIFT 32
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <new>
+#include <iterator>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// ------------------------------------------- function declaration --------------------------------
+
+template <class KeyT, class ValueT>
+
+/**
+ * @brief a template Hash Map with open addressing (SwissTable style). The pairs are saved in one
+ *        contiguous array of slots, and every slot has a metadata byte (empty, deleted, or 7 bits
+ *        of the hash of the key). A lookup scans a whole group of metadata bytes at once (with
+ *        SSE2 when available), so it usually costs a single cache line. It has the same public
+ *        API as HashMap, and can be used as a drop-in replacement for it
+ * @tparam KeyT - the template parameter that represents the key
+ * @tparam ValueT - the template parameter that represents the value
+ */
+class FlatHashMap
+{
+    typedef std::pair<KeyT, ValueT> pair;
+
+private:
+    int _size;         // saves the current size of the hash map
+    int _capacity;     // saves the number of slots in the hash map (a multiple of the group width)
+    int _tombstones;   // saves the number of slots that are marked as deleted
+    signed char* _ctrl; // the metadata byte of each slot
+    pair* _slots;      // the array of slots, only the slots with a full metadata byte are alive
+
+//-----------------------------------------private functions----------------------------------------
+
+    // Gets a key and calculates the (mixed) hash code of the key
+    static size_t _hashCode(const KeyT& key);
+
+    // Mixes a hash value, so the group index and the metadata byte don't depend on the same bits
+    static size_t _mix(size_t hash);
+
+    // Checks if K can be used to look up a key without converting it to KeyT
+    template <class K>
+    using _isTransparent = std::integral_constant<bool,
+            std::is_same<KeyT, std::string>::value &&
+            !std::is_same<typename std::decay<K>::type, KeyT>::value &&
+            std::is_convertible<const K&, std::string_view>::value>;
+
+    // returns a bit mask of the slots in the group that their metadata byte equals the given byte
+    static unsigned int _matchByte(const signed char* group, signed char byte);
+
+    // returns a bit mask of the slots in the group that are empty
+    static unsigned int _matchEmpty(const signed char* group);
+
+    // returns a bit mask of the slots in the group that are empty or deleted
+    static unsigned int _matchFree(const signed char* group);
+
+    // returns the index of the slot of the key, or -1 if the key is not in the map
+    template <class K>
+    int _findSlot(const K& key, size_t hash) const;
+
+    // makes sure there is room for one more pair and returns the free slot for the hash
+    int _prepareInsert(size_t hash);
+
+    // returns the index of the first empty or deleted slot in the probe sequence of the hash
+    int _findFreeSlot(size_t hash) const;
+
+    // allocates an empty table with the given capacity
+    void _allocate(int capacity);
+
+    // destroys all the pairs and frees the table
+    void _release() noexcept;
+
+    // moves all the pairs into a new table with the given capacity
+    void _rehash(int newCapacity);
+
+    // exchanges the contents of the two maps
+    void _swap(FlatHashMap& other) noexcept;
+
+public:
+
+    /**
+     * @brief a class that represents a const iterator that is used to iterate over the items in
+     *        the hash map
+     */
+    class const_iterator
+    {
+    public:
+
+        typedef const_iterator self_type;
+        typedef std::pair<KeyT, ValueT> value_type;
+        typedef std::pair<KeyT, ValueT> &reference;
+        typedef std::pair<KeyT, ValueT> *pointer;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int difference_type;
+
+        /**
+         * @brief a constructor for const_iterator class
+         * @param thisMap - the FlatHashMap object to iterate on
+         * @param i - the index of a full slot, or the capacity for the end iterator
+         */
+        explicit const_iterator(const FlatHashMap* thisMap, int i): _obj(thisMap), _index(i)
+        {
+        }
+
+        /**
+         * @brief returns the value that the iterator points at
+         * @return the current pair that the iterator iterates on
+         */
+        std::pair<KeyT, ValueT> &operator*()
+        {
+            return _obj->_slots[_index];
+        }
+
+        /**
+         * @brief returns the value of the current pair (const)
+         * @return the current pair
+         */
+        const std::pair<KeyT, ValueT> &operator*() const
+        {
+            return _obj->_slots[_index];
+        }
+
+        /**
+         * @brief returns the object that the iterator iterates on
+         * @return the object that the iterator iterates on
+         */
+        std::pair<KeyT, ValueT> *operator->()
+        {
+            return &_obj->_slots[_index];
+        }
+
+        /**
+         * @brief returns the object that the iterator iterates on (const)
+         * @return the object that the iterator iterates on
+         */
+        const std::pair<KeyT, ValueT> *operator->() const
+        {
+            return &_obj->_slots[_index];
+        }
+
+        /**
+         * @brief moves the iterator to the next object and returns the pointer to the next object
+         * @return the pointer to the next object in the hash map
+         */
+        const_iterator &operator++()
+        {
+            _index = _obj->_nextFull(_index + 1);
+            return *this;
+        }
+
+        /**
+         * @brief returns the pointer to the current object and than moves the iterator to the
+         *        next object in the hash map
+         * @return the next object in the hash map
+         */
+        const_iterator operator++(int)
+        {
+            const_iterator temp = *this;
+            _index = _obj->_nextFull(_index + 1);
+            return temp;
+        }
+
+        /**
+         * @brief Checks if two iterators are equal
+         * @param other - the other iterator
+         * @return true if the iterators are equal, false otherwise
+         */
+        bool operator==(const const_iterator &other) const
+        {
+            return other._obj == _obj && other._index == _index;
+        }
+
+        /**
+         * @brief Checks if two iterators are not equal
+         * @param other - the other iterator
+         * @return true if the iterators are not equal, false otherwise
+         */
+        bool operator!=(const const_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        const FlatHashMap* _obj; // a pointer to the object of the FlatHashMap
+        int _index;              // the index of the current slot
+    }; // end of class const_iterator
+
+    /**
+     * @brief returns iterator to the begin of the hash map
+     * @return iterator to the begin of the hash map
+     */
+    const_iterator begin() const
+    {
+        return const_iterator(this, _nextFull(0));
+    }
+
+    /**
+     * @brief returns an iterator to the end of the hash map
+     * @return an iterator to the end of the hash map
+     */
+    const_iterator end() const
+    {
+        return const_iterator(this, _capacity);
+    }
+
+    /**
+     * @brief returns iterator to the begin of the hash map
+     * @return an iterator to the begin of the hash map
+     */
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    /**
+     * @brief returns an iterator to the end of the hash map
+     * @return an iterator to the end of the hash map
+     */
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /**
+     * @brief default constructor, initializes an empty hash map
+     */
+    FlatHashMap();
+
+    /**
+     * @brief a constructor for hash map, receives a vector of keys and a vector of values and
+     *        saves them into the hash map (if a key appears twice, the last value is saved)
+     * @param keys   - a vector that contains keys
+     * @param values - a vector that contains values
+     */
+    FlatHashMap(const std::vector<KeyT>& keys, const std::vector<ValueT>& values);
+
+    /**
+     * @brief copy constructor for hash map
+     * @param other - the other map
+     */
+    FlatHashMap(const FlatHashMap& other);
+
+    /**
+     * @brief move constructor for hash map, takes the table of the other map without copying it.
+     *        The other map is left empty and without slots, it gets a table when a pair is
+     *        inserted into it
+     * @param other - the other map
+     */
+    FlatHashMap(FlatHashMap&& other) noexcept;
+
+    /**
+     * @brief destructor for hash map
+     */
+    ~FlatHashMap() noexcept;
+
+    /**
+     * @brief inserts a new pair<key, value> into the hash map
+     * @param key - the key to insert
+     * @param value - the value to insert
+     * @return true if the pair was inserted, false otherwise
+     */
+    bool insert(const KeyT& key, const ValueT& value);
+
+    /**
+     * @brief checks if the key exists in the map
+     * @param key - the key to check if exist
+     * @return true if the key exists, false otherwise
+     */
+    bool containsKey(const KeyT& key) const;
+
+    /**
+     * @brief returns true if the hash map is empty
+     * @return true if the hash map is empty, false otherwise
+     */
+    bool empty() const;
+
+    /**
+     * @brief returns the number size
+     * @return - the size of the hash map (number of elements in the hash map)
+     */
+    int size() const;
+
+    /**
+     * @brief returns the number capacity
+     * @return - the capacity of the hash map (number of slots)
+     */
+    int capacity() const;
+
+    /**
+     * @brief gets a key, checks if the key exists in the map, if yes, returns it's value
+     * @param key - the key
+     * @return - the value of the key
+     */
+    ValueT& at(const KeyT& key);
+
+    /**
+     * @brief gets a key, checks if the key exists in the map, if yes, returns it's value (const)
+     * @param key - the key
+     * @return - the value of the key (const)
+     */
+    const ValueT& at(const KeyT& key) const;
+
+    /**
+     * @brief return the load factor
+     * @return the load factor
+     */
+    double getLoadFactor() const;
+
+    /**
+     * @brief erases the value in the given key
+     * @param key - the key
+     * @return - true if the erase worked, false if the erase failed
+     */
+    bool erase(const KeyT& key);
+
+    /**
+     * @brief copies the values of the other hash map into the current hash map
+     * @param other - the other hash map
+     * @return - the current hash map object
+     */
+    FlatHashMap& operator=(const FlatHashMap& other);
+
+    /**
+     * @brief moves the other hash map into the current hash map, without copying the pairs. The
+     *        other map gets the previous pairs of the current map
+     * @param other - the other hash map
+     * @return - the current hash map object
+     */
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept;
+
+    /**
+     * @brief clears the map
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief returns the value in the key int the map (const)
+     * @param key - the key
+     * @return - the value of the key, or a default value if the key doesn't exist
+     */
+    const ValueT operator[](const KeyT& key) const noexcept;
+
+    /**
+     * @brief returns the value in the key int the map, inserts a default value if the key doesn't
+     *        exist
+     * @param key- the key
+     * @return - the value of the key
+     */
+    ValueT& operator[](const KeyT& key) noexcept;
+
+    /**
+     * @brief Checks if the current map equals other map
+     * @param other - the other hash map
+     * @return true if the maps are equal, false otherwise
+     */
+    bool operator==(const FlatHashMap& other) const noexcept;
+
+    /**
+     * @brief Checks if the current map not equals other map
+     * @param other - the other hash map
+     * @return true if the maps are not equal, false otherwise
+     */
+    bool operator!=(const FlatHashMap& other) const noexcept;
+
+    /**
+     * @brief searches the key in the map, hashes the key only once
+     * @param key - the key
+     * @return an iterator to the pair of the key, or end() if the key doesn't exist
+     */
+    const_iterator find(const KeyT& key) const
+    {
+        int index = _findSlot(key, _hashCode(key));
+        return const_iterator(this, (index == -1) ? _capacity : index);
+    }
+
+    /**
+     * @brief searches a string key in the map without creating a KeyT
+     * @tparam K - a type that can be converted to std::string_view (only if KeyT is std::string)
+     * @param key - the key
+     * @return an iterator to the pair of the key, or end() if the key doesn't exist
+     */
+    template <class K, typename std::enable_if<_isTransparent<K>::value, int>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        std::string_view keyView(key);
+        int index = _findSlot(keyView, _mix(std::hash<std::string_view>{}(keyView)));
+        return const_iterator(this, (index == -1) ? _capacity : index);
+    }
+
+    /**
+     * @brief checks if a string key exists in the map without creating a KeyT
+     * @param key - the key to check if exist
+     * @return true if the key exists, false otherwise
+     */
+    template <class K, typename std::enable_if<_isTransparent<K>::value, int>::type = 0>
+    bool containsKey(const K& key) const
+    {
+        return find(key) != end();
+    }
+
+    /**
+     * @brief inserts a pair<key, ValueT(args...)> if the key doesn't exist, otherwise does nothing.
+     *        The key is hashed only once
+     * @param key - the key
+     * @param args - the arguments to construct the value with
+     * @return an iterator to the pair of the key, and true if the pair was inserted
+     */
+    template <class... Args>
+    std::pair<const_iterator, bool> try_emplace(const KeyT& key, Args&&... args)
+    {
+        size_t hash = _hashCode(key);
+        int index = _findSlot(key, hash);
+        if (index != -1)
+        {
+            return std::make_pair(const_iterator(this, index), false);
+        }
+
+        index = _prepareInsert(hash);
+        new (&_slots[index]) pair(std::piecewise_construct, std::forward_as_tuple(key),
+                                  std::forward_as_tuple(std::forward<Args>(args)...));
+        _ctrl[index] = (signed char)(hash & FLAT_H2_MASK);
+        _size++;
+        return std::make_pair(const_iterator(this, index), true);
+    }
+
+    /**
+     * @brief inserts the pair<key, value> if the key doesn't exist, otherwise overrides the value
+     *        of the key. The key is hashed only once
+     * @param key - the key
+     * @param value - the value
+     * @return an iterator to the pair of the key, and true if the pair was inserted
+     */
+    template <class M>
+    std::pair<const_iterator, bool> insert_or_assign(const KeyT& key, M&& value)
+    {
+        std::pair<const_iterator, bool> result = try_emplace(key, std::forward<M>(value));
+        if (!result.second)
+        {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    /**
+     * @brief constructs a pair from the arguments and inserts it if it's key doesn't exist
+     * @param args - the arguments to construct the pair with
+     * @return an iterator to the pair of the key, and true if the pair was inserted
+     */
+    template <class... Args>
+    std::pair<const_iterator, bool> emplace(Args&&... args)
+    {
+        pair newPair(std::forward<Args>(args)...);
+        size_t hash = _hashCode(newPair.first);
+        int index = _findSlot(newPair.first, hash);
+        if (index != -1)
+        {
+            return std::make_pair(const_iterator(this, index), false);
+        }
+
+        index = _prepareInsert(hash);
+        new (&_slots[index]) pair(std::move(newPair));
+        _ctrl[index] = (signed char)(hash & FLAT_H2_MASK);
+        _size++;
+        return std::make_pair(const_iterator(this, index), true);
+    }
+
+private:
+
+    // returns the index of the first full slot from the given index, or the capacity if none
+    int _nextFull(int index) const
+    {
+        while (index < _capacity && _ctrl[index] < 0)
+        {
+            index++;
+        }
+        return index;
+    }
+};
+
+template <class KeyT, class ValueT>
+size_t FlatHashMap<KeyT, ValueT>::_hashCode(const KeyT& key)
+{
+    return _mix(std::hash<KeyT>{}(key));
+}
+
+template <class KeyT, class ValueT>
+size_t FlatHashMap<KeyT, ValueT>::_mix(size_t hash)
+{
+    uint64_t mixed = (uint64_t)hash * FLAT_HASH_MULTIPLIER;
+    return (size_t)(mixed ^ (mixed >> FLAT_HASH_SHIFT));
+}
+
+template <class KeyT, class ValueT>
+unsigned int FlatHashMap<KeyT, ValueT>::_matchByte(const signed char* group, signed char byte)
+{
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(byte)));
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < FLAT_GROUP_WIDTH; i++)
+    {
+        mask |= (unsigned int)(group[i] == byte) << i;
+    }
+    return mask;
+#endif
+}
+
+template <class KeyT, class ValueT>
+unsigned int FlatHashMap<KeyT, ValueT>::_matchEmpty(const signed char* group)
+{
+    return _matchByte(group, FLAT_CTRL_EMPTY);
+}
+
+template <class KeyT, class ValueT>
+unsigned int FlatHashMap<KeyT, ValueT>::_matchFree(const signed char* group)
+{
+#ifdef __SSE2__
+    // empty and deleted are the only negative metadata bytes
+    return (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < FLAT_GROUP_WIDTH; i++)
+    {
+        mask |= (unsigned int)(group[i] < 0) << i;
+    }
+    return mask;
+#endif
+}
+
+template <class KeyT, class ValueT>
+template <class K>
+int FlatHashMap<KeyT, ValueT>::_findSlot(const K& key, size_t hash) const
+{
+    // A map without slots (a moved-from map) has no keys
+    if (_capacity == 0)
+    {
+        return -1;
+    }
+    signed char h2 = (signed char)(hash & FLAT_H2_MASK);
+    int groupMask = _capacity / FLAT_GROUP_WIDTH - 1;
+    int group = (int)(hash >> FLAT_H2_BITS) & groupMask;
+
+    // Goes over the groups in the probe sequence until a group with an empty slot is found
+    for (int step = 1; ; step++)
+    {
+        const signed char* ctrl = _ctrl + group * FLAT_GROUP_WIDTH;
+        for (unsigned int mask = _matchByte(ctrl, h2); mask != 0; mask &= mask - 1)
+        {
+            int index = group * FLAT_GROUP_WIDTH + __builtin_ctz(mask);
+            if (_slots[index].first == key)
+            {
+                return index;
+            }
+        }
+        if (_matchEmpty(ctrl) != 0)
+        {
+            return -1;
+        }
+        group = (group + step) & groupMask;
+    }
+}
+
+template <class KeyT, class ValueT>
+int FlatHashMap<KeyT, ValueT>::_findFreeSlot(size_t hash) const
+{
+    int groupMask = _capacity / FLAT_GROUP_WIDTH - 1;
+    int group = (int)(hash >> FLAT_H2_BITS) & groupMask;
+
+    for (int step = 1; ; step++)
+    {
+        unsigned int mask = _matchFree(_ctrl + group * FLAT_GROUP_WIDTH);
+        if (mask != 0)
+        {
+            return group * FLAT_GROUP_WIDTH + __builtin_ctz(mask);
+        }
+        group = (group + step) & groupMask;
+    }
+}
+
+template <class KeyT, class ValueT>
+int FlatHashMap<KeyT, ValueT>::_prepareInsert(size_t hash)
+{
+    // Keeps enough empty slots so every probe sequence ends, grows only if the table is full of
+    // alive pairs (and not of deleted ones)
+    int maxUsed = _capacity / FLAT_MAX_LOAD_DENOMINATOR * FLAT_MAX_LOAD_NUMERATOR;
+    if (_size + _tombstones + 1 > maxUsed)
+    {
+        bool mostlyDeleted = (_size + 1) * 2 <= maxUsed;
+        _rehash(std::max(FLAT_MIN_CAPACITY, mostlyDeleted ? _capacity : _capacity * 2));
+    }
+
+    int index = _findFreeSlot(hash);
+    if (_ctrl[index] == FLAT_CTRL_DELETED)
+    {
+        _tombstones--;
+    }
+    return index;
+}
+
+template <class KeyT, class ValueT>
+void FlatHashMap<KeyT, ValueT>::_allocate(int capacity)
+{
+    try
+    {
+        _ctrl = new signed char[capacity];
+        _slots = static_cast<pair*>(::operator new(sizeof(pair) * capacity));
+    }
+    catch (std::bad_alloc& e)
+    {
+        std::cout << "Bad alloc" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::memset(_ctrl, FLAT_CTRL_EMPTY, capacity);
+    _capacity = capacity;
+    _tombstones = 0;
+}
+
+template <class KeyT, class ValueT>
+void FlatHashMap<KeyT, ValueT>::_release() noexcept
+{
+    for (int i = 0; i < _capacity; i++)
+    {
+        if (_ctrl[i] >= 0)
+        {
+            _slots[i].~pair();
+        }
+    }
+    delete [] _ctrl;
+    ::operator delete(_slots);
+}
+
+template <class KeyT, class ValueT>
+void FlatHashMap<KeyT, ValueT>::_rehash(int newCapacity)
+{
+    signed char* oldCtrl = _ctrl;
+    pair* oldSlots = _slots;
+    int oldCapacity = _capacity;
+
+    _allocate(newCapacity);
+
+    // Moves every alive pair into it's slot in the new table
+    for (int i = 0; i < oldCapacity; i++)
+    {
+        if (oldCtrl[i] < 0)
+        {
+            continue;
+        }
+        size_t hash = _hashCode(oldSlots[i].first);
+        int index = _findFreeSlot(hash);
+        new (&_slots[index]) pair(std::move(oldSlots[i]));
+        _ctrl[index] = (signed char)(hash & FLAT_H2_MASK);
+        oldSlots[i].~pair();
+    }
+    delete [] oldCtrl;
+    ::operator delete(oldSlots);
+}
+
+template <class KeyT, class ValueT>
+FlatHashMap<KeyT, ValueT>::FlatHashMap(): _size(0), _capacity(0), _tombstones(0), _ctrl(nullptr),
+                                          _slots(nullptr)
+{
+    _allocate(FLAT_MIN_CAPACITY);
+}
+
+template <class KeyT, class ValueT>
+FlatHashMap<KeyT, ValueT>::FlatHashMap(const std::vector<KeyT>& keys,
+                                       const std::vector<ValueT>& values): FlatHashMap()
+{
+    // Checks if the size of the vectors are different, if yes, throws exception
+    if (keys.size() != values.size())
+    {
+        throw std::invalid_argument("Invalid args");
+    }
+
+    // Inserts the pairs into the hash map, a key that appears again overrides the value
+    for (int i = 0; i < (int)keys.size(); i++)
+    {
+        insert_or_assign(keys[i], values[i]);
+    }
+}
+
+template <class KeyT, class ValueT>
+FlatHashMap<KeyT, ValueT>::FlatHashMap(const FlatHashMap& other): _size(other._size),
+                                        _capacity(0), _tombstones(0), _ctrl(nullptr),
+                                        _slots(nullptr)
+{
+    _allocate(other._capacity);
+    if (other._capacity != 0)
+    {
+        std::memcpy(_ctrl, other._ctrl, other._capacity);
+    }
+    _tombstones = other._tombstones;
+
+    // Copies every alive pair into the same slot
+    for (int i = 0; i < _capacity; i++)
+    {
+        if (_ctrl[i] >= 0)
+        {
+            new (&_slots[i]) pair(other._slots[i]);
+        }
+    }
+}
+
+template <class KeyT, class ValueT>
+FlatHashMap<KeyT, ValueT>::FlatHashMap(FlatHashMap&& other) noexcept
+        : _size(other._size), _capacity(other._capacity), _tombstones(other._tombstones),
+          _ctrl(other._ctrl), _slots(other._slots)
+{
+    other._size = 0;
+    other._capacity = 0;
+    other._tombstones = 0;
+    other._ctrl = nullptr;
+    other._slots = nullptr;
+}
+
+template <class KeyT, class ValueT>
+void FlatHashMap<KeyT, ValueT>::_swap(FlatHashMap& other) noexcept
+{
+    std::swap(_size, other._size);
+    std::swap(_capacity, other._capacity);
+    std::swap(_tombstones, other._tombstones);
+    std::swap(_ctrl, other._ctrl);
+    std::swap(_slots, other._slots);
+}
+
+template <class KeyT, class ValueT>
+FlatHashMap<KeyT, ValueT>& FlatHashMap<KeyT, ValueT>::operator=(FlatHashMap&& other) noexcept
+{
+    _swap(other);
+    return *this;
+}
+
+template <class KeyT, class ValueT>
+FlatHashMap<KeyT, ValueT>::~FlatHashMap() noexcept
+{
+    _release();
+}
+
+template <class KeyT, class ValueT>
+bool FlatHashMap<KeyT, ValueT>::insert(const KeyT& key, const ValueT& value)
+{
+    // If the key already exists, returns false and doesn't insert the key
+    return try_emplace(key, value).second;
+}
+
+template <class KeyT, class ValueT>
+bool FlatHashMap<KeyT, ValueT>::containsKey(const KeyT& key) const
+{
+    return _findSlot(key, _hashCode(key)) != -1;
+}
+
+template <class KeyT, class ValueT>
+bool FlatHashMap<KeyT, ValueT>::empty() const
+{
+    return _size == 0;
+}
+
+template <class KeyT, class ValueT>
+int FlatHashMap<KeyT, ValueT>::size() const
+{
+    return _size;
+}
+
+template <class KeyT, class ValueT>
+int FlatHashMap<KeyT, ValueT>::capacity() const
+{
+    return _capacity;
+}
+
+template <class KeyT, class ValueT>
+ValueT& FlatHashMap<KeyT, ValueT>::at(const KeyT& key)
+{
+    int index = _findSlot(key, _hashCode(key));
+    if (index == -1)
+    {
+        throw std::invalid_argument("The key does not exist");
+    }
+    return _slots[index].second;
+}
+
+template <class KeyT, class ValueT>
+const ValueT& FlatHashMap<KeyT, ValueT>::at(const KeyT& key) const
+{
+    int index = _findSlot(key, _hashCode(key));
+    if (index == -1)
+    {
+        throw std::invalid_argument("The key does not exist");
+    }
+    return _slots[index].second;
+}
+
+template <class KeyT, class ValueT>
+double FlatHashMap<KeyT, ValueT>::getLoadFactor() const
+{
+    return (_capacity == 0) ? 0 : (double)_size / _capacity;
+}
+
+template <class KeyT, class ValueT>
+bool FlatHashMap<KeyT, ValueT>::erase(const KeyT& key)
+{
+    int index = _findSlot(key, _hashCode(key));
+    if (index == -1)
+    {
+        return false;
+    }
+
+    _slots[index].~pair();
+    _size--;
+
+    // If the group still has an empty slot no probe sequence went past it, so the slot can be
+    // empty again, otherwise it must stay a deleted slot
+    const signed char* group = _ctrl + index / FLAT_GROUP_WIDTH * FLAT_GROUP_WIDTH;
+    if (_matchEmpty(group) != 0)
+    {
+        _ctrl[index] = FLAT_CTRL_EMPTY;
+    }
+    else
+    {
+        _ctrl[index] = FLAT_CTRL_DELETED;
+        _tombstones++;
+    }
+    return true;
+}
+
+template <class KeyT, class ValueT>
+FlatHashMap<KeyT, ValueT>& FlatHashMap<KeyT, ValueT>::operator=(const FlatHashMap& other)
+{
+    // Check if other isn't this object
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    FlatHashMap copy(other);
+    _swap(copy);
+    return *this;
+}
+
+template <class KeyT, class ValueT>
+void FlatHashMap<KeyT, ValueT>::clear() noexcept
+{
+    for (int i = 0; i < _capacity; i++)
+    {
+        if (_ctrl[i] >= 0)
+        {
+            _slots[i].~pair();
+        }
+    }
+    if (_capacity != 0)
+    {
+        std::memset(_ctrl, FLAT_CTRL_EMPTY, _capacity);
+    }
+    _size = 0;
+    _tombstones = 0;
+}
+
+template <class KeyT, class ValueT>
+const ValueT FlatHashMap<KeyT, ValueT>::operator[](const KeyT& key) const noexcept
+{
+    int index = _findSlot(key, _hashCode(key));
+    return (index == -1) ? ValueT() : _slots[index].second;
+}
+
+template <class KeyT, class ValueT>
+ValueT& FlatHashMap<KeyT, ValueT>::operator[](const KeyT& key) noexcept
+{
+    // inserts a default value only if the key doesn't exist
+    return try_emplace(key).first->second;
+}
+
+template <class KeyT, class ValueT>
+bool FlatHashMap<KeyT, ValueT>::operator==(const FlatHashMap& other) const noexcept
+{
+    // Checks if the size is different
+    if (_size != other._size)
+    {
+        return false;
+    }
+
+    for (const_iterator it = begin(); it != end(); it++)
+    {
+        int index = other._findSlot(it->first, _hashCode(it->first));
+        if (index == -1 || !(other._slots[index].second == it->second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class KeyT, class ValueT>
+bool FlatHashMap<KeyT, ValueT>::operator!=(const FlatHashMap& other) const noexcept
+{
+    return !(this->operator==(other));
+}
+
+#endif //CPP_EX3_FLATHASHMAP_HPP
@@ -0,0 +1,201 @@
+/**
+* @file    FlatHashMapTest.cpp
+* @author  user
+* @version 1.0
+* @brief   Tests for FlatHashMap
+* @section runs a seeded random sequence of insert, insert_or_assign, try_emplace, erase,
+*          containsKey, at and operator[] on a FlatHashMap and on a std::unordered_map (the
+*          reference), with int keys and with std::string keys, and compares them (and their
+*          copies and moves) every few thousand operations. The keys are drawn from a large range
+*          first and from a small one after, so the map grows, fills with erased slots and shrinks
+*          back. Then checks the string_view lookups, the bulk constructor and the errors.
+*          Build: g++ -std=c++17 -O1 -g -fsanitize=address,undefined FlatHashMapTest.cpp
+*                 -o FlatHashMapTest
+*          Usage: FlatHashMapTest, exits with EXIT_FAILURE on the first failed check
+*/
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <unordered_map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include "FlatHashMap.hpp"
+#include "TestCheck.hpp"
+
+#define NUM_OF_SEEDS 2
+#define RANDOM_STEPS 200000
+#define WIDE_KEYS 5000
+#define NARROW_KEYS 300
+#define COMPARE_EVERY 20000
+#define CLEAR_EVERY 70000
+
+// ------------------------------------------- functions -------------------------------------------
+
+/**
+ * @brief makes the int key of a number
+ * @param number - the number
+ * @return the key
+ */
+static int intKey(int number)
+{
+    return number;
+}
+
+/**
+ * @brief makes the string key of a number
+ * @param number - the number
+ * @return the key
+ */
+static std::string stringKey(int number)
+{
+    return "key" + std::to_string(number);
+}
+
+/**
+ * @brief checks that a map has exactly the pairs of the reference, by lookups and by iteration
+ * @tparam KeyT - the type of the keys
+ * @param map - the map
+ * @param reference - the reference
+ */
+template <class KeyT>
+static void checkSame(const FlatHashMap<KeyT, int>& map,
+                      const std::unordered_map<KeyT, int>& reference)
+{
+    TEST_CHECK(map.size() == (int)reference.size());
+    TEST_CHECK(map.empty() == reference.empty());
+    for (const auto& item : reference)
+    {
+        TEST_CHECK(map.containsKey(item.first));
+        TEST_CHECK(map.at(item.first) == item.second);
+    }
+    int count = 0;
+    for (auto it = map.begin(); it != map.end(); ++it)
+    {
+        auto found = reference.find(it->first);
+        TEST_CHECK(found != reference.end() && found->second == it->second);
+        count++;
+    }
+    TEST_CHECK(count == (int)reference.size());
+}
+
+/**
+ * @brief compares random operations on a FlatHashMap with a std::unordered_map
+ * @tparam KeyT - the type of the keys
+ * @param seed - the seed of the operations
+ * @param makeKey - makes the key of a number
+ */
+template <class KeyT>
+static void testRandomOperations(unsigned int seed, KeyT (*makeKey)(int))
+{
+    std::mt19937 random(seed);
+    FlatHashMap<KeyT, int> map;
+    std::unordered_map<KeyT, int> reference;
+    for (int step = 0; step < RANDOM_STEPS; step++)
+    {
+        int range = (step < RANDOM_STEPS / 2) ? WIDE_KEYS : NARROW_KEYS;
+        KeyT key = makeKey((int)(random() % range));
+        int value = (int)random();
+        int operation = (int)(random() % 10);
+        if (operation < 3)
+        {
+            TEST_CHECK(map.insert(key, value) == reference.emplace(key, value).second);
+        }
+        else if (operation < 6)
+        {
+            TEST_CHECK(map.erase(key) == (reference.erase(key) > 0));
+        }
+        else if (operation < 7)
+        {
+            auto result = map.insert_or_assign(key, value);
+            TEST_CHECK(result.second == reference.insert_or_assign(key, value).second);
+            TEST_CHECK(result.first->second == value);
+        }
+        else if (operation < 8)
+        {
+            auto result = map.try_emplace(key, value);
+            auto expected = reference.try_emplace(key, value);
+            TEST_CHECK(result.second == expected.second);
+            TEST_CHECK(result.first->second == expected.first->second);
+        }
+        else if (operation < 9)
+        {
+            bool exists = reference.count(key) > 0;
+            TEST_CHECK(map.containsKey(key) == exists);
+            TEST_CHECK((map.find(key) != map.end()) == exists);
+        }
+        else
+        {
+            map[key] = value;
+            reference[key] = value;
+        }
+        TEST_CHECK(map.size() == (int)reference.size());
+
+        if (step % COMPARE_EVERY == 0)
+        {
+            checkSame(map, reference);
+            FlatHashMap<KeyT, int> copy(map);
+            TEST_CHECK(copy == map);
+            FlatHashMap<KeyT, int> moved(std::move(copy));
+            checkSame(moved, reference);
+            TEST_CHECK(copy.empty());
+            copy = moved;
+            checkSame(copy, reference);
+            moved = std::move(copy);
+            checkSame(moved, reference);
+        }
+        if (step % CLEAR_EVERY == CLEAR_EVERY - 1)
+        {
+            map.clear();
+            reference.clear();
+        }
+    }
+    checkSame(map, reference);
+}
+
+/**
+ * @brief checks the string_view lookups, the bulk constructor and the errors
+ */
+static void testConstructorsAndErrors()
+{
+    std::vector<std::string> keys{"a", "b", "a", ""};
+    std::vector<int> values{1, 2, 3, 4};
+    typedef FlatHashMap<std::string, int> StringMap;
+    StringMap built(keys, values);
+    TEST_CHECK(built.size() == 3 && built.at("a") == 3 && built.at("") == 4);
+    TEST_THROWS(StringMap(keys, std::vector<int>{1}), std::invalid_argument);
+    TEST_THROWS(built.at("zz"), std::invalid_argument);
+
+    std::string_view text("xbx");
+    TEST_CHECK(built.containsKey(text.substr(1, 1)));
+    TEST_CHECK(built.find(text.substr(1, 1))->second == 2);
+    TEST_CHECK(!built.containsKey(text.substr(0, 2)));
+
+    const StringMap& constant = built;
+    TEST_CHECK(constant["b"] == 2 && constant["missing"] == 0 && !constant.containsKey("missing"));
+    TEST_CHECK(built.emplace("c", 5).second && !built.emplace("c", 6).second);
+    TEST_CHECK(built.at("c") == 5);
+
+    StringMap other;
+    TEST_CHECK(other != built);
+    other = built;
+    TEST_CHECK(other == built);
+    TEST_CHECK(other.erase("c") && other != built);
+}
+
+/**
+ * @brief runs the tests of FlatHashMap
+ * @return EXIT_SUCCESS if all the checks passed
+ */
+int main()
+{
+    for (unsigned int seed = 0; seed < NUM_OF_SEEDS; seed++)
+    {
+        testRandomOperations<int>(seed, intKey);
+        testRandomOperations<std::string>(seed, stringKey);
+    }
+    testConstructorsAndErrors();
+    std::cout << "FlatHashMapTest: all checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -1,828 +1,2203 @@
-// HashMap.hpp
-
-#ifndef CPP_EX3_HASHMAP_HPP
-#define CPP_EX3_HASHMAP_HPP
-
-#define DEFAULT_SIZE 0
-#define DEFAULT_CAPACITY 16
-#define DEFAULT_LOWER_LOAD_FACTOR 0.25
-#define DEFAULT_HIGH_LOAD_FACTOR  0.75
-#define MIN_CAPACITY_SIZE 1
-
-// -------------------------------------- includes -------------------------------------------------
-
-#include <iostream>
-#include <list>
-#include <vector>
-#include <utility>
-#include <cassert>
-#include <cmath>
-#include <exception>
-#include <algorithm>
-
-// ------------------------------------------- function declaration --------------------------------
-
-template <class KeyT, class ValueT>
-
-/**
- * @brief a class that represents a template Hash Map
- * @tparam KeyT - the template parameter that represents the key
- * @tparam ValueT - the template parameter that represents the value
- */
-class HashMap
-{
-    typedef typename std::list<std::pair<KeyT, ValueT>>::iterator it;
-    typedef std::pair<KeyT, ValueT> pair;
-    typedef std::list<std::pair<KeyT, ValueT>> listPair;
-    typedef std::vector<std::pair<KeyT, ValueT>> vector;
-
-private:
-    int _size;                                    // saves the current size of the hash map
-    int _capacity;                                // saves the capacity of the hash map
-    std::list<std::pair<KeyT, ValueT>>* _listArr; // the array of linked lists
-
-    const double _lowerLoadFactor = DEFAULT_LOWER_LOAD_FACTOR;
-    const double _highLoadFactor  = DEFAULT_HIGH_LOAD_FACTOR;
-
-//-----------------------------------------private functions----------------------------------------
-
-    // Gets a key and calculates the hash code fot the key
-    int _hashCode(const KeyT& key) const;
-
-    // a private function to rehash the hash map
-    void _changeSize(int newSize);
-
-    // a private function that checks if the capacity should be decreased
-    void _checkIfDecrease();
-
-public:
-
-    /**
-     * @brief  a class that represents a const iterator that is used to iterate over the
-     * items in the hash map
-     */
-    class const_iterator
-    {
-    public:
-
-        typedef const_iterator self_type;
-        typedef std::pair<KeyT, ValueT> value_type;
-        typedef std::pair<KeyT, ValueT> &reference;
-        typedef std::pair<KeyT, ValueT> *pointer;
-        typedef std::forward_iterator_tag iterator_category;
-        typedef int difference_type;
-
-        /**
-         * @brief a constructor for const_iterator class
-         * @param thisMap - the HashMap object to iterate on
-         * @param iterator - an iterator of the first no empty list in the array of lists
-         */
-        explicit const_iterator(const HashMap * thisMap, typename listPair::iterator
-                                beginIterator, typename listPair::iterator endIterator, int i):
-                                _obj(thisMap), _iterator(beginIterator), _endIterator(endIterator),
-                                _index(i)
-        {
-        }
-
-        /**
-         * @brief returns the value that the iterator points at
-         * @return the current pair that the iterator iterates on
-         */
-        std::pair<KeyT, ValueT> &operator*()
-        {
-            return *_iterator;
-        }
-
-        /**
-         * @brief returns the value of the current pair (const)
-         * @return the current pair
-         */
-        const std::pair<KeyT, ValueT> &operator*() const
-        {
-            return *_iterator;
-        }
-
-        /**
-         * @brief returns the object that the iterator iterates on
-         * @return the object that the iterator iterates on
-         */
-        std::pair<KeyT, ValueT> *operator->()
-        {
-            return &*_iterator;
-        }
-
-        /**
-         * @brief returns the object that the iterator iterates on (const)
-         * @return the object that the iterator iterates on
-         */
-        const std::pair<KeyT, ValueT> *operator->() const
-        {
-            return &*_iterator;
-        }
-
-        /**
-         * @brief moves the iterator to the next object and returns the pointer to the next object
-         * @return the pointer to the next object in the hash map
-         */
-        const_iterator &operator++()
-        {
-            _iterator++;
-            _checkIfEnd();
-            return *this;
-        }
-
-        /**
-         * @brief returns the pointer to the current object and than moves the iterator to the
-         *        next object in the hash map
-         * @return the next object in the hash map
-         */
-        const_iterator operator++(int)
-        {
-            const_iterator temp = *this;
-            _iterator++;
-            _checkIfEnd();
-            return temp;
-        }
-
-        /**
-         * @brief Checks if two iterators are equal
-         * @param other - the other iterator
-         * @return true if the iterators are equal, false otherwise
-         */
-        bool operator==(const const_iterator &other) const
-        {
-            bool a = other._index    == this->_index;
-            bool b = other._iterator == this->_iterator;
-            return  a && b;
-        }
-
-        /**
-         * @brief Checks if two iterators are not equal
-         * @param other - the other iterator
-         * @return true if the iterators are not equal, false otherwise
-         */
-        bool operator!=(const const_iterator &other) const
-        {
-            return !(*this == other);
-        }
-
-    private:
-        const HashMap* _obj; // a pointer to the object of the HashMap
-        typename listPair::iterator _iterator;    // an iterator to iterate the current list
-        typename listPair::iterator _endIterator; // an iterator that saves the end of the curr list
-        int _index; // the current index in the array of linked lists
-
-        // Checks if we reached the end of the current list or the hash map
-        // if we reached the end of the current list - moves to the next list. if we reached the
-        // end of the hash map - changes the iterator to be the end iterator
-        void _checkIfEnd()
-        {
-            // Checks if we reached the end of the current list
-            if (_iterator == _endIterator)
-            {
-                // move to the next index in the array
-                _index++;
-
-                // while the current list is empty and we have not reached the end of the array
-                // searches for the next no-empty list
-                while ((_index < _obj->capacity()) && (_obj->_listArr[_index].empty()))
-                {
-                    _index++;
-                }
-
-                // ended the loop
-                // Checks if we reached the end of the array
-                if (_index >= _obj->capacity())
-                {
-                    // all fields become an "end" kind of iterator fields
-                    _index = _obj->capacity() - 1;
-                    _iterator = _obj->_listArr[_index].end();
-                    _endIterator = _obj->_listArr[_index].end();
-                }
-                else
-                {
-                    // saves the new begin iterator (over the new list)
-                    _iterator = _obj->_listArr[_index].begin();
-                    // saves the end iterator over the new list
-                    _endIterator = _obj->_listArr[_index].end();
-                }
-            }
-        }
-    }; // end of class const_iterator
-
-    /**
-     * @brief returns iterator to the begin of the hash map
-     * @return iterator to the begin of the hash map
-     */
-    const_iterator begin() const
-    {
-        // Checks if the hash map is empty
-        if (empty())
-        {
-            return this->end();
-        }
-
-        // Search the first no empty list in the array
-        for (int i = 0; i < _capacity; i++)
-        {
-            if (_listArr[i].empty())
-            {
-                continue;
-            }
-            else
-            {
-                return const_iterator(this, _listArr[i].begin(), _listArr[i].end(), i);
-            }
-        }
-        return const_iterator(this, _listArr[0].begin(), _listArr[0].end(), 0);
-    }
-
-    /**
-     * @brief returns an iterator to the end of the hash map
-     * @return an iterator to the end of the hash map
-     */
-    const_iterator end() const
-    {
-        int lastIndex = capacity() - 1;
-        return const_iterator(this, _listArr[lastIndex].end(), _listArr[lastIndex].end(), lastIndex);
-    }
-
-    /**
-     * @brief returns iterator to the begin of the hash map
-     * @return an iterator to the begin of the hash map
-     */
-    const_iterator cbegin() const
-    {
-        //Checks if the hash map is empty
-        if (empty())
-        {
-            return this->end();
-        }
-
-        // Search the first no empty list in the array
-        for (int i = 0; i < _capacity; i++)
-        {
-            if (_listArr[i].empty())
-            {
-                continue;
-            }
-            else
-            {
-                return const_iterator(this, _listArr[i].begin(), _listArr[i].end(), i);
-            }
-        }
-        return const_iterator(this, _listArr[0].begin(), _listArr[0].end(), 0);
-    }
-
-    /**
-     * @brief returns an iterator to the end of the hash map
-     * @return an iterator to the end of the hash map
-     */
-    const_iterator cend() const
-    {
-        int lastIndex = capacity() - 1;
-        return const_iterator(this, _listArr[lastIndex].end(), _listArr[lastIndex].end(), lastIndex);
-    }
-
-    /**
-     * @brief default constructor, initializes a hash map with default values
-     */
-    HashMap();
-
-    /**
-     * @brief a constructor for hash map, receives a vector of keys and a vector of values and
-     *        saves them into the hash map
-     * @param keys   - a vector that contains keys
-     * @param values - a vector that contains values
-     */
-    HashMap(const std::vector<KeyT>& keys, const std::vector<ValueT>& values);
-
-    /**
-     * @brief copy constructor for hash map
-     * @param other - the other map
-     */
-    HashMap(const HashMap& other);
-
-    /**
-     * @brief destructor for hash map
-     */
-    ~HashMap() noexcept;
-
-    /**
-     * @brief inserts a new pair<key, value> into the hash map
-     * @param key - the key to insert
-     * @param value - the value to insert
-     * @return true if the pair was inserted, false otherwise
-     */
-    bool insert(const KeyT& key, const ValueT& value);
-
-    /**
-     * @brief checks if the key exists in the map
-     * @param key - the key to check if exist
-     * @return true if the key exists, false otherwise
-     */
-    bool containsKey(const KeyT& key) const;
-
-    /**
-     * @brief returns true if the hash map is empty
-     * @return true if the hash map is empty, false otherwise
-     */
-    bool empty() const;
-
-    /**
-     * @brief returns the number size
-     * @return - the size of the hash map (number of elements in the hash map)
-     */
-    int size() const;
-
-    /**
-     * @brief returns the number capacity
-     * @return - the capacity of the hash map
-     */
-    int capacity() const;
-
-    /**
-     * @brief gets a key, checks if the key exists in the map, if yes, returns it's value
-     * @param key - the key
-     * @return - the value of the key
-     */
-    ValueT& at(const KeyT& key);
-
-    /**
-     * @brief gets a key, checks if the key exists in the map, if yes, returns it's value (const)
-     * @param key - the key
-     * @return - the value of the key (const)
-     */
-    const ValueT& at(const KeyT& key) const;
-
-    /**
-     * @brief return the load factor
-     * @return the load factor
-     */
-    double getLoadFactor() const;
-
-    /**
-     * @brief erases the value in the given key
-     * @param key - the key
-     * @return - true if the erase worked, false if the erase failed
-     */
-    bool erase(const KeyT& key);
-
-    /**
-     * @brief copies the values of the other hash map into the current hash map
-     * @param other - the other hash map
-     * @return - the current hash map object
-     */
-    HashMap& operator=(const HashMap& other);
-
-    /**
-     * @brief gets a key and returns the index of the bucket of the key
-     * @param key - the key
-     * @return - the index of the bucket
-     */
-    int bucketIndex(const KeyT& key) const;
-
-    /**
-     * @brief gets a key and returns the size of the bucket of the key
-     * @param key - the key
-     * @return - the size of the bucket of the key
-     */
-    int bucketSize(const KeyT& key) const;
-
-    /**
-     * @brief clears the map
-     */
-    void clear() noexcept;
-
-    /**
-     * @brief returns the value in the key int the map (const)
-     * @param key - the key
-     * @return - the value of the key
-     */
-    const ValueT operator[](const KeyT& key) const noexcept;
-
-    /**
-     * @brief returns the value in the key int the map (const)
-     * @param key- the key
-     * @return - the value of the key
-     */
-    ValueT& operator[](const KeyT& key) noexcept;
-
-    /**
-     * @brief Checks if the current map equals other map
-     * @param other - the other hash map
-     * @return true if the maps are equal, false otherwise
-     */
-    bool operator==(const HashMap& other) const noexcept ;
-
-    /**
-     * @brief Checks if the current map not equals other map
-     * @param other - the other hash map
-     * @return true if the maps are not equal, false otherwise
-     */
-    bool operator!=(const HashMap& other) const noexcept ;
-};
-
-template <class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::operator!=(const HashMap &other) const noexcept
-{
-    return (!(this->operator==(other)));
-}
-
-template <class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::operator==(const HashMap &other) const noexcept
-{
-    // Checks if the size is different
-    if (_size != other.size())
-    {
-        return false;
-    }
-
-    if (empty() && other.empty())
-    {
-        return true;
-    }
-
-    for (HashMap::const_iterator it = begin(); it != end(); it++)
-    {
-        KeyT currKey = it.operator*().first;
-
-        if (this->operator[](currKey) != other.operator[](currKey))
-        {
-            return false;
-        }
-    }
-    return true;
-}
-
-
-template <class KeyT, class ValueT>
-const ValueT HashMap<KeyT, ValueT>::operator[](const KeyT &key) const noexcept
-{
-    // check if the key exists
-    if (containsKey(key))
-    {
-        for (HashMap::const_iterator it = begin(); it != end(); it++)
-        {
-            if (it->first == key)
-            {
-                return it->second;
-            }
-        }
-    }
-    return ValueT();
-}
-
-template <class KeyT, class ValueT>
-ValueT& HashMap<KeyT, ValueT>::operator[](const KeyT &key) noexcept
-{
-    // check if the key exists
-    if (containsKey(key))
-    {
-        for (HashMap::const_iterator it = begin(); it != end(); it++)
-        {
-            if (it.operator*().first == key)
-            {
-                return it.operator*().second;
-            }
-        }
-    }
-
-    insert(key, ValueT());
-    return this->at(key);
-}
-
-
-template <class KeyT, class ValueT>
-void HashMap<KeyT, ValueT>::clear() noexcept
-{
-    if (!empty())
-    {
-        for (int i = 0; i < capacity(); i++)
-        {
-            _listArr[i].clear();
-        }
-    }
-    _size = 0;
-}
-
-template <class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::bucketSize(const KeyT &key) const
-{
-    // Checks if the key exists in the map
-    if (!containsKey(key))
-    {
-        throw std::out_of_range("Out of range");
-    }
-
-    int index = bucketIndex(key); // Gets the index of the key
-
-    int sizeOfList = _listArr[index].size();
-
-    return sizeOfList;
-}
-
-template <class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::bucketIndex(const KeyT &key) const
-{
-    // Checks if the key exists in the map
-    if (!containsKey(key))
-    {
-        throw std::out_of_range("Out of range");
-    }
-
-    int hash = _hashCode(key);
-
-    return hash;
-}
-
-template <class KeyT, class ValueT>
-HashMap<KeyT, ValueT>::~HashMap() noexcept
-{
-    delete [] _listArr;
-}
-
-template <class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::erase(const KeyT &key)
-{
-    if (empty())
-    {
-        return false;
-    }
-
-    if (!containsKey(key))
-    {
-        return false;
-    }
-
-    int hash = _hashCode(key);
-
-    for (typename listPair::iterator it = _listArr[hash].begin(); it !=_listArr[hash].end(); it++)
-    {
-        if (it.operator*().first == key)
-        {
-            _listArr[hash].erase(it);
-            _size--;
-            _checkIfDecrease();
-            return true;
-        }
-    }
-    return false;
-}
-
-template <class KeyT, class ValueT>
-HashMap<KeyT, ValueT>::HashMap():_size(DEFAULT_SIZE), _capacity(DEFAULT_CAPACITY)
-{
-    try
-    {
-        _listArr = new std::list<std::pair<KeyT, ValueT>>[_capacity];
-    }
-    catch (std::bad_alloc& e)
-    {
-        std::cout << "Bad alloc" << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
-    // Goes over the array and initializes lists with default constructor
-    for (int i = 0; i < _capacity; i++)
-    {
-        _listArr[i] = std::list<std::pair<KeyT, ValueT>>();
-    }
-}
-
-template <class KeyT, class ValueT>
-HashMap<KeyT, ValueT>::HashMap(const std::vector<KeyT> &keys, const std::vector<ValueT>& values)
-        :HashMap()
-{
-    // Checks if the size of the vectors are different, if yes, throws exception
-    if (keys.size() != values.size())
-    {
-        throw std::invalid_argument("Invalid args");
-    }
-
-    // Inserts the pairs into the hash map
-    for (int i = 0; i < (int)keys.size(); i++)
-    {
-        // Checks if the key exists, if yes, overrides the value
-        if (containsKey(keys[i]))
-        {
-            // If the key exists, overrides the value of the key
-            // the key will not be inserted again
-            at(keys[i]) = values[i];
-        }
-        else
-        {
-            // If the key doesn't exist, inserts the key and the value into the hash map
-            insert(keys[i], values[i]);
-
-        }
-    }
-}
-
-template <class KeyT, class ValueT>
-HashMap<KeyT, ValueT>::HashMap(const HashMap& other):_size(other.size()), _capacity(other.capacity())
-{
-    try
-    {
-        _listArr = new std::list<std::pair<KeyT, ValueT>>[_capacity];
-    }
-    catch (std::bad_alloc& e)
-    {
-        std::cout << "Bad alloc" << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
-    // Goes over the array and initializes lists with default constructor
-    for (int i = 0; i < _capacity; i++)
-    {
-        _listArr[i] = other._listArr[i];
-    }
-}
-
-template <class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::insert(const KeyT& key, const ValueT& value)
-{
-    // If the key already exists, returns false and doesn't insert the key
-    if (containsKey(key))
-    {
-        return false;
-    }
-
-    if (((double) (size() + 1) / capacity()) > _highLoadFactor)
-    {
-        _changeSize(_capacity * 2);
-    }
-    int index = _hashCode(key);
-
-    pair pairToInsert(key, value);
-
-    _listArr[index].push_back(pairToInsert);
-
-    _size++; // Increase the number of pairs in the hash map
-
-    return true;
-}
-
-template <class KeyT, class ValueT>
-void HashMap<KeyT, ValueT>::_checkIfDecrease()
-{
-    double loadFactor = getLoadFactor();
-
-    if (_capacity >= MIN_CAPACITY_SIZE)
-    {
-        if (loadFactor < _lowerLoadFactor)
-        {
-            int newSize = _capacity / 2;
-            _changeSize(newSize);
-        }
-    }
-}
-
-template <class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::empty() const
-{
-    return _size == DEFAULT_SIZE;
-}
-
-template <class KeyT, class ValueT>
-void HashMap<KeyT, ValueT>::_changeSize(int newSize)
-{
-    auto temp = new listPair[newSize];
-
-    // for each value calculate the new hash value
-    // insert each value into temp
-    for (int j = 0; j < capacity(); ++j)
-    {
-        for (const auto &p: _listArr[j])
-        {
-            int index = std::hash<KeyT>{}(p.first) & (newSize - 1);
-            temp[index].push_back(p);
-        }
-    }
-    delete[] _listArr;
-
-   _listArr = new listPair[newSize];
-
-    for (int i = 0; i < newSize; ++i)
-    {
-        _listArr[i] = temp[i];
-    }
-    _capacity = newSize;
-    delete [] temp;
-
-}
-
-template <class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::containsKey(const KeyT& key) const
-{
-    int index = _hashCode(key); // Gets the hash value of the key
-
-    // Checks if the list in the hash index is empty
-    if (_listArr[index].size() == 0)
-    {
-        return false;
-    }
-
-    // Search the key in the according list (the list in the index calculated by the hash function)
-    for (const auto& it  : _listArr[index])
-    {
-        // Checks if the key of the current pair equals key
-        if (it.first == key)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-template <class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::_hashCode(const KeyT& key) const
-{
-    int result = std::hash<KeyT>{}(key) & (_capacity - 1);
-    return result;
-}
-
-template <class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::size() const
-{
-    return _size;
-}
-
-template <class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::capacity() const
-{
-    return _capacity;
-}
-
-template <class KeyT, class ValueT>
-ValueT & HashMap<KeyT, ValueT>::at(const KeyT& key)
-{
-    int index = _hashCode(key);
-
-    // Goes over the list in the hash index, searches for the key and returns the value of the key
-    // when found
-    for (auto it = _listArr[index].begin(); it != _listArr[index].end(); ++it)
-    {
-        if (it->first == key)
-        {
-            return it->second;
-        }
-    }
-    throw std::invalid_argument("The key does not exist");
-}
-
-
-template <class KeyT, class ValueT>
-const ValueT& HashMap<KeyT, ValueT>::at(const KeyT& key) const
-{
-    int index = _hashCode(key);
-
-    // Goes over the list in the hash index, searches for the key and returns the value of the key
-    // when found
-    for (auto it = _listArr[index].begin(); it != _listArr[index].end(); ++it)
-    {
-        if (it->first == key)
-        {
-            return it->second;
-        }
-    }
-    throw std::invalid_argument("The key does not exist");
-}
-
-template <class KeyT, class ValueT>
-double HashMap<KeyT, ValueT>::getLoadFactor() const
-{
-    double a = (double)_size / _capacity;
-    return a;
-}
-
-template <class KeyT, class ValueT>
-HashMap<KeyT, ValueT>& HashMap<KeyT, ValueT>::operator=(const HashMap& other)
-{
-    // Check if other isn't this object
-    if (this == &other)
-    {
-        return *this;
-    }
-
-    delete [] _listArr;
-
-    try
-    {
-        _listArr = new std::list<std::pair<KeyT, ValueT>>[_capacity];
-    }
-    catch (std::bad_alloc& e)
-    {
-        std::cout << "Bad alloc" << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
-    // Goes over the items in the other map and copies them into the current map
-    for(pair p: other)
-    {
-        this->insert(p.first, p.second);
-    }
-    return *this;
-}
-
+// HashMap.hpp
+
+#ifndef CPP_EX3_HASHMAP_HPP
+#define CPP_EX3_HASHMAP_HPP
+
+#define DEFAULT_SIZE 0
+#define DEFAULT_CAPACITY 16
+#define DEFAULT_LOWER_LOAD_FACTOR 0.25
+#define DEFAULT_HIGH_LOAD_FACTOR  0.75
+#define MIN_CAPACITY_SIZE 1
+#define PARALLEL_BUILD_MIN_SIZE 100000
+#define LIST_NODE_LINKS 2
+#define FILTER_BITS_PER_BUCKET 8
+
+// Compile with -DHASHMAP_STATS to count the rehashes of every map and the time they take (see
+// HashMap::stats). Without it the counters are not compiled in and are reported as 0
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <iostream>
+#include <list>
+#include <vector>
+#include <utility>
+#include <cassert>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <memory>
+#include <memory_resource>
+#include <chrono>
+#include <thread>
+#include "FastHash.hpp"
+#include "BloomFilter.hpp"
+#include "OccupancyBitmap.hpp"
+
+// ------------------------------------------- function declaration --------------------------------
+
+/**
+ * @brief statistics of a HashMap, to find hash functions that put many keys into the same buckets
+ *        and maps that grow and shrink over and over
+ */
+struct HashMapStats
+{
+    int size;                      // the number of pairs
+    int buckets;                   // the number of buckets (of both arrays, while migrating)
+    double loadFactor;             // the number of pairs per bucket of the current array
+    std::vector<int> chainLengths; // chainLengths[n] is the number of buckets with n pairs
+    int longestChain;              // the number of pairs in the longest bucket
+    long long growRehashes;        // the rehashes into more buckets (HASHMAP_STATS only)
+    long long shrinkRehashes;      // the rehashes into less buckets (HASHMAP_STATS only)
+    long long rehashNanos;         // the time spent moving nodes between arrays (HASHMAP_STATS)
+    size_t bucketBytes;            // the bytes of the arrays of lists (and of their bitmaps)
+    size_t nodeBytes;              // the bytes of the list nodes (with the pairs in them)
+    size_t keyBytes;               // the bytes the keys allocated outside their nodes (strings)
+    size_t filterBytes;            // the bytes of the membership filter (0 if it is off)
+};
+
+/**
+ * @brief prints the statistics of a map in a few lines
+ * @param os - the stream to print to
+ * @param stats - the statistics
+ * @return the stream
+ */
+inline std::ostream& operator<<(std::ostream& os, const HashMapStats& stats)
+{
+    os << "size " << stats.size << ", buckets " << stats.buckets << ", load factor "
+       << stats.loadFactor << ", longest chain " << stats.longestChain << std::endl;
+    os << "chain lengths (length:buckets):";
+    for (size_t length = 0; length < stats.chainLengths.size(); length++)
+    {
+        if (stats.chainLengths[length] > 0)
+        {
+            os << " " << length << ":" << stats.chainLengths[length];
+        }
+    }
+    os << std::endl;
+    os << "rehashes: " << stats.growRehashes << " grow, " << stats.shrinkRehashes << " shrink, "
+       << (double)stats.rehashNanos / 1e6 << " ms" << std::endl;
+    os << "bytes: " << stats.bucketBytes << " buckets, " << stats.nodeBytes << " nodes, "
+       << stats.keyBytes << " keys, " << stats.filterBytes << " filter" << std::endl;
+    return os;
+}
+
+template <class KeyT, class ValueT, class Hash = FastHash<KeyT>,
+          class KeyEqual = std::equal_to<KeyT>,
+          class Alloc = std::allocator<std::pair<KeyT, ValueT>>>
+
+/**
+ * @brief a class that represents a template Hash Map
+ * @tparam KeyT - the template parameter that represents the key
+ * @tparam ValueT - the template parameter that represents the value
+ * @tparam Hash - the hash of the keys. The bucket of a key is picked by the low bits of it's
+ *                hash, so the hash should mix all the bits of the key into the low bits (the
+ *                default FastHash does)
+ * @tparam KeyEqual - compares two keys, keys that are equal must have the same hash
+ * @tparam Alloc - the allocator of the pairs. The list nodes and the arrays of lists are both
+ *                 allocated with it (rebound), so with an arena (see PmrHashMap) a whole map lives
+ *                 in one region
+ */
+class HashMap
+{
+    typedef std::pair<KeyT, ValueT> pair;
+
+    // a node of a list: the pair and the full hash value of it's key, so a resize doesn't hash
+    // the keys again and a lookup compares the keys only if their hashes are equal
+    struct Node
+    {
+        pair item;   // the pair
+        size_t hash; // the full hash value of the key
+
+        template <class... Args>
+        explicit Node(size_t keyHash, Args&&... args) : item(std::forward<Args>(args)...),
+                                                        hash(keyHash)
+        {
+        }
+    };
+
+    typedef std::allocator_traits<Alloc> allocTraits;
+    typedef typename allocTraits::template rebind_alloc<Node> nodeAlloc;
+    typedef std::list<Node, nodeAlloc> listPair;
+    typedef typename listPair::iterator it;
+    typedef std::vector<std::pair<KeyT, ValueT>> vector;
+    typedef typename allocTraits::template rebind_alloc<listPair> bucketAlloc;
+    typedef std::allocator_traits<bucketAlloc> bucketAllocTraits;
+    typedef typename allocTraits::template rebind_alloc<uint64_t> wordAlloc;
+
+private:
+    int _size;                                    // saves the current size of the hash map
+    int _capacity;                                // saves the capacity of the hash map
+    listPair* _listArr;                           // the array of linked lists
+    Alloc _allocator;                             // allocates the nodes and the arrays of lists
+    Hash _hasher;                                 // hashes the keys
+    KeyEqual _keyEqual;                           // compares the keys
+
+    bool _incrementalRehash;  // true if a resize migrates the buckets a few at a time
+    listPair* _oldListArr;    // the array that is migrated into _listArr, or nullptr
+    int _oldCapacity;         // saves the capacity of the array that is migrated
+    int _migrated;            // the number of buckets of the old array that were migrated
+
+    bool _useFilter;                     // true if lookups check the membership filter first
+    BloomFilter<wordAlloc> _filter;      // the hashes of all the keys (and of erased keys)
+    BloomFilter<wordAlloc> _nextFilter;  // the hashes of the migrated keys, while migrating
+
+    OccupancyBitmap<wordAlloc> _occupied;    // the buckets of _listArr that are not empty
+    OccupancyBitmap<wordAlloc> _oldOccupied; // the buckets of _oldListArr that are not empty
+    int _firstBucket;  // the number of the first bucket that is not empty, past the last if none
+
+    const double _lowerLoadFactor = DEFAULT_LOWER_LOAD_FACTOR;
+    const double _highLoadFactor  = DEFAULT_HIGH_LOAD_FACTOR;
+
+#ifdef HASHMAP_STATS
+    long long _growRehashes = 0;   // the number of rehashes into more buckets
+    long long _shrinkRehashes = 0; // the number of rehashes into less buckets
+    long long _rehashNanos = 0;    // the time spent moving nodes between arrays
+#endif
+
+//-----------------------------------------private functions----------------------------------------
+
+    // Gets a key and calculates the hash code fot the key
+    int _hashCode(const KeyT& key) const;
+
+    // Gets a key and calculates it's full hash value (before it is reduced to a bucket index)
+    size_t _hashOf(const KeyT& key) const;
+
+    // Gets a string-like key (std::string_view, const char*) and calculates the same full hash
+    // value that the equal std::string key has
+    template <class K>
+    size_t _hashOf(const K& key) const;
+
+    // Checks if a key of the map equals a key (a KeyT, or a string-like key), std::equal_to is
+    // replaced by == so a std::string is compared with a std::string_view without a copy
+    template <class K>
+    bool _keysEqual(const KeyT& key, const K& other) const
+    {
+        if constexpr (std::is_same<KeyEqual, std::equal_to<KeyT>>::value)
+        {
+            return key == other;
+        }
+        else
+        {
+            return _keyEqual(key, other);
+        }
+    }
+
+    // returns the arguments of a T (the key or the value of a new pair) as a tuple. If T
+    // allocates with the allocator of the map (a std::pmr::string in an arena), the allocator is
+    // added to the arguments, so T allocates from the same arena as it's node
+    template <class T, class... Args>
+    auto _withAllocator(Args&&... args) const
+    {
+        if constexpr (!allocTraits::is_always_equal::value &&
+                      std::uses_allocator<T, Alloc>::value &&
+                      std::is_constructible<T, Args..., const Alloc&>::value)
+        {
+            return std::tuple<Args&&..., const Alloc&>(std::forward<Args>(args)..., _allocator);
+        }
+        else
+        {
+            return std::forward_as_tuple(std::forward<Args>(args)...);
+        }
+    }
+
+    // constructs a node of the pair in the list, with the hash of it's key
+    template <class K, class V>
+    void _appendNode(listPair& list, size_t hash, K&& key, V&& value)
+    {
+        list.emplace_back(hash, std::piecewise_construct,
+                          _withAllocator<KeyT>(std::forward<K>(key)),
+                          _withAllocator<ValueT>(std::forward<V>(value)));
+    }
+
+    // Gets a full hash value and returns the index of it's bucket
+    int _indexOf(size_t hash) const;
+
+    // inserts the pairs of the vectors (moved out of them if Move) into an empty map that is sized
+    // for all of them first. A later value of a key overrides an earlier one
+    template <bool Move, class Keys, class Values>
+    void _bulkInsert(Keys& keys, Values& values);
+
+    // inserts the pairs of the keys whose buckets are in [first, last), returns the number of
+    // pairs that were inserted. Maps with a stateless allocator insert into separate ranges of
+    // buckets on separate threads
+    template <bool Move, class Keys, class Values>
+    int _bulkInsertBuckets(Keys& keys, Values& values, const std::vector<size_t>& hashes,
+                           int first, int last);
+
+    // Gets the list with the new node and inserts it into the bucket of the hash, returns the
+    // index of the bucket
+    int _insertNode(size_t hash, listPair& node);
+
+    // inserts a pair<key, ValueT(args...)> if the key doesn't exist, the key is copied or moved
+    // into the new node
+    template <class K, class... Args>
+    std::pair<typename HashMap::const_iterator, bool> _tryEmplace(K&& key, Args&&... args);
+
+    // exchanges the contents of the two maps
+    void _swap(HashMap& other) noexcept;
+
+    // Checks if K can be used to look up a key without converting it to KeyT: the hash must
+    // take a std::string_view (and give it the hash of the equal std::string), and the keys must
+    // be comparable with a std::string_view
+    template <class K>
+    using _isTransparent = std::integral_constant<bool,
+            std::is_same<KeyT, std::string>::value &&
+            !std::is_same<typename std::decay<K>::type, KeyT>::value &&
+            std::is_convertible<const K&, std::string_view>::value &&
+            std::is_invocable_r<size_t, const Hash&, std::string_view>::value &&
+            (std::is_same<KeyEqual, std::equal_to<KeyT>>::value ||
+             std::is_invocable_r<bool, const KeyEqual&, const KeyT&, std::string_view>::value)>;
+
+    // a private function to rehash the hash map
+    void _changeSize(int newSize);
+
+    // a private function that checks if the capacity should be decreased
+    void _checkIfDecrease();
+
+    // migrates the next buckets of the old array into the new array, enough of them that the
+    // migration ends before the next resize can start
+    void _rehashStep();
+
+    // migrates all the buckets that are left in the old array into the new array
+    void _finishRehash();
+
+    // sizes the membership filter for the current capacity and adds the hashes of all the keys
+    void _rebuildFilter();
+
+    // adds the hash of a new key to the membership filter (and to the filter of the new array,
+    // while migrating)
+    void _addToFilter(size_t hash)
+    {
+        if (_useFilter)
+        {
+            _filter.add(hash);
+            if (_nextFilter.isSized())
+            {
+                _nextFilter.add(hash);
+            }
+        }
+    }
+
+    // returns the list of the bucket with the given number. While the map is migrated, the
+    // buckets of the old array are numbered after the buckets of the new array
+    listPair& _bucket(int number) const
+    {
+        return (number < _capacity) ? _listArr[number] : _oldListArr[number - _capacity];
+    }
+
+    // Checks if the list of the bucket is constructed. While the map is migrated, a list in the
+    // new array is constructed when the first old bucket that moves into it is migrated, and a
+    // list in the old array is destroyed when it is migrated
+    bool _isLive(int number) const
+    {
+        if (_oldListArr == nullptr)
+        {
+            return true;
+        }
+        if (number < _capacity)
+        {
+            return (number & (_oldCapacity - 1)) < _migrated;
+        }
+        return number - _capacity >= _migrated;
+    }
+
+    // Checks if the bucket with the given number has no pairs
+    bool _isBucketEmpty(int number) const
+    {
+        return !_isLive(number) || _bucket(number).empty();
+    }
+
+    // returns the number of the first bucket from the given number on that is not empty, or
+    // _bucketCount() if they are all empty
+    int _nextOccupied(int number) const
+    {
+        if (number < _capacity)
+        {
+            int next = (int)_occupied.next((size_t)number);
+            if (next < _capacity)
+            {
+                return next;
+            }
+            number = _capacity;
+        }
+        return _capacity + (int)_oldOccupied.next((size_t)(number - _capacity));
+    }
+
+    // marks the bucket with the given number as not empty
+    void _markOccupied(int number)
+    {
+        if (number < _capacity)
+        {
+            _occupied.set((size_t)number);
+        }
+        else
+        {
+            _oldOccupied.set((size_t)(number - _capacity));
+        }
+        _firstBucket = std::min(_firstBucket, number);
+    }
+
+    // marks the bucket with the given number as empty
+    void _markEmpty(int number)
+    {
+        if (number < _capacity)
+        {
+            _occupied.unset((size_t)number);
+        }
+        else
+        {
+            _oldOccupied.unset((size_t)(number - _capacity));
+        }
+        if (number == _firstBucket)
+        {
+            _firstBucket = _nextOccupied(number + 1);
+        }
+    }
+
+    // marks the buckets of both arrays by their lists, and finds the first bucket that is not
+    // empty
+    void _rebuildOccupancy();
+
+    // gives a map that has no buckets (a moved-from map) an array of the default capacity
+    void _ensureBuckets();
+
+    // allocates an array of lists without constructing the lists
+    listPair* _allocateBuckets(int count);
+
+    // frees an array of lists without destroying the lists
+    void _freeBuckets(listPair* buckets, int count) noexcept;
+
+    // constructs an empty list (that allocates it's nodes with the allocator of the map)
+    void _constructBucket(listPair* bucket)
+    {
+        new (bucket) listPair(_allocator);
+    }
+
+    // allocates an array of empty lists
+    listPair* _newBuckets(int count);
+
+    // destroys all the lists of an array and frees it
+    void _deleteBuckets(listPair* buckets, int count) noexcept;
+
+    // checks if the pairs of the other map can be taken as they are: the nodes of both maps can
+    // be freed by the allocator of this map
+    bool _canTakeNodesOf(const HashMap& other) const
+    {
+        return allocTraits::is_always_equal::value || _allocator == other._allocator;
+    }
+
+    // returns the number of buckets (in both arrays, while the map is migrated)
+    int _bucketCount() const
+    {
+        return _capacity + _oldCapacity;
+    }
+
+    // Gets a full hash value and returns the number of the bucket that a key with this hash is
+    // saved in (the old array, if the bucket of the key was not migrated yet)
+    int _bucketNumberOf(size_t hash) const;
+
+    // returns the number of bytes that a key allocated outside of it's node
+    template <class K>
+    static size_t _keyBytes(const K&)
+    {
+        return 0;
+    }
+
+    // returns the number of bytes that a string key allocated outside of it's node, a short
+    // string is saved inside the string object (and so inside the node)
+    template <class C, class Traits, class A>
+    static size_t _keyBytes(const std::basic_string<C, Traits, A>& key)
+    {
+        static const size_t inPlace = std::basic_string<C, Traits, A>().capacity();
+        return (key.capacity() > inPlace) ? (key.capacity() + 1) * sizeof(C) : 0;
+    }
+
+#ifdef HASHMAP_STATS
+    // adds the time since start to the time spent rehashing
+    void _addRehashTime(std::chrono::steady_clock::time_point start)
+    {
+        _rehashNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+    }
+#endif
+
+public:
+
+    /**
+     * @brief  a class that represents a const iterator that is used to iterate over the
+     * items in the hash map
+     */
+    class const_iterator
+    {
+    public:
+
+        typedef const_iterator self_type;
+        typedef std::pair<KeyT, ValueT> value_type;
+        typedef std::pair<KeyT, ValueT> &reference;
+        typedef std::pair<KeyT, ValueT> *pointer;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int difference_type;
+
+        /**
+         * @brief a constructor for const_iterator class
+         * @param thisMap - the HashMap object to iterate on
+         * @param iterator - an iterator of the first no empty list in the array of lists
+         */
+        explicit const_iterator(const HashMap * thisMap, typename listPair::iterator
+                                beginIterator, typename listPair::iterator endIterator, int i):
+                                _obj(thisMap), _iterator(beginIterator), _endIterator(endIterator),
+                                _index(i)
+        {
+        }
+
+        /**
+         * @brief returns the value that the iterator points at
+         * @return the current pair that the iterator iterates on
+         */
+        std::pair<KeyT, ValueT> &operator*()
+        {
+            return _iterator->item;
+        }
+
+        /**
+         * @brief returns the value of the current pair (const)
+         * @return the current pair
+         */
+        const std::pair<KeyT, ValueT> &operator*() const
+        {
+            return _iterator->item;
+        }
+
+        /**
+         * @brief returns the object that the iterator iterates on
+         * @return the object that the iterator iterates on
+         */
+        std::pair<KeyT, ValueT> *operator->()
+        {
+            return &_iterator->item;
+        }
+
+        /**
+         * @brief returns the object that the iterator iterates on (const)
+         * @return the object that the iterator iterates on
+         */
+        const std::pair<KeyT, ValueT> *operator->() const
+        {
+            return &_iterator->item;
+        }
+
+        /**
+         * @brief moves the iterator to the next object and returns the pointer to the next object
+         * @return the pointer to the next object in the hash map
+         */
+        const_iterator &operator++()
+        {
+            _iterator++;
+            _checkIfEnd();
+            return *this;
+        }
+
+        /**
+         * @brief returns the pointer to the current object and than moves the iterator to the
+         *        next object in the hash map
+         * @return the next object in the hash map
+         */
+        const_iterator operator++(int)
+        {
+            const_iterator temp = *this;
+            _iterator++;
+            _checkIfEnd();
+            return temp;
+        }
+
+        /**
+         * @brief Checks if two iterators are equal
+         * @param other - the other iterator
+         * @return true if the iterators are equal, false otherwise
+         */
+        bool operator==(const const_iterator &other) const
+        {
+            bool a = other._index    == this->_index;
+            bool b = other._iterator == this->_iterator;
+            return  a && b;
+        }
+
+        /**
+         * @brief Checks if two iterators are not equal
+         * @param other - the other iterator
+         * @return true if the iterators are not equal, false otherwise
+         */
+        bool operator!=(const const_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        const HashMap* _obj; // a pointer to the object of the HashMap
+        typename listPair::iterator _iterator;    // an iterator to iterate the current list
+        typename listPair::iterator _endIterator; // an iterator that saves the end of the curr list
+        int _index; // the current index in the array of linked lists
+
+        // Checks if we reached the end of the current list or the hash map
+        // if we reached the end of the current list - moves to the next list. if we reached the
+        // end of the hash map - changes the iterator to be the end iterator
+        void _checkIfEnd()
+        {
+            // Checks if we reached the end of the current list
+            if (_iterator == _endIterator)
+            {
+                // moves to the next no-empty list, the empty lists are skipped by the bitmaps
+                // of the buckets without reading them
+                _index = _obj->_nextOccupied(_index + 1);
+
+                // ended the loop
+                // Checks if we reached the end of the array
+                if (_index >= _obj->_bucketCount())
+                {
+                    // all fields become an "end" kind of iterator fields
+                    _index = _obj->_bucketCount() - 1;
+                    _iterator = _obj->_bucket(_index).end();
+                    _endIterator = _obj->_bucket(_index).end();
+                }
+                else
+                {
+                    // saves the new begin iterator (over the new list)
+                    _iterator = _obj->_bucket(_index).begin();
+                    // saves the end iterator over the new list
+                    _endIterator = _obj->_bucket(_index).end();
+                }
+            }
+        }
+    }; // end of class const_iterator
+
+    /**
+     * @brief returns iterator to the begin of the hash map
+     * @return iterator to the begin of the hash map
+     */
+    const_iterator begin() const
+    {
+        // Checks if the hash map is empty
+        if (empty())
+        {
+            return this->end();
+        }
+
+        // The first no empty list is kept up to date by every change of the buckets
+        return const_iterator(this, _bucket(_firstBucket).begin(), _bucket(_firstBucket).end(),
+                              _firstBucket);
+    }
+
+    /**
+     * @brief returns an iterator to the end of the hash map
+     * @return an iterator to the end of the hash map
+     */
+    const_iterator end() const
+    {
+        // A map without buckets has no list for it's end, it is left at the end of no list
+        if (_capacity == 0)
+        {
+            return const_iterator(this, typename listPair::iterator(),
+                                  typename listPair::iterator(), 0);
+        }
+        int lastIndex = _bucketCount() - 1;
+        return const_iterator(this, _bucket(lastIndex).end(), _bucket(lastIndex).end(), lastIndex);
+    }
+
+    /**
+     * @brief returns iterator to the begin of the hash map
+     * @return an iterator to the begin of the hash map
+     */
+    const_iterator cbegin() const
+    {
+        //Checks if the hash map is empty
+        if (empty())
+        {
+            return this->end();
+        }
+
+        // The first no empty list is kept up to date by every change of the buckets
+        return const_iterator(this, _bucket(_firstBucket).begin(), _bucket(_firstBucket).end(),
+                              _firstBucket);
+    }
+
+    /**
+     * @brief returns an iterator to the end of the hash map
+     * @return an iterator to the end of the hash map
+     */
+    const_iterator cend() const
+    {
+        // A map without buckets has no list for it's end, it is left at the end of no list
+        if (_capacity == 0)
+        {
+            return const_iterator(this, typename listPair::iterator(),
+                                  typename listPair::iterator(), 0);
+        }
+        int lastIndex = _bucketCount() - 1;
+        return const_iterator(this, _bucket(lastIndex).end(), _bucket(lastIndex).end(), lastIndex);
+    }
+
+    /**
+     * @brief default constructor, initializes a hash map with default values
+     */
+    HashMap();
+
+    /**
+     * @brief initializes an empty hash map that allocates with the given allocator
+     * @param allocator - the allocator of the map
+     */
+    explicit HashMap(const Alloc& allocator);
+
+    /**
+     * @brief initializes an empty hash map with the given hash and comparison of the keys
+     * @param hasher - the hash of the keys (for example, a FastHash with a seed)
+     * @param keyEqual - the comparison of the keys
+     * @param allocator - the allocator of the map
+     */
+    explicit HashMap(const Hash& hasher, const KeyEqual& keyEqual = KeyEqual(),
+                     const Alloc& allocator = Alloc());
+
+    /**
+     * @brief a constructor for hash map, receives a vector of keys and a vector of values and
+     *        saves them into the hash map
+     * @param keys   - a vector that contains keys
+     * @param values - a vector that contains values
+     * @param allocator - the allocator of the map
+     */
+    HashMap(const std::vector<KeyT>& keys, const std::vector<ValueT>& values,
+            const Alloc& allocator = Alloc());
+
+    /**
+     * @brief copy constructor for hash map
+     * @param other - the other map
+     */
+    HashMap(const HashMap& other);
+
+    /**
+     * @brief copies the other map into a map that allocates with the given allocator
+     * @param other - the other map
+     * @param allocator - the allocator of the new map
+     */
+    HashMap(const HashMap& other, const Alloc& allocator);
+
+    /**
+     * @brief a constructor for hash map, receives a vector of keys and a vector of values and
+     *        moves them into the hash map (the vectors are left with moved-from items)
+     * @param keys   - a vector that contains keys
+     * @param values - a vector that contains values
+     * @param allocator - the allocator of the map
+     */
+    HashMap(std::vector<KeyT>&& keys, std::vector<ValueT>&& values,
+            const Alloc& allocator = Alloc());
+
+    /**
+     * @brief move constructor for hash map, takes the arrays of the other map (and it's
+     *        allocator) without copying them. The other map is left empty and without buckets,
+     *        it gets new buckets when a pair is inserted into it
+     * @param other - the other map
+     */
+    HashMap(HashMap&& other) noexcept;
+
+    /**
+     * @brief returns the allocator of the map
+     * @return a copy of the allocator
+     */
+    Alloc get_allocator() const
+    {
+        return _allocator;
+    }
+
+    /**
+     * @brief returns the hash of the keys
+     * @return a copy of the hash
+     */
+    Hash hash_function() const
+    {
+        return _hasher;
+    }
+
+    /**
+     * @brief returns the comparison of the keys
+     * @return a copy of the comparison
+     */
+    KeyEqual key_eq() const
+    {
+        return _keyEqual;
+    }
+
+    /**
+     * @brief destructor for hash map
+     */
+    ~HashMap() noexcept;
+
+    /**
+     * @brief inserts a new pair<key, value> into the hash map
+     * @param key - the key to insert
+     * @param value - the value to insert
+     * @return true if the pair was inserted, false otherwise
+     */
+    bool insert(const KeyT& key, const ValueT& value);
+
+    /**
+     * @brief checks if the key exists in the map
+     * @param key - the key to check if exist
+     * @return true if the key exists, false otherwise
+     */
+    bool containsKey(const KeyT& key) const;
+
+    /**
+     * @brief returns true if the hash map is empty
+     * @return true if the hash map is empty, false otherwise
+     */
+    bool empty() const;
+
+    /**
+     * @brief returns the number size
+     * @return - the size of the hash map (number of elements in the hash map)
+     */
+    int size() const;
+
+    /**
+     * @brief returns the number capacity
+     * @return - the capacity of the hash map
+     */
+    int capacity() const;
+
+    /**
+     * @brief gets a key, checks if the key exists in the map, if yes, returns it's value
+     * @param key - the key
+     * @return - the value of the key
+     */
+    ValueT& at(const KeyT& key);
+
+    /**
+     * @brief gets a key, checks if the key exists in the map, if yes, returns it's value (const)
+     * @param key - the key
+     * @return - the value of the key (const)
+     */
+    const ValueT& at(const KeyT& key) const;
+
+    /**
+     * @brief return the load factor
+     * @return the load factor
+     */
+    double getLoadFactor() const;
+
+    /**
+     * @brief collects the statistics of the map: the lengths of the chains and the bytes are
+     *        counted now (it goes over all the buckets), the rehashes are counted since the map was
+     *        constructed if the map is compiled with HASHMAP_STATS
+     * @return the statistics
+     */
+    HashMapStats stats() const;
+
+    /**
+     * @brief erases the value in the given key
+     * @param key - the key
+     * @return - true if the erase worked, false if the erase failed
+     */
+    bool erase(const KeyT& key);
+
+    /**
+     * @brief copies the values of the other hash map into the current hash map (the current map
+     *        keeps it's allocator)
+     * @param other - the other hash map
+     * @return - the current hash map object
+     */
+    HashMap& operator=(const HashMap& other);
+
+    /**
+     * @brief moves the other hash map into the current hash map, without copying the pairs. The
+     *        other map gets the previous pairs of the current map. If the allocators of the maps
+     *        are different (two arenas), the pairs are moved one by one into nodes of the current
+     *        allocator, and the other map is left empty
+     * @param other - the other hash map
+     * @return - the current hash map object
+     */
+    HashMap& operator=(HashMap&& other) noexcept(allocTraits::is_always_equal::value);
+
+    /**
+     * @brief makes sure the map can hold the given number of pairs without a resize. A resize
+     *        ends an incremental migration that is in progress first
+     * @param count - the number of pairs
+     */
+    void reserve(int count);
+
+    /**
+     * @brief rehashes the map into at least the given number of buckets (rounded up to a power of
+     *        two, and never less than the buckets needed for the current size). A resize ends
+     *        an incremental migration that is in progress first
+     * @param count - the number of buckets
+     */
+    void rehash(int count);
+
+    /**
+     * @brief gets a key and returns the index of the bucket of the key
+     * @param key - the key
+     * @return - the index of the bucket
+     */
+    int bucketIndex(const KeyT& key) const;
+
+    /**
+     * @brief gets a key and returns the size of the bucket of the key
+     * @param key - the key
+     * @return - the size of the bucket of the key
+     */
+    int bucketSize(const KeyT& key) const;
+
+    /**
+     * @brief clears the map
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief returns the value in the key int the map (const)
+     * @param key - the key
+     * @return - the value of the key
+     */
+    const ValueT operator[](const KeyT& key) const noexcept;
+
+    /**
+     * @brief returns the value in the key int the map (const)
+     * @param key- the key
+     * @return - the value of the key
+     */
+    ValueT& operator[](const KeyT& key) noexcept;
+
+    /**
+     * @brief Checks if the current map equals other map
+     * @param other - the other hash map
+     * @return true if the maps are equal, false otherwise
+     */
+    bool operator==(const HashMap& other) const noexcept ;
+
+    /**
+     * @brief Checks if the current map not equals other map
+     * @param other - the other hash map
+     * @return true if the maps are not equal, false otherwise
+     */
+    bool operator!=(const HashMap& other) const noexcept ;
+
+    /**
+     * @brief sets the resize mode of the map. In the incremental mode a resize keeps the old array
+     *        of lists and every insert or erase migrates a few of it's buckets into the new array,
+     *        so no single operation rehashes the whole map. The number of buckets per operation
+     *        grows with the buckets that are left and shrinks with the operations that are left
+     *        before the next resize, so a migration always ends before the next one starts.
+     *        The operations during a migration do more work, so the 99th percentile latency is
+     *        higher than in the synchronous mode, only the worst latency is lower. reserve,
+     *        rehash and turning the mode off finish a migration that is in progress
+     * @param enabled - true for the incremental mode, false to rehash the whole map at once
+     */
+    void setIncrementalRehash(bool enabled);
+
+    /**
+     * @brief turns the membership filter of the map on or off. The filter is a small Bloom filter
+     *        of the hashes of the keys (FILTER_BITS_PER_BUCKET bits per bucket) that is checked
+     *        before the bucket of a key, so most lookups of keys that don't exist return without
+     *        reading the buckets. It fits maps that are mostly searched for missing keys. An erase
+     *        leaves the bits of it's key set until the filter is rebuilt by the next resize
+     * @param enabled - true to check the filter first, false to free it
+     */
+    void setMembershipFilter(bool enabled);
+
+    /**
+     * @brief searches the key in the map, hashes the key only once
+     * @param key - the key
+     * @return an iterator to the pair of the key, or end() if the key doesn't exist
+     */
+    const_iterator find(const KeyT& key) const;
+
+    /**
+     * @brief searches a string key in the map without creating a KeyT (for example, with a
+     *        std::string_view of a part of an email), hashes the key only once
+     * @tparam K - a type that can be converted to std::string_view (only if KeyT is std::string)
+     * @param key - the key
+     * @return an iterator to the pair of the key, or end() if the key doesn't exist
+     */
+    template <class K, typename std::enable_if<_isTransparent<K>::value, int>::type = 0>
+    const_iterator find(const K& key) const
+    {
+        std::string_view keyView(key);
+        size_t hash = _hashOf(keyView);
+        if (_capacity == 0 || !_filter.mayContain(hash))
+        {
+            return end();
+        }
+        int number = _bucketNumberOf(hash);
+        listPair& bucket = _bucket(number);
+
+        for (auto it = bucket.begin(); it != bucket.end(); ++it)
+        {
+            if (it->hash == hash && _keysEqual(it->item.first, keyView))
+            {
+                return const_iterator(this, it, bucket.end(), number);
+            }
+        }
+        return end();
+    }
+
+    /**
+     * @brief checks if a string key exists in the map without creating a KeyT
+     * @param key - the key to check if exist
+     * @return true if the key exists, false otherwise
+     */
+    template <class K, typename std::enable_if<_isTransparent<K>::value, int>::type = 0>
+    bool containsKey(const K& key) const
+    {
+        return find(key) != end();
+    }
+
+    /**
+     * @brief returns the value of a string key without creating a KeyT
+     * @param key - the key
+     * @return - the value of the key
+     */
+    template <class K, typename std::enable_if<_isTransparent<K>::value, int>::type = 0>
+    ValueT& at(const K& key)
+    {
+        const_iterator it = find(key);
+        if (it == end())
+        {
+            throw std::invalid_argument("The key does not exist");
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief returns the value of a string key without creating a KeyT (const)
+     * @param key - the key
+     * @return - the value of the key (const)
+     */
+    template <class K, typename std::enable_if<_isTransparent<K>::value, int>::type = 0>
+    const ValueT& at(const K& key) const
+    {
+        const_iterator it = find(key);
+        if (it == end())
+        {
+            throw std::invalid_argument("The key does not exist");
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief inserts a pair<key, ValueT(args...)> if the key doesn't exist, otherwise does nothing.
+     *        The key is hashed only once
+     * @param key - the key
+     * @param args - the arguments to construct the value with
+     * @return an iterator to the pair of the key, and true if the pair was inserted
+     */
+    template <class... Args>
+    std::pair<const_iterator, bool> try_emplace(const KeyT& key, Args&&... args)
+    {
+        return _tryEmplace(key, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief inserts a pair<key, ValueT(args...)> if the key doesn't exist, otherwise does nothing.
+     *        The key is moved into the map only if the pair is inserted
+     * @param key - the key
+     * @param args - the arguments to construct the value with
+     * @return an iterator to the pair of the key, and true if the pair was inserted
+     */
+    template <class... Args>
+    std::pair<const_iterator, bool> try_emplace(KeyT&& key, Args&&... args)
+    {
+        return _tryEmplace(std::move(key), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief inserts the pair<key, value> if the key doesn't exist, otherwise overrides the value
+     *        of the key. The key is hashed only once
+     * @param key - the key
+     * @param value - the value
+     * @return an iterator to the pair of the key, and true if the pair was inserted
+     */
+    template <class M>
+    std::pair<const_iterator, bool> insert_or_assign(const KeyT& key, M&& value);
+
+    /**
+     * @brief inserts the pair<key, value> if the key doesn't exist, otherwise overrides the value
+     *        of the key. The key is moved into the map only if the pair is inserted
+     * @param key - the key
+     * @param value - the value
+     * @return an iterator to the pair of the key, and true if the pair was inserted
+     */
+    template <class M>
+    std::pair<const_iterator, bool> insert_or_assign(KeyT&& key, M&& value);
+
+    /**
+     * @brief constructs a pair from the arguments and inserts it if it's key doesn't exist. The
+     *        pair is constructed in it's list node, so it is not copied
+     * @param args - the arguments to construct the pair with
+     * @return an iterator to the pair of the key, and true if the pair was inserted
+     */
+    template <class... Args>
+    std::pair<const_iterator, bool> emplace(Args&&... args);
+};
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+size_t HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_hashOf(const KeyT& key) const
+{
+    return _hasher(key);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template <class K>
+size_t HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_hashOf(const K& key) const
+{
+    // The hash of a std::string_view equals the hash of the std::string with the same chars
+    return _hasher(std::string_view(key));
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_indexOf(size_t hash) const
+{
+    return (int)(hash & (_capacity - 1));
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_bucketNumberOf(size_t hash) const
+{
+    if (_oldListArr != nullptr)
+    {
+        int oldIndex = (int)(hash & (_oldCapacity - 1));
+        if (oldIndex >= _migrated)
+        {
+            return _capacity + oldIndex;
+        }
+    }
+    return _indexOf(hash);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_insertNode(size_t hash, listPair& node)
+{
+    _rehashStep();
+
+    if (((double) (size() + 1) / capacity()) > _highLoadFactor)
+    {
+        _changeSize(_capacity * 2);
+    }
+    int number = _bucketNumberOf(hash);
+
+    // Moves the node into the end of the bucket, without copying the pair
+    _bucket(number).splice(_bucket(number).end(), node);
+    _markOccupied(number);
+    _addToFilter(hash);
+
+    _size++; // Increase the number of pairs in the hash map
+
+    return number;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_rehashStep()
+{
+    if (_oldListArr == nullptr)
+    {
+        return;
+    }
+
+    // Moves the nodes of the next buckets into their lists in the new array
+#ifdef HASHMAP_STATS
+    auto start = std::chrono::steady_clock::now();
+#endif
+    // A resize starts when the size crosses a load factor bound, and every insert or erase moves
+    // the size by one. The buckets that are left are spread over the operations that are left
+    // until the closest bound, the operation that reaches the bound migrates all of them (and by
+    // then they are at most the first step)
+    int growRoom = (int)(_highLoadFactor * _capacity) - _size;
+    int shrinkRoom = _size - (int)std::ceil(_lowerLoadFactor * _capacity);
+    int operationsLeft = std::max(1, std::min(growRoom, shrinkRoom));
+    int remaining = _oldCapacity - _migrated;
+    int last = _migrated + (remaining + operationsLeft - 1) / operationsLeft;
+    for (; _migrated < last; _migrated++)
+    {
+        // Constructs the lists in the new array that the nodes of this bucket can move into
+        if (_capacity > _oldCapacity)
+        {
+            for (int i = _migrated; i < _capacity; i += _oldCapacity)
+            {
+                _constructBucket(&_listArr[i]);
+            }
+        }
+        else if (_migrated < _capacity)
+        {
+            _constructBucket(&_listArr[_migrated]);
+        }
+
+        listPair& oldList = _oldListArr[_migrated];
+        if (!oldList.empty())
+        {
+            do
+            {
+                int index = _indexOf(oldList.front().hash);
+                if (_useFilter)
+                {
+                    _nextFilter.add(oldList.front().hash);
+                }
+                _listArr[index].splice(_listArr[index].end(), oldList, oldList.begin());
+                _markOccupied(index);
+            } while (!oldList.empty());
+            _markEmpty(_capacity + _migrated);
+        }
+        oldList.~listPair();
+    }
+
+    // Checks if all the buckets were migrated, all the old lists are already destroyed. The
+    // filter of the new array has all the keys now, and replaces the filter of the old array
+    if (_migrated == _oldCapacity)
+    {
+        if (_useFilter)
+        {
+            _filter.swap(_nextFilter);
+            _nextFilter.release();
+        }
+        _oldOccupied.release();
+        _firstBucket = std::min(_firstBucket, _capacity);
+        _freeBuckets(_oldListArr, _oldCapacity);
+        _oldListArr = nullptr;
+        _oldCapacity = 0;
+        _migrated = 0;
+    }
+#ifdef HASHMAP_STATS
+    _addRehashTime(start);
+#endif
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::listPair*
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_allocateBuckets(int count)
+{
+    try
+    {
+        bucketAlloc allocator(_allocator);
+        return bucketAllocTraits::allocate(allocator, (size_t)count);
+    }
+    catch (std::bad_alloc& e)
+    {
+        std::cout << "Bad alloc" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_freeBuckets(listPair* buckets,
+                                                                int count) noexcept
+{
+    if (buckets != nullptr)
+    {
+        bucketAlloc allocator(_allocator);
+        bucketAllocTraits::deallocate(allocator, buckets, (size_t)count);
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::listPair*
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_newBuckets(int count)
+{
+    listPair* buckets = _allocateBuckets(count);
+
+    // Goes over the array and initializes empty lists
+    for (int i = 0; i < count; i++)
+    {
+        _constructBucket(&buckets[i]);
+    }
+    return buckets;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_deleteBuckets(listPair* buckets,
+                                                                  int count) noexcept
+{
+    for (int i = 0; i < count; i++)
+    {
+        buckets[i].~listPair();
+    }
+    _freeBuckets(buckets, count);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_finishRehash()
+{
+    while (_oldListArr != nullptr)
+    {
+        _rehashStep();
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::setIncrementalRehash(bool enabled)
+{
+    _incrementalRehash = enabled;
+    if (!enabled)
+    {
+        _finishRehash();
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::setMembershipFilter(bool enabled)
+{
+    // The filter is built for the new array, so a migration in progress ends first
+    _finishRehash();
+    _useFilter = enabled;
+    if (enabled)
+    {
+        _rebuildFilter();
+    }
+    else
+    {
+        _filter.release();
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_rebuildOccupancy()
+{
+    _occupied.reset((size_t)_capacity);
+    _oldOccupied.reset((size_t)_oldCapacity);
+    for (int i = 0; i < _bucketCount(); i++)
+    {
+        if (!_isBucketEmpty(i))
+        {
+            _markOccupied(i);
+        }
+    }
+    _firstBucket = _nextOccupied(0);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_ensureBuckets()
+{
+    if (_capacity != 0)
+    {
+        return;
+    }
+
+    // A copy of a moved-from map may have an array of no buckets, it is replaced
+    listPair* buckets = _newBuckets(DEFAULT_CAPACITY);
+    _freeBuckets(_listArr, 0);
+    _listArr = buckets;
+    _capacity = DEFAULT_CAPACITY;
+    _occupied.reset((size_t)_capacity);
+    _firstBucket = _capacity;
+    if (_useFilter)
+    {
+        _filter.reset((size_t)_capacity * FILTER_BITS_PER_BUCKET);
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_rebuildFilter()
+{
+    _filter.reset((size_t)_capacity * FILTER_BITS_PER_BUCKET);
+    for (int i = 0; i < _bucketCount(); i++)
+    {
+        if (_isLive(i))
+        {
+            for (const Node& node : _bucket(i))
+            {
+                _filter.add(node.hash);
+            }
+        }
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::const_iterator
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::find(const KeyT& key) const
+{
+    size_t hash = _hashOf(key);
+    if (_capacity == 0 || !_filter.mayContain(hash))
+    {
+        return end();
+    }
+    int number = _bucketNumberOf(hash);
+    listPair& bucket = _bucket(number);
+
+    for (auto it = bucket.begin(); it != bucket.end(); ++it)
+    {
+        if (it->hash == hash && _keysEqual(it->item.first, key))
+        {
+            return const_iterator(this, it, bucket.end(), number);
+        }
+    }
+    return end();
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template <class K, class... Args>
+std::pair<typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::const_iterator, bool>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_tryEmplace(K&& key, Args&&... args)
+{
+    _ensureBuckets();
+    size_t hash = _hashOf(key);
+    int number = _bucketNumberOf(hash);
+    listPair& bucket = _bucket(number);
+
+    // A key that is not in the filter is new, it's bucket isn't searched
+    if (_filter.mayContain(hash))
+    {
+        for (auto it = bucket.begin(); it != bucket.end(); ++it)
+        {
+            if (it->hash == hash && _keysEqual(it->item.first, key))
+            {
+                return std::make_pair(const_iterator(this, it, bucket.end(), number), false);
+            }
+        }
+    }
+
+    listPair node(_allocator);
+    node.emplace_back(hash, std::piecewise_construct,
+                      _withAllocator<KeyT>(std::forward<K>(key)),
+                      _withAllocator<ValueT>(std::forward<Args>(args)...));
+    number = _insertNode(hash, node);
+    auto it = std::prev(_bucket(number).end());
+    return std::make_pair(const_iterator(this, it, _bucket(number).end(), number), true);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template <class M>
+std::pair<typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::const_iterator, bool>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::insert_or_assign(const KeyT& key, M&& value)
+{
+    std::pair<const_iterator, bool> result = try_emplace(key, std::forward<M>(value));
+    if (!result.second)
+    {
+        result.first->second = std::forward<M>(value);
+    }
+    return result;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template <class M>
+std::pair<typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::const_iterator, bool>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::insert_or_assign(KeyT&& key, M&& value)
+{
+    std::pair<const_iterator, bool> result = try_emplace(std::move(key), std::forward<M>(value));
+    if (!result.second)
+    {
+        result.first->second = std::forward<M>(value);
+    }
+    return result;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template <class... Args>
+std::pair<typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::const_iterator, bool>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::emplace(Args&&... args)
+{
+    if constexpr (!allocTraits::is_always_equal::value)
+    {
+        // The pair is built first and moved into the node, so it's key and value allocate from
+        // the allocator of the map (the node itself isn't built with the allocator)
+        pair item(std::forward<Args>(args)...);
+        return _tryEmplace(std::move(item.first), std::move(item.second));
+    }
+
+    listPair node(_allocator);
+    node.emplace_back(0, std::forward<Args>(args)...);
+    const KeyT& key = node.front().item.first;
+
+    _ensureBuckets();
+    size_t hash = _hashOf(key);
+    node.front().hash = hash;
+    int number = _bucketNumberOf(hash);
+    listPair& bucket = _bucket(number);
+
+    if (_filter.mayContain(hash))
+    {
+        for (auto it = bucket.begin(); it != bucket.end(); ++it)
+        {
+            if (it->hash == hash && _keysEqual(it->item.first, key))
+            {
+                return std::make_pair(const_iterator(this, it, bucket.end(), number), false);
+            }
+        }
+    }
+
+    number = _insertNode(hash, node);
+    auto it = std::prev(_bucket(number).end());
+    return std::make_pair(const_iterator(this, it, _bucket(number).end(), number), true);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator!=(const HashMap &other) const noexcept
+{
+    return (!(this->operator==(other)));
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator==(const HashMap &other) const noexcept
+{
+    // Checks if the size is different
+    if (_size != other.size())
+    {
+        return false;
+    }
+
+    if (empty() && other.empty())
+    {
+        return true;
+    }
+
+    for (HashMap::const_iterator it = begin(); it != end(); it++)
+    {
+        const_iterator otherIt = other.find(it->first);
+
+        if (otherIt == other.end() || otherIt->second != it->second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+const ValueT
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator[](const KeyT &key) const noexcept
+{
+    const_iterator it = find(key);
+    if (it != end())
+    {
+        return it->second;
+    }
+    return ValueT();
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+ValueT& HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator[](const KeyT &key) noexcept
+{
+    // inserts a default value only if the key doesn't exist
+    return try_emplace(key).first->second;
+}
+
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::clear() noexcept
+{
+    // Ends a migration that is in progress, so all the lists of the new array are constructed
+    _finishRehash();
+
+    if (!empty())
+    {
+        for (int i = 0; i < capacity(); i++)
+        {
+            _listArr[i].clear();
+        }
+    }
+    _filter.clear();
+    _occupied.clear();
+    _firstBucket = _capacity;
+    _size = 0;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::bucketSize(const KeyT &key) const
+{
+    // Checks if the key exists in the map
+    const_iterator it = find(key);
+    if (it == end())
+    {
+        throw std::out_of_range("Out of range");
+    }
+
+    int sizeOfList = _bucket(_bucketNumberOf(_hashOf(key))).size();
+
+    return sizeOfList;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::bucketIndex(const KeyT &key) const
+{
+    // Checks if the key exists in the map
+    if (!containsKey(key))
+    {
+        throw std::out_of_range("Out of range");
+    }
+
+    int hash = _hashCode(key);
+
+    return hash;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::~HashMap() noexcept
+{
+    // Destroys the lists that are constructed (in both arrays, while the map is migrated)
+    for (int i = 0; i < _bucketCount(); i++)
+    {
+        if (_isLive(i))
+        {
+            _bucket(i).~listPair();
+        }
+    }
+    _freeBuckets(_listArr, _capacity);
+    _freeBuckets(_oldListArr, _oldCapacity);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::erase(const KeyT &key)
+{
+    if (empty())
+    {
+        return false;
+    }
+
+    size_t hash = _hashOf(key);
+    if (!_filter.mayContain(hash))
+    {
+        return false;
+    }
+    int number = _bucketNumberOf(hash);
+    listPair& bucket = _bucket(number);
+
+    for (typename listPair::iterator it = bucket.begin(); it != bucket.end(); it++)
+    {
+        if (it->hash == hash && _keysEqual(it->item.first, key))
+        {
+            bucket.erase(it);
+            if (bucket.empty())
+            {
+                _markEmpty(number);
+            }
+            _size--;
+            _rehashStep();
+            _checkIfDecrease();
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap():HashMap(Alloc())
+{
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(const Alloc& allocator)
+        :HashMap(Hash(), KeyEqual(), allocator)
+{
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(const Hash& hasher, const KeyEqual& keyEqual,
+                                                      const Alloc& allocator)
+        :_size(DEFAULT_SIZE), _capacity(DEFAULT_CAPACITY), _allocator(allocator), _hasher(hasher),
+         _keyEqual(keyEqual), _incrementalRehash(false), _oldListArr(nullptr), _oldCapacity(0),
+         _migrated(0), _useFilter(false), _filter(wordAlloc(allocator)),
+         _nextFilter(wordAlloc(allocator)), _occupied(wordAlloc(allocator)),
+         _oldOccupied(wordAlloc(allocator)), _firstBucket(DEFAULT_CAPACITY)
+{
+    _listArr = _newBuckets(_capacity);
+    _occupied.reset((size_t)_capacity);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(const std::vector<KeyT> &keys,
+                                                      const std::vector<ValueT>& values,
+                                                      const Alloc& allocator)
+        :HashMap(allocator)
+{
+    // Checks if the size of the vectors are different, if yes, throws exception
+    if (keys.size() != values.size())
+    {
+        throw std::invalid_argument("Invalid args");
+    }
+
+    // Inserts the pairs into the hash map. If the key exists, overrides the value of the key
+    // (the key will not be inserted again)
+    _bulkInsert<false>(keys, values);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(const HashMap& other)
+        :HashMap(other, allocTraits::select_on_container_copy_construction(other._allocator))
+{
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(const HashMap& other,
+                                                      const Alloc& allocator)
+        :_size(other.size()), _capacity(other.capacity()), _allocator(allocator),
+         _hasher(other._hasher), _keyEqual(other._keyEqual),
+         _incrementalRehash(other._incrementalRehash), _oldListArr(nullptr), _oldCapacity(0),
+         _migrated(0), _useFilter(other._useFilter), _filter(wordAlloc(allocator)),
+         _nextFilter(wordAlloc(allocator)), _occupied(wordAlloc(allocator)),
+         _oldOccupied(wordAlloc(allocator)), _firstBucket(other.capacity())
+{
+    _listArr = _newBuckets(_capacity);
+
+    // Copies the nodes with their hashes straight into their buckets in the new array (if the
+    // other map is not migrated, the bucket of every node is the same as in the other map)
+    for (int i = 0; i < other._bucketCount(); i++)
+    {
+        if (other._isLive(i))
+        {
+            for (const Node& node : other._bucket(i))
+            {
+                _appendNode(_listArr[_indexOf(node.hash)], node.hash, node.item.first,
+                            node.item.second);
+            }
+        }
+    }
+    _rebuildOccupancy();
+    if (_useFilter)
+    {
+        _rebuildFilter();
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(std::vector<KeyT>&& keys,
+                                                      std::vector<ValueT>&& values,
+                                                      const Alloc& allocator)
+        :HashMap(allocator)
+{
+    // Checks if the size of the vectors are different, if yes, throws exception
+    if (keys.size() != values.size())
+    {
+        throw std::invalid_argument("Invalid args");
+    }
+
+    // Moves the pairs into the hash map. If the key exists, overrides the value of the key
+    _bulkInsert<true>(keys, values);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template <bool Move, class Keys, class Values>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_bulkInsert(Keys& keys, Values& values)
+{
+    // Sizes the map for all the keys at once, so it is never rehashed while it is filled
+    reserve((int)keys.size());
+
+    // Large maps with a stateless allocator (that any thread can allocate from) are filled on
+    // several threads, every thread hashes a part of the keys and then inserts the keys of a
+    // range of buckets
+    int numOfThreads = 1;
+    if (allocTraits::is_always_equal::value && (int)keys.size() >= PARALLEL_BUILD_MIN_SIZE)
+    {
+        numOfThreads = std::max(1, std::min((int)std::thread::hardware_concurrency(),
+                                            _capacity));
+    }
+
+    std::vector<size_t> hashes(keys.size());
+    std::vector<int> inserted(numOfThreads, 0);
+    std::vector<std::exception_ptr> errors(numOfThreads);
+    auto runOnThreads = [numOfThreads, &errors](auto task)
+    {
+        auto runTask = [&task, &errors](int t)
+        {
+            try
+            {
+                task(t);
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        };
+
+        // If a thread can't be started, the tasks that have no thread run on this thread (the
+        // tasks are independent), the started threads are always joined
+        std::vector<std::thread> threads;
+        int firstUnstarted = numOfThreads;
+        for (int t = 1; t < numOfThreads; t++)
+        {
+            try
+            {
+                threads.emplace_back(runTask, t);
+            }
+            catch (const std::system_error&)
+            {
+                firstUnstarted = t;
+                break;
+            }
+        }
+        runTask(0);
+        for (int t = firstUnstarted; t < numOfThreads; t++)
+        {
+            runTask(t);
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        for (std::exception_ptr& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+
+    runOnThreads([this, &keys, &hashes, numOfThreads](int t)
+    {
+        size_t end = hashes.size() * (t + 1) / numOfThreads;
+        for (size_t i = hashes.size() * t / numOfThreads; i < end; i++)
+        {
+            hashes[i] = _hashOf(keys[i]);
+        }
+    });
+
+    // A thread that fails leaves the map valid, the pairs it inserted are counted
+    try
+    {
+        runOnThreads([this, &keys, &values, &hashes, &inserted, numOfThreads](int t)
+        {
+            int first = (int)((long long)_capacity * t / numOfThreads);
+            int last = (int)((long long)_capacity * (t + 1) / numOfThreads);
+            inserted[t] = _bulkInsertBuckets<Move>(keys, values, hashes, first, last);
+        });
+    }
+    catch (...)
+    {
+        _size = 0;
+        for (int i = 0; i < _capacity; i++)
+        {
+            _size += (int)_listArr[i].size();
+        }
+        _rebuildOccupancy();
+        throw;
+    }
+    for (int count : inserted)
+    {
+        _size += count;
+    }
+
+    // The threads fill ranges of buckets that can share words of the bitmap, so the bitmap is
+    // built after them
+    _rebuildOccupancy();
+    if (_useFilter)
+    {
+        _rebuildFilter();
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template <bool Move, class Keys, class Values>
+int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_bulkInsertBuckets(Keys& keys, Values& values,
+                                                                     const std::vector<size_t>&
+                                                                     hashes, int first, int last)
+{
+    // The keys are taken in their order, so every bucket gets the keys in the same order as a
+    // map that is filled one key at a time
+    int count = 0;
+    for (size_t i = 0; i < hashes.size(); i++)
+    {
+        int index = _indexOf(hashes[i]);
+        if (index < first || index >= last)
+        {
+            continue;
+        }
+
+        listPair& bucket = _listArr[index];
+        auto it = bucket.begin();
+        for (; it != bucket.end(); ++it)
+        {
+            if (it->hash == hashes[i] && _keysEqual(it->item.first, keys[i]))
+            {
+                break;
+            }
+        }
+
+        if (it != bucket.end())
+        {
+            if constexpr (Move)
+            {
+                it->item.second = std::move(values[i]);
+            }
+            else
+            {
+                it->item.second = values[i];
+            }
+            continue;
+        }
+
+        if constexpr (Move)
+        {
+            _appendNode(bucket, hashes[i], std::move(keys[i]), std::move(values[i]));
+        }
+        else
+        {
+            _appendNode(bucket, hashes[i], keys[i], values[i]);
+        }
+        count++;
+    }
+    return count;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(HashMap&& other) noexcept
+        :_size(other._size), _capacity(other._capacity), _listArr(other._listArr),
+         _allocator(std::move(other._allocator)), _hasher(std::move(other._hasher)),
+         _keyEqual(std::move(other._keyEqual)), _incrementalRehash(other._incrementalRehash),
+         _oldListArr(other._oldListArr),
+         _oldCapacity(other._oldCapacity), _migrated(other._migrated),
+         _useFilter(other._useFilter), _filter(std::move(other._filter)),
+         _nextFilter(std::move(other._nextFilter)), _occupied(std::move(other._occupied)),
+         _oldOccupied(std::move(other._oldOccupied)), _firstBucket(other._firstBucket)
+{
+    other._size = 0;
+    other._capacity = 0;
+    other._listArr = nullptr;
+    other._oldListArr = nullptr;
+    other._oldCapacity = 0;
+    other._migrated = 0;
+    other._useFilter = false;
+    other._firstBucket = 0;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_swap(HashMap& other) noexcept
+{
+    std::swap(_size, other._size);
+    std::swap(_capacity, other._capacity);
+    std::swap(_listArr, other._listArr);
+    std::swap(_hasher, other._hasher);
+    std::swap(_keyEqual, other._keyEqual);
+    std::swap(_incrementalRehash, other._incrementalRehash);
+    std::swap(_oldListArr, other._oldListArr);
+    std::swap(_oldCapacity, other._oldCapacity);
+    std::swap(_migrated, other._migrated);
+    std::swap(_useFilter, other._useFilter);
+    _filter.swap(other._filter);
+    _nextFilter.swap(other._nextFilter);
+    _occupied.swap(other._occupied);
+    _oldOccupied.swap(other._oldOccupied);
+    std::swap(_firstBucket, other._firstBucket);
+    if constexpr (allocTraits::propagate_on_container_swap::value)
+    {
+        std::swap(_allocator, other._allocator);
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>&
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator=(HashMap&& other)
+        noexcept(allocTraits::is_always_equal::value)
+{
+    if (_canTakeNodesOf(other))
+    {
+        _swap(other);
+        return *this;
+    }
+
+    // The nodes of the other map can't be freed by the allocator of this map, so the pairs are
+    // moved into new nodes
+    HashMap moved(other._hasher, other._keyEqual, _allocator);
+    moved.reserve(other._size);
+    moved._incrementalRehash = other._incrementalRehash;
+    moved.setMembershipFilter(other._useFilter);
+    for (int i = 0; i < other._bucketCount(); i++)
+    {
+        if (other._isLive(i))
+        {
+            for (Node& node : other._bucket(i))
+            {
+                moved.insert_or_assign(std::move(node.item.first), std::move(node.item.second));
+            }
+        }
+    }
+    other.clear();
+    _swap(moved);
+    return *this;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::reserve(int count)
+{
+    _ensureBuckets();
+
+    // Finds the smallest capacity that keeps count pairs under the high load factor
+    int newSize = _capacity;
+    while ((double)count / newSize > _highLoadFactor)
+    {
+        newSize *= 2;
+    }
+    if (newSize != _capacity)
+    {
+        // An explicit resize ends a migration that is in progress first
+        _finishRehash();
+        _changeSize(newSize);
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::rehash(int count)
+{
+    _ensureBuckets();
+    int newSize = MIN_CAPACITY_SIZE;
+    while (newSize < count || (double)_size / newSize > _highLoadFactor)
+    {
+        newSize *= 2;
+    }
+    if (newSize != _capacity)
+    {
+        // An explicit resize ends a migration that is in progress first
+        _finishRehash();
+        _changeSize(newSize);
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::insert(const KeyT& key, const ValueT& value)
+{
+    // If the key already exists, returns false and doesn't insert the key
+    return try_emplace(key, value).second;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_checkIfDecrease()
+{
+    double loadFactor = getLoadFactor();
+
+    if (_capacity >= MIN_CAPACITY_SIZE)
+    {
+        if (loadFactor < _lowerLoadFactor)
+        {
+            int newSize = _capacity / 2;
+            _changeSize(newSize);
+        }
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::empty() const
+{
+    return _size == DEFAULT_SIZE;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_changeSize(int newSize)
+{
+    // The steps of a migration end it before the size can reach a load factor bound, and reserve
+    // and rehash end it first (see _rehashStep)
+    assert(_oldListArr == nullptr);
+
+#ifdef HASHMAP_STATS
+    (newSize > _capacity) ? _growRehashes++ : _shrinkRehashes++;
+    auto start = std::chrono::steady_clock::now();
+#endif
+
+    if (_incrementalRehash)
+    {
+        // Keeps the current array as the old array, it's buckets are migrated by the next
+        // operations
+        _oldListArr  = _listArr;
+        _oldCapacity = _capacity;
+        _migrated    = 0;
+        _listArr     = _allocateBuckets(newSize);
+        _capacity    = newSize;
+        if (_useFilter)
+        {
+            _nextFilter.reset((size_t)newSize * FILTER_BITS_PER_BUCKET);
+        }
+
+        // The buckets of the old array are numbered after the new array now
+        _oldOccupied.swap(_occupied);
+        _occupied.reset((size_t)newSize);
+        _firstBucket = _nextOccupied(0);
+        _rehashStep();
+        return;
+    }
+
+    auto newListArr = _newBuckets(newSize);
+
+    // The filter is sized for the new array and refilled with the keys as they move, so the bits
+    // of erased keys are dropped
+    if (_useFilter)
+    {
+        _filter.reset((size_t)newSize * FILTER_BITS_PER_BUCKET);
+    }
+    _occupied.reset((size_t)newSize);
+
+    // for each node calculate the new hash value and move the node into it's list in the new
+    // array. The nodes are relinked, so no pair is copied and nothing is allocated per pair
+    for (int j = 0; j < capacity(); ++j)
+    {
+        listPair& oldList = _listArr[j];
+        while (!oldList.empty())
+        {
+            if (_useFilter)
+            {
+                _filter.add(oldList.front().hash);
+            }
+            int index = (int)(oldList.front().hash & (newSize - 1));
+            newListArr[index].splice(newListArr[index].end(), oldList, oldList.begin());
+            _occupied.set((size_t)index);
+        }
+    }
+    _deleteBuckets(_listArr, _capacity);
+
+    _listArr = newListArr;
+    _capacity = newSize;
+    _firstBucket = (int)_occupied.next(0);
+#ifdef HASHMAP_STATS
+    _addRehashTime(start);
+#endif
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::containsKey(const KeyT& key) const
+{
+    // Search the key in the according list (the list in the index calculated by the hash function)
+    return find(key) != end();
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_hashCode(const KeyT& key) const
+{
+    return _indexOf(_hashOf(key));
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::size() const
+{
+    return _size;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::capacity() const
+{
+    return _capacity;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+ValueT & HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::at(const KeyT& key)
+{
+    size_t hash = _hashOf(key);
+    if (_capacity == 0 || !_filter.mayContain(hash))
+    {
+        throw std::invalid_argument("The key does not exist");
+    }
+    listPair& bucket = _bucket(_bucketNumberOf(hash));
+
+    // Goes over the list in the hash index, searches for the key and returns the value of the key
+    // when found
+    for (auto it = bucket.begin(); it != bucket.end(); ++it)
+    {
+        if (it->hash == hash && _keysEqual(it->item.first, key))
+        {
+            return it->item.second;
+        }
+    }
+    throw std::invalid_argument("The key does not exist");
+}
+
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+const ValueT& HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::at(const KeyT& key) const
+{
+    size_t hash = _hashOf(key);
+    if (_capacity == 0 || !_filter.mayContain(hash))
+    {
+        throw std::invalid_argument("The key does not exist");
+    }
+    listPair& bucket = _bucket(_bucketNumberOf(hash));
+
+    // Goes over the list in the hash index, searches for the key and returns the value of the key
+    // when found
+    for (auto it = bucket.begin(); it != bucket.end(); ++it)
+    {
+        if (it->hash == hash && _keysEqual(it->item.first, key))
+        {
+            return it->item.second;
+        }
+    }
+    throw std::invalid_argument("The key does not exist");
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+double HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::getLoadFactor() const
+{
+    if (_capacity == 0)
+    {
+        return 0;
+    }
+    double a = (double)_size / _capacity;
+    return a;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMapStats HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::stats() const
+{
+    HashMapStats result{};
+    result.size = _size;
+    result.buckets = _bucketCount();
+    result.loadFactor = (_capacity > 0) ? getLoadFactor() : 0;
+
+    for (int i = 0; i < _bucketCount(); i++)
+    {
+        int length = _isLive(i) ? (int)_bucket(i).size() : 0;
+        if (length >= (int)result.chainLengths.size())
+        {
+            result.chainLengths.resize(length + 1, 0);
+        }
+        result.chainLengths[length]++;
+        result.longestChain = std::max(result.longestChain, length);
+
+        if (length > 0)
+        {
+            for (const Node& node : _bucket(i))
+            {
+                result.keyBytes += _keyBytes(node.item.first);
+            }
+        }
+    }
+
+#ifdef HASHMAP_STATS
+    result.growRehashes = _growRehashes;
+    result.shrinkRehashes = _shrinkRehashes;
+    result.rehashNanos = _rehashNanos;
+#endif
+    result.bucketBytes = (size_t)_bucketCount() * sizeof(listPair) + _occupied.bytes() +
+                         _oldOccupied.bytes();
+    // Every node of a std::list has links to the next and the previous nodes
+    result.nodeBytes = (size_t)_size * (sizeof(Node) + LIST_NODE_LINKS * sizeof(void*));
+    result.filterBytes = _filter.bytes() + _nextFilter.bytes();
+    return result;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>&
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator=(const HashMap& other)
+{
+    // Check if other isn't this object
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    // Copies the other map and takes it's arrays, the copy frees the arrays of this map
+    HashMap copy(other, _allocator);
+    _swap(copy);
+    return *this;
+}
+
+/**
+ * @brief a HashMap that allocates from a std::pmr::memory_resource. With a
+ *        std::pmr::monotonic_buffer_resource (an arena) all the nodes and arrays of lists of a
+ *        table that is built once and then only read are allocated one after the other in a few
+ *        large blocks, and are freed at once with the arena. The arena never reuses freed memory,
+ *        so it fits tables that don't erase or resize much after they are built
+ * @tparam KeyT - the key (std::pmr::string keys are allocated in the arena too)
+ * @tparam ValueT - the value
+ */
+template <class KeyT, class ValueT>
+using PmrHashMap = HashMap<KeyT, ValueT, FastHash<KeyT>, std::equal_to<KeyT>,
+                           std::pmr::polymorphic_allocator<std::pair<KeyT, ValueT>>>;
+
 #endif //CPP_EX3_HASHMAP_HPP
\ No newline at end of file
@@ -0,0 +1,1072 @@
+/**
+* @file    HashMapBenchmark.cpp
+* @author  user
+* @version 1.0
+* @brief   Benchmarks for HashMap
+* @section resize latency: measures the latency of every insert and erase while a map grows to N
+*          pairs and shrinks back, once with a synchronous rehash and once with the incremental
+*          rehash, and prints the latency percentiles of both modes. Built with -DHASHMAP_STATS,
+*          the statistics of the map (the rehashes and the time they took) are printed after each
+*          mode.
+*          concurrent lookups: fills a ConcurrentHashMap with N pairs, then runs 1, 2, 4... reader
+*          threads that look up random keys while a writer thread inserts new keys (and resizes
+*          the map), and prints the lookup throughput for each number of readers.
+*          operations suite (--suite): times insert, containsKey (all hits, half hits, all
+*          misses), at, operator[], erase, full iteration, copy, operator== and a resize of
+*          HashMap, HashMap with it's membership filter on (HashMap+filter), FlatHashMap and
+*          std::unordered_map (the baseline), with int and std::string keys, for 1K to 10M pairs
+*          and sequential, random and strided keys. The results are printed and saved as CSV (or
+*          JSON, for a file that ends with .json), one row per measurement, so two runs can be
+*          compared to catch regressions.
+*          arena (--arena): builds a table of N phrase-like string keys with the default allocator,
+*          in a std::pmr::monotonic_buffer_resource arena and in a StringPoolMap, while the heap is
+*          fragmented by other allocations, and prints the build time, the lookup time, the time
+*          of a scan over all the keys, the cache misses per lookup (from perf_event_open, n/a
+*          where the counter is not available) and the number of memory pages the pairs are
+*          spread over. Then it builds each table again from vectors of the keys and the values
+*          (like the phrase table is built) and prints the heap it takes per pair (from
+*          mallinfo2, n/a where it is not available).
+*          sparse (--sparse): builds a HashMap of N pairs with enough buckets for load factors from
+*          0.75 down to 0.001, and prints the time of a full iteration per pair and the time of
+*          begin() at every load, the empty buckets between the pairs are skipped by the
+*          occupancy bitmap of the map.
+*          Build: make HashMapBenchmark (or HashMapBenchmarkStats, with -DHASHMAP_STATS), or
+*                 g++ -std=c++17 -O2 -pthread HashMapBenchmark.cpp -o HashMapBenchmark
+*          Usage: HashMapBenchmark [number of pairs]
+*                 HashMapBenchmark --suite <results file> [max number of pairs]
+*                 HashMapBenchmark --arena [number of pairs]
+*                 HashMapBenchmark --sparse [number of pairs]
+*/
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <fstream>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <unordered_set>
+#include <memory_resource>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <malloc.h>
+#endif
+#include "HashMap.hpp"
+#include "FlatHashMap.hpp"
+#include "ConcurrentHashMap.hpp"
+#include "StringPoolMap.hpp"
+
+#define DEFAULT_NUM_OF_PAIRS 2000000
+#define NANO_IN_MICRO 1000.0
+#define CONCURRENT_BENCH_MILLIS 1000
+#define MAX_NUM_OF_READERS 8
+#define MILLIS_IN_SECOND 1000.0
+#define MILLION 1000000.0
+#define SUITE_OPTION "--suite"
+#define JSON_EXTENSION ".json"
+#define SUITE_MIN_SIZE 1000
+#define SUITE_MAX_SIZE 10000000
+#define SUITE_SIZE_STEP 10
+#define SUITE_MIN_TIMED_OPS 1000000
+#define SUITE_SEED 42
+#define KEY_STRIDE 64
+#define HEX_KEY_LENGTH 16
+#define HALF 0.5
+#define ARENA_OPTION "--arena"
+#define DEFAULT_NUM_OF_ARENA_PAIRS 1000000
+#define ARENA_MIN_LOOKUPS 4000000
+#define NOISE_MIN_SIZE 16
+#define NOISE_MAX_SIZE 256
+#define PAGE_SHIFT 12
+#define PAIRS_PER_ROW 1000.0
+#define SPARSE_OPTION "--sparse"
+#define DEFAULT_NUM_OF_SPARSE_PAIRS 4000
+#define SPARSE_MIN_TIMED_PAIRS 20000000
+#define SPARSE_BEGIN_CALLS 1000000
+#define USAGE_ERR "Usage: HashMapBenchmark [number of pairs]\n" \
+                  "       HashMapBenchmark --suite <results file> [max number of pairs]\n" \
+                  "       HashMapBenchmark --arena [number of pairs]\n" \
+                  "       HashMapBenchmark --sparse [number of pairs]"
+
+typedef std::chrono::steady_clock benchClock;
+
+// The results of the measured operations are added here, so the compiler can't drop them
+static volatile long long benchSink = 0;
+
+/**
+ * @brief a measurement of the operations suite
+ */
+struct SuiteResult
+{
+    std::string container;    // the measured map
+    std::string key;          // the type of the keys
+    std::string distribution; // the way the keys were generated
+    int size;                 // the number of pairs in the map
+    std::string operation;    // the measured operation
+    double hitRatio;          // the part of the looked up keys that exist in the map
+    long long ops;            // the number of timed operations
+    double nanosPerOp;        // the average time of an operation
+};
+
+// ------------------------------------------- function declaration --------------------------------
+
+/**
+ * @brief gets the latencies of operations (in nanoseconds) and prints their percentiles
+ * @param name - the name of the measured operations
+ * @param latencies - the latencies, sorted in place
+ */
+void printPercentiles(const std::string& name, std::vector<long long>& latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p)
+    {
+        size_t index = (size_t)(p * (double)(latencies.size() - 1));
+        return (double)latencies[index] / NANO_IN_MICRO;
+    };
+
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+              << std::setprecision(3)
+              << std::setw(10) << percentile(0.5)
+              << std::setw(10) << percentile(0.99)
+              << std::setw(10) << percentile(0.999)
+              << std::setw(10) << percentile(0.9999)
+              << std::setw(14) << (double)latencies.back() / NANO_IN_MICRO << std::endl;
+}
+
+/**
+ * @brief inserts numOfPairs pairs into a map and erases them, measures the latency of every
+ *        operation and prints the percentiles
+ * @param numOfPairs - the number of pairs
+ * @param incremental - true to use the incremental rehash mode of the map
+ */
+void benchmarkResizeLatency(int numOfPairs, bool incremental)
+{
+    HashMap<int, int> map;
+    map.setIncrementalRehash(incremental);
+
+    std::vector<long long> insertLatencies(numOfPairs);
+    std::vector<long long> eraseLatencies(numOfPairs);
+
+    for (int i = 0; i < numOfPairs; i++)
+    {
+        auto start = benchClock::now();
+        map.insert(i, i);
+        auto end = benchClock::now();
+        insertLatencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                .count();
+    }
+
+    for (int i = 0; i < numOfPairs; i++)
+    {
+        auto start = benchClock::now();
+        map.erase(i);
+        auto end = benchClock::now();
+        eraseLatencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                .count();
+    }
+
+    std::string mode = incremental ? "incremental" : "synchronous";
+    printPercentiles("insert " + mode, insertLatencies);
+    printPercentiles("erase " + mode, eraseLatencies);
+#ifdef HASHMAP_STATS
+    std::cout << map.stats();
+#endif
+}
+
+/**
+ * @brief fills a concurrent map with numOfPairs pairs, then looks up random keys from numOfReaders
+ *        threads while a writer thread inserts new keys, and prints the throughput of both
+ * @param numOfPairs - the number of pairs to fill the map with
+ * @param numOfReaders - the number of reader threads
+ */
+void benchmarkConcurrentLookups(int numOfPairs, int numOfReaders)
+{
+    ConcurrentHashMap<int, int> map;
+    for (int i = 0; i < numOfPairs; i++)
+    {
+        map.insert(i, i);
+    }
+
+    std::atomic<bool> stop(false);
+    std::atomic<long long> lookups(0);
+    std::atomic<long long> misses(0);
+    long long inserts = 0;
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < numOfReaders; r++)
+    {
+        readers.emplace_back([&map, &stop, &lookups, &misses, numOfPairs, r]
+        {
+            std::mt19937 generator(r);
+            long long count = 0;
+            long long missed = 0;
+            int value = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                missed += !map.find((int)(generator() % numOfPairs), value);
+                count++;
+            }
+            lookups += count;
+            misses += missed;
+        });
+    }
+    std::thread writer([&map, &stop, &inserts, numOfPairs]
+    {
+        for (int key = numOfPairs; !stop.load(std::memory_order_relaxed); key++)
+        {
+            map.insert(key, key);
+            inserts++;
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(CONCURRENT_BENCH_MILLIS));
+    stop = true;
+    writer.join();
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    double seconds = CONCURRENT_BENCH_MILLIS / MILLIS_IN_SECOND;
+    std::cout << std::right << std::setw(8) << numOfReaders << std::fixed << std::setprecision(2)
+              << std::setw(16) << (double)lookups / seconds / MILLION
+              << std::setw(16) << (double)inserts / seconds / MILLION
+              << std::setw(10) << misses.load() << std::endl;
+}
+
+/**
+ * @brief mixes a number into another one, every number gets a different result
+ * @param x - the number
+ * @return the mixed number
+ */
+uint64_t mixKey(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * @brief generates the int key number i of a distribution, different numbers get different keys
+ * @param i - the number of the key
+ * @param distribution - "sequential" (i), "random" (i mixed) or "strided" (i * KEY_STRIDE, the
+ *                       low bits of all the keys are the same)
+ * @param key - the int to save the key into
+ */
+void makeKey(int i, const std::string& distribution, int& key)
+{
+    if (distribution == "random")
+    {
+        // The low 32 bits of the mix are also different for different numbers below 2^32
+        key = (int)(uint32_t)mixKey((uint64_t)i);
+        return;
+    }
+    key = (distribution == "strided") ? i * KEY_STRIDE : i;
+}
+
+/**
+ * @brief generates the string key number i of a distribution, different numbers get different keys
+ * @param i - the number of the key
+ * @param distribution - "sequential" ("key" and i), "random" (i mixed, in hex) or "strided"
+ *                       (i * KEY_STRIDE)
+ * @param key - the string to save the key into
+ */
+void makeKey(int i, const std::string& distribution, std::string& key)
+{
+    if (distribution == "random")
+    {
+        static const char digits[] = "0123456789abcdef";
+        uint64_t mixed = mixKey((uint64_t)i);
+        key.assign(HEX_KEY_LENGTH, '0');
+        for (int j = 0; j < HEX_KEY_LENGTH; j++, mixed >>= 4)
+        {
+            key[j] = digits[mixed & 0xf];
+        }
+        return;
+    }
+    key = (distribution == "strided") ? std::to_string((long long)i * KEY_STRIDE)
+                                      : "key" + std::to_string(i);
+}
+
+// ---- the operations that are different for the measured maps ----
+
+template <class Key>
+
+/**
+ * @brief a HashMap that checks it's membership filter before it's buckets (the copies of the map
+ *        check it too)
+ * @tparam Key - the type of the keys
+ */
+class FilteredHashMap : public HashMap<Key, int>
+{
+public:
+
+    /**
+     * @brief creates an empty map with the filter on
+     */
+    FilteredHashMap()
+    {
+        this->setMembershipFilter(true);
+    }
+};
+
+template <class Map, class Key>
+void insertInto(Map& map, const Key& key, int value)
+{
+    map.insert(key, value);
+}
+
+template <class Key>
+void insertInto(std::unordered_map<Key, int>& map, const Key& key, int value)
+{
+    map.emplace(key, value);
+}
+
+template <class Map, class Key>
+bool containsIn(const Map& map, const Key& key)
+{
+    return map.containsKey(key);
+}
+
+template <class Key>
+bool containsIn(const std::unordered_map<Key, int>& map, const Key& key)
+{
+    return map.count(key) != 0;
+}
+
+// doubles the number of buckets, returns false if the map can't be resized on demand
+template <class Key>
+bool growBuckets(HashMap<Key, int>& map)
+{
+    map.rehash(map.capacity() * 2);
+    return true;
+}
+
+template <class Key>
+bool growBuckets(std::unordered_map<Key, int>& map)
+{
+    map.rehash(map.bucket_count() * 2);
+    return true;
+}
+
+template <class Key>
+bool growBuckets(FlatHashMap<Key, int>& map)
+{
+    (void)map;
+    return false;
+}
+
+/**
+ * @brief a compiler barrier: the reads of a repeated loop can't be merged across it, so the same
+ *        lookups are really done again in every repeat
+ */
+inline void clobberMemory()
+{
+    asm volatile("" : : : "memory");
+}
+
+/**
+ * @brief runs a timed function
+ * @param function - the function
+ * @return the time it took, in nanoseconds
+ */
+template <class F>
+double timeNanos(F function)
+{
+    auto start = benchClock::now();
+    function();
+    auto end = benchClock::now();
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/**
+ * @brief times all the operations of the suite on one map type. Every operation is repeated until
+ *        at least SUITE_MIN_TIMED_OPS operations were timed, the preparation is not timed
+ * @tparam Map - the map, from Key to int
+ * @tparam Key - the type of the keys
+ * @param container - the name of the map
+ * @param keyName - the name of the type of the keys
+ * @param distribution - the name of the distribution of the keys
+ * @param keys - the keys of the map
+ * @param missing - keys that are not in the map (as many as the keys)
+ * @param results - the vector to add the measurements to
+ */
+template <class Map, class Key>
+void benchmarkOperations(const std::string& container, const std::string& keyName,
+                         const std::string& distribution, const std::vector<Key>& keys,
+                         const std::vector<Key>& missing, std::vector<SuiteResult>& results)
+{
+    int size = (int)keys.size();
+    int repeats = std::max(1, SUITE_MIN_TIMED_OPS / size);
+    std::mt19937 generator(SUITE_SEED);
+
+    auto record = [&](const std::string& operation, double hitRatio, double nanos)
+    {
+        long long ops = (long long)repeats * size;
+        results.push_back(SuiteResult{container, keyName, distribution, size, operation,
+                                      hitRatio, ops, nanos / (double)ops});
+        const SuiteResult& result = results.back();
+        std::cout << std::left << std::setw(20) << container << std::setw(8) << keyName
+                  << std::setw(12) << distribution << std::right << std::setw(10) << size
+                  << "  " << std::left << std::setw(14) << operation << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(6) << hitRatio
+                  << std::setw(12) << result.nanosPerOp << std::endl;
+    };
+
+    // insert, into an empty map that grows
+    double nanos = 0;
+    for (int r = 0; r < repeats; r++)
+    {
+        Map map;
+        nanos += timeNanos([&]
+        {
+            for (int i = 0; i < size; i++)
+            {
+                insertInto(map, keys[i], i);
+            }
+        });
+        benchSink = benchSink + (long long)map.size();
+    }
+    record("insert", 0, nanos);
+
+    Map full;
+    for (int i = 0; i < size; i++)
+    {
+        insertInto(full, keys[i], i);
+    }
+    std::vector<Key> shuffled(keys);
+    std::shuffle(shuffled.begin(), shuffled.end(), generator);
+
+    // containsKey, with all, half and none of the looked up keys in the map
+    for (double hitRatio : {1.0, HALF, 0.0})
+    {
+        int hits = (int)(hitRatio * size);
+        std::vector<Key> lookups(shuffled.begin(), shuffled.begin() + hits);
+        lookups.insert(lookups.end(), missing.begin(), missing.begin() + (size - hits));
+        std::shuffle(lookups.begin(), lookups.end(), generator);
+        nanos = timeNanos([&]
+        {
+            long long found = 0;
+            for (int r = 0; r < repeats; r++)
+            {
+                for (const Key& key : lookups)
+                {
+                    found += containsIn(full, key);
+                }
+                clobberMemory();
+            }
+            benchSink = benchSink + found;
+        });
+        record("containsKey", hitRatio, nanos);
+    }
+
+    // at and operator[], of keys that exist
+    nanos = timeNanos([&]
+    {
+        long long sum = 0;
+        for (int r = 0; r < repeats; r++)
+        {
+            for (const Key& key : shuffled)
+            {
+                sum += full.at(key);
+            }
+            clobberMemory();
+        }
+        benchSink = benchSink + sum;
+    });
+    record("at", 1, nanos);
+
+    nanos = timeNanos([&]
+    {
+        long long sum = 0;
+        for (int r = 0; r < repeats; r++)
+        {
+            for (const Key& key : shuffled)
+            {
+                sum += full[key];
+            }
+            clobberMemory();
+        }
+        benchSink = benchSink + sum;
+    });
+    record("operator[]", 1, nanos);
+
+    // iteration over all the pairs
+    nanos = timeNanos([&]
+    {
+        long long sum = 0;
+        for (int r = 0; r < repeats; r++)
+        {
+            for (const auto& pair : full)
+            {
+                sum += pair.second;
+            }
+            clobberMemory();
+        }
+        benchSink = benchSink + sum;
+    });
+    record("iterate", 0, nanos);
+
+    // copy and operator== (the time is per pair)
+    nanos = 0;
+    for (int r = 0; r < repeats; r++)
+    {
+        nanos += timeNanos([&]
+        {
+            Map copy(full);
+            benchSink = benchSink + (long long)copy.size();
+        });
+    }
+    record("copy", 0, nanos);
+
+    Map copy(full);
+    nanos = timeNanos([&]
+    {
+        long long equal = 0;
+        for (int r = 0; r < repeats; r++)
+        {
+            equal += (full == copy);
+            clobberMemory();
+        }
+        benchSink = benchSink + equal;
+    });
+    record("operator==", 1, nanos);
+
+    // erase of all the keys, and a resize to twice the buckets (the time is per pair), on copies
+    nanos = 0;
+    for (int r = 0; r < repeats; r++)
+    {
+        Map map(full);
+        nanos += timeNanos([&]
+        {
+            for (const Key& key : shuffled)
+            {
+                map.erase(key);
+            }
+        });
+        benchSink = benchSink + (long long)map.size();
+    }
+    record("erase", 1, nanos);
+
+    nanos = 0;
+    bool resized = true;
+    for (int r = 0; r < repeats && resized; r++)
+    {
+        Map map(full);
+        nanos += timeNanos([&]
+        {
+            resized = growBuckets(map);
+        });
+    }
+    if (resized)
+    {
+        record("resize", 0, nanos);
+    }
+}
+
+/**
+ * @brief generates the keys of a size and a distribution, and times the operations of all the maps
+ *        with them
+ * @tparam Key - the type of the keys
+ * @param keyName - the name of the type of the keys
+ * @param distribution - the name of the distribution of the keys
+ * @param size - the number of pairs
+ * @param results - the vector to add the measurements to
+ */
+template <class Key>
+void benchmarkKeys(const std::string& keyName, const std::string& distribution, int size,
+                   std::vector<SuiteResult>& results)
+{
+    std::vector<Key> keys(size);
+    std::vector<Key> missing(size);
+    for (int i = 0; i < size; i++)
+    {
+        makeKey(i, distribution, keys[i]);
+        makeKey(size + i, distribution, missing[i]);
+    }
+
+    benchmarkOperations<HashMap<Key, int>>("HashMap", keyName, distribution, keys, missing,
+                                           results);
+    benchmarkOperations<FilteredHashMap<Key>>("HashMap+filter", keyName, distribution, keys,
+                                              missing, results);
+    benchmarkOperations<FlatHashMap<Key, int>>("FlatHashMap", keyName, distribution, keys,
+                                               missing, results);
+    benchmarkOperations<std::unordered_map<Key, int>>("std::unordered_map", keyName, distribution,
+                                                      keys, missing, results);
+}
+
+/**
+ * @brief saves the results of the suite, as JSON if the path ends with ".json" and as CSV
+ *        otherwise
+ * @param path - the path of the file
+ * @param results - the results
+ * @return true if the file was written, false otherwise
+ */
+bool writeResults(const std::string& path, const std::vector<SuiteResult>& results)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::string extension = JSON_EXTENSION;
+    bool json = path.size() >= extension.size() &&
+                path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+    file << std::fixed << std::setprecision(3);
+    if (!json)
+    {
+        file << "container,key,distribution,size,operation,hit_ratio,ops,ns_per_op\n";
+    }
+    else
+    {
+        file << "[\n";
+    }
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const SuiteResult& r = results[i];
+        if (!json)
+        {
+            file << r.container << "," << r.key << "," << r.distribution << "," << r.size << ","
+                 << r.operation << "," << r.hitRatio << "," << r.ops << "," << r.nanosPerOp
+                 << "\n";
+            continue;
+        }
+        file << "  {\"container\": \"" << r.container << "\", \"key\": \"" << r.key
+             << "\", \"distribution\": \"" << r.distribution << "\", \"size\": " << r.size
+             << ", \"operation\": \"" << r.operation << "\", \"hit_ratio\": " << r.hitRatio
+             << ", \"ops\": " << r.ops << ", \"ns_per_op\": " << r.nanosPerOp << "}"
+             << ((i + 1 < results.size()) ? ",\n" : "\n");
+    }
+    if (json)
+    {
+        file << "]\n";
+    }
+    return (bool)file;
+}
+
+/**
+ * @brief runs the operations suite for all the sizes up to maxSize and saves the results
+ * @param path - the path of the results file
+ * @param maxSize - the largest number of pairs
+ * @return 0 if the results were saved, 1 otherwise
+ */
+int runSuite(const std::string& path, int maxSize)
+{
+    std::cout << std::left << std::setw(20) << "container" << std::setw(8) << "key"
+              << std::setw(12) << "keys" << std::right << std::setw(10) << "size" << "  "
+              << std::left << std::setw(14) << "operation" << std::right << std::setw(6) << "hits"
+              << std::setw(12) << "ns/op" << std::endl;
+
+    std::vector<SuiteResult> results;
+    for (int size = SUITE_MIN_SIZE; size <= maxSize; size *= SUITE_SIZE_STEP)
+    {
+        for (const std::string distribution : {"sequential", "random", "strided"})
+        {
+            benchmarkKeys<int>("int", distribution, size, results);
+            benchmarkKeys<std::string>("string", distribution, size, results);
+        }
+    }
+
+    if (!writeResults(path, results))
+    {
+        std::cerr << "Can't write " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief counts the cache misses of the calling thread between start() and stop(), with the
+ *        hardware counter of perf_event_open. Where the counter is not available (not Linux, no
+ *        permission, a virtual machine without counters) the count is -1
+ */
+class CacheMissCounter
+{
+public:
+    CacheMissCounter() : _fd(-1)
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~CacheMissCounter() noexcept
+    {
+#ifdef __linux__
+        if (_fd != -1)
+        {
+            close(_fd);
+        }
+#endif
+    }
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    void start()
+    {
+#ifdef __linux__
+        if (_fd != -1)
+        {
+            ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop()
+    {
+        long long count = -1;
+#ifdef __linux__
+        if (_fd != -1)
+        {
+            ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(_fd, &count, sizeof(count)) != (ssize_t)sizeof(count))
+            {
+                count = -1;
+            }
+        }
+#endif
+        return count;
+    }
+
+private:
+    int _fd; // the counter, or -1
+};
+
+/**
+ * @brief builds a map from the keys while the heap is fragmented by other allocations (like the
+ *        temporary strings of a parser), then looks up all the keys in a random order, and prints
+ *        the build and lookup times, the cache misses per lookup and the pages the pairs are on
+ * @tparam Map - the map, from Key to int
+ * @tparam Key - the type of the keys
+ * @param name - the name of the allocator
+ * @param map - an empty map, with the measured allocator
+ * @param keys - the keys
+ */
+template <class Map, class Key>
+void benchmarkArenaBuild(const std::string& name, Map& map, const std::vector<Key>& keys)
+{
+    int size = (int)keys.size();
+    std::mt19937 generator(SUITE_SEED);
+    std::vector<std::string> noise;
+    noise.reserve(size);
+
+    double nanos = timeNanos([&]
+    {
+        for (int i = 0; i < size; i++)
+        {
+            map.insert(keys[i], i);
+            noise.emplace_back(NOISE_MIN_SIZE + generator() % (NOISE_MAX_SIZE - NOISE_MIN_SIZE),
+                               'x');
+        }
+    });
+
+    // Half of the other allocations are freed, the holes are left between the pairs
+    for (int i = 0; i < size; i += 2)
+    {
+        std::string().swap(noise[i]);
+    }
+
+    std::vector<int> order(size);
+    for (int i = 0; i < size; i++)
+    {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), generator);
+    int repeats = std::max(1, ARENA_MIN_LOOKUPS / size);
+
+    CacheMissCounter misses;
+    long long found = 0;
+    misses.start();
+    double lookupNanos = timeNanos([&]
+    {
+        for (int r = 0; r < repeats; r++)
+        {
+            for (int i : order)
+            {
+                found += map.containsKey(keys[i]);
+            }
+            clobberMemory();
+        }
+    });
+    long long missCount = misses.stop();
+    benchSink = benchSink + found;
+
+    // A scan over all the keys, like the phrase by phrase scan of an email
+    double scanNanos = timeNanos([&]
+    {
+        size_t characters = 0;
+        for (int r = 0; r < repeats; r++)
+        {
+            for (const auto& pair : map)
+            {
+                characters += (unsigned char)pair.first[pair.first.size() - 1];
+            }
+            clobberMemory();
+        }
+        benchSink = benchSink + (long long)characters;
+    });
+
+    // The pages of the pairs and of the characters of the keys
+    std::unordered_set<uintptr_t> pages;
+    for (const auto& pair : map)
+    {
+        pages.insert((uintptr_t)&pair >> PAGE_SHIFT);
+        pages.insert((uintptr_t)pair.first.data() >> PAGE_SHIFT);
+    }
+
+    double lookups = (double)repeats * size;
+    std::cout << std::left << std::setw(34) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << nanos / size
+              << std::setw(12) << lookupNanos / lookups << std::setw(12) << scanNanos / lookups;
+    if (missCount < 0)
+    {
+        std::cout << std::setw(16) << "n/a";
+    }
+    else
+    {
+        std::cout << std::setprecision(3) << std::setw(16) << (double)missCount / lookups;
+    }
+    std::cout << std::setprecision(1) << std::setw(14)
+              << (double)pages.size() / (size / PAIRS_PER_ROW) << std::endl;
+}
+
+/**
+ * @brief returns the number of bytes that are allocated from the heap now
+ * @return the number of bytes, or -1 where it is not available
+ */
+long long heapBytesInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return (long long)(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief prints the heap that a table took per pair
+ * @param name - the name of the table
+ * @param before - the bytes of the heap before the table was built
+ * @param numOfPairs - the number of pairs of the table
+ */
+void printTableBytes(const std::string& name, long long before, int numOfPairs)
+{
+    long long after = heapBytesInUse();
+    std::cout << std::left << std::setw(34) << name << std::right << std::setw(14);
+    if (before < 0 || after < 0)
+    {
+        std::cout << "n/a" << std::endl;
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(1) << (double)(after - before) / numOfPairs
+              << std::endl;
+}
+
+/**
+ * @brief compares a table of phrase-like string keys with the default allocator, in an arena and
+ *        in a StringPoolMap
+ * @param numOfPairs - the number of pairs
+ */
+void benchmarkArena(int numOfPairs)
+{
+    std::vector<std::string> keys(numOfPairs);
+    std::vector<std::pmr::string> pmrKeys(numOfPairs);
+    for (int i = 0; i < numOfPairs; i++)
+    {
+        keys[i] = "a phrase of the database, number " + std::to_string(i);
+        pmrKeys[i] = keys[i];
+    }
+
+    std::cout << "arena, " << numOfPairs << " pairs" << std::endl;
+    std::cout << std::left << std::setw(34) << "allocator" << std::right << std::setw(12)
+              << "build ns" << std::setw(12) << "lookup ns" << std::setw(12) << "scan ns"
+              << std::setw(16) << "misses/lookup"
+              << std::setw(14) << "pages/1K" << std::endl;
+    {
+        HashMap<std::string, int> map;
+        benchmarkArenaBuild("std::allocator", map, keys);
+    }
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        PmrHashMap<std::string, int> map{
+                std::pmr::polymorphic_allocator<std::pair<std::string, int>>(&arena)};
+        benchmarkArenaBuild("arena (std::string keys)", map, keys);
+    }
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        PmrHashMap<std::pmr::string, int> map{
+                std::pmr::polymorphic_allocator<std::pair<std::pmr::string, int>>(&arena)};
+        benchmarkArenaBuild("arena (std::pmr::string keys)", map, pmrKeys);
+    }
+    {
+        StringPoolMap<int> map;
+        benchmarkArenaBuild("string pool", map, keys);
+    }
+
+    // The heap of each table, the allocations of a table are measured while nothing else is
+    // allocated
+    std::vector<int> values(numOfPairs);
+    for (int i = 0; i < numOfPairs; i++)
+    {
+        values[i] = i;
+    }
+    std::cout << std::left << std::setw(34) << "table" << std::right << std::setw(14)
+              << "heap/pair" << std::endl;
+    {
+        long long before = heapBytesInUse();
+        HashMap<std::string, int> map(keys, values);
+        printTableBytes("std::allocator", before, numOfPairs);
+    }
+    {
+        long long before = heapBytesInUse();
+        std::pmr::monotonic_buffer_resource arena;
+        PmrHashMap<std::pmr::string, int> map(
+                pmrKeys, values,
+                std::pmr::polymorphic_allocator<std::pair<std::pmr::string, int>>(&arena));
+        printTableBytes("arena (std::pmr::string keys)", before, numOfPairs);
+    }
+    {
+        long long before = heapBytesInUse();
+        StringPoolMap<int> map(keys, values);
+        printTableBytes("string pool", before, numOfPairs);
+    }
+}
+
+/**
+ * @brief times a full iteration and begin() over a HashMap of the given number of pairs, with the
+ *        buckets of every measured load factor
+ * @param numOfPairs - the number of pairs
+ */
+void benchmarkSparseIteration(int numOfPairs)
+{
+    const double loads[] = {0.75, 0.25, 0.05, 0.01, 0.001};
+
+    std::cout << "sparse iteration, " << numOfPairs << " pairs" << std::endl;
+    std::cout << std::right << std::setw(12) << "load" << std::setw(12) << "buckets"
+              << std::setw(16) << "iterate ns/pair" << std::setw(12) << "begin ns" << std::endl;
+    for (double load : loads)
+    {
+        HashMap<int, int> map;
+        map.rehash((int)(numOfPairs / load));
+        for (int i = 0; i < numOfPairs; i++)
+        {
+            map.insert((int)mixKey((uint64_t)i), i);
+        }
+        const HashMap<int, int>& constMap = map;
+
+        // The map is iterated again until enough pairs were visited to time it
+        int repeats = std::max(1, SPARSE_MIN_TIMED_PAIRS / std::max(1, numOfPairs));
+        long long sum = 0;
+        double iterateNanos = timeNanos([&]
+        {
+            for (int r = 0; r < repeats; r++)
+            {
+                for (auto it = constMap.begin(); it != constMap.end(); ++it)
+                {
+                    sum += it->second;
+                }
+                clobberMemory();
+            }
+        });
+
+        double beginNanos = timeNanos([&]
+        {
+            for (int i = 0; i < SPARSE_BEGIN_CALLS; i++)
+            {
+                sum += constMap.begin()->second;
+                clobberMemory();
+            }
+        });
+        benchSink = benchSink + sum;
+
+        std::cout << std::right << std::fixed << std::setprecision(3) << std::setw(12)
+                  << constMap.getLoadFactor() << std::setw(12) << constMap.capacity()
+                  << std::setprecision(1) << std::setw(16)
+                  << iterateNanos / ((double)repeats * numOfPairs) << std::setw(12)
+                  << beginNanos / SPARSE_BEGIN_CALLS << std::endl;
+    }
+}
+
+/**
+ * @brief runs the benchmarks
+ * @param argc - the number of arguments
+ * @param argv - the arguments (optional: the number of pairs, or --suite and it's arguments)
+ * @return 0 if success, 1 if failure
+ */
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == SUITE_OPTION)
+    {
+        if (argc < 3 || argc > 4)
+        {
+            std::cout << USAGE_ERR << std::endl;
+            return EXIT_FAILURE;
+        }
+        int maxSize = (argc > 3) ? std::atoi(argv[3]) : SUITE_MAX_SIZE;
+        return runSuite(argv[2], (maxSize <= 0) ? SUITE_MAX_SIZE : maxSize);
+    }
+    if (argc > 1 && std::string(argv[1]) == ARENA_OPTION)
+    {
+        int numOfPairs = (argc > 2) ? std::atoi(argv[2]) : DEFAULT_NUM_OF_ARENA_PAIRS;
+        benchmarkArena((numOfPairs <= 0) ? DEFAULT_NUM_OF_ARENA_PAIRS : numOfPairs);
+        return EXIT_SUCCESS;
+    }
+    if (argc > 1 && std::string(argv[1]) == SPARSE_OPTION)
+    {
+        int numOfPairs = (argc > 2) ? std::atoi(argv[2]) : DEFAULT_NUM_OF_SPARSE_PAIRS;
+        benchmarkSparseIteration((numOfPairs <= 0) ? DEFAULT_NUM_OF_SPARSE_PAIRS : numOfPairs);
+        return EXIT_SUCCESS;
+    }
+
+    int numOfPairs = (argc > 1) ? std::atoi(argv[1]) : DEFAULT_NUM_OF_PAIRS;
+    if (numOfPairs <= 0)
+    {
+        numOfPairs = DEFAULT_NUM_OF_PAIRS;
+    }
+
+    std::cout << "resize latency, " << numOfPairs << " pairs (microseconds)" << std::endl;
+    std::cout << std::left << std::setw(24) << "operation" << std::right
+              << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+              << std::setw(10) << "p99.99" << std::setw(14) << "max" << std::endl;
+
+    benchmarkResizeLatency(numOfPairs, false);
+    benchmarkResizeLatency(numOfPairs, true);
+
+    std::cout << std::endl << "concurrent lookups, " << numOfPairs << " pairs, "
+              << std::thread::hardware_concurrency() << " hardware threads (millions per second)"
+              << std::endl;
+    std::cout << std::right << std::setw(8) << "readers" << std::setw(16) << "lookups"
+              << std::setw(16) << "inserts" << std::setw(10) << "misses" << std::endl;
+    for (int numOfReaders = 1; numOfReaders <= MAX_NUM_OF_READERS; numOfReaders *= 2)
+    {
+        benchmarkConcurrentLookups(numOfPairs, numOfReaders);
+    }
+    return 0;
+}
@@ -0,0 +1,191 @@
+/**
+* @file    HashMapTest.cpp
+* @author  user
+* @version 1.0
+* @brief   Tests for HashMap
+* @section runs a seeded random sequence of insert, insert_or_assign, erase, containsKey and
+*          operator[] on a HashMap and on a std::unordered_map (the reference) and compares them,
+*          and their copies and moves, every few thousand operations. It runs with and without the
+*          membership filter, and with the synchronous and the incremental rehash (with reserve
+*          and rehash calls during migrations), over a small and a large range of keys so the map
+*          grows and shrinks. Then checks the filter with string keys, string_view lookups and an
+*          arena allocator.
+*          Build: g++ -std=c++17 -O1 -g -fsanitize=address,undefined HashMapTest.cpp
+*                 -o HashMapTest
+*          Usage: HashMapTest, exits with EXIT_FAILURE on the first failed check
+*/
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <unordered_map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include <memory_resource>
+#include "HashMap.hpp"
+#include "TestCheck.hpp"
+
+#define NUM_OF_MODES 8
+#define FILTER_MODE 1
+#define INCREMENTAL_MODE 2
+#define WIDE_KEYS_MODE 4
+#define RANDOM_STEPS 200000
+#define NARROW_KEYS 3000
+#define WIDE_KEYS 50000
+#define COMPARE_EVERY 20000
+#define RESIZE_EVERY 7919
+#define MAX_RESERVE 30000
+#define MAX_REHASH 40000
+#define STRING_KEYS 100000
+#define ARENA_KEYS 1000
+
+// ------------------------------------------- functions -------------------------------------------
+
+/**
+ * @brief checks that a map has exactly the pairs of the reference, by lookups and by iteration
+ * @param map - the map
+ * @param reference - the reference
+ */
+static void checkSame(const HashMap<int, int>& map, const std::unordered_map<int, int>& reference)
+{
+    TEST_CHECK(map.size() == (int)reference.size());
+    for (const auto& item : reference)
+    {
+        TEST_CHECK(map.containsKey(item.first));
+        TEST_CHECK(map.at(item.first) == item.second);
+    }
+    int count = 0;
+    for (auto it = map.begin(); it != map.end(); ++it)
+    {
+        auto found = reference.find(it->first);
+        TEST_CHECK(found != reference.end() && found->second == it->second);
+        count++;
+    }
+    TEST_CHECK(count == (int)reference.size());
+}
+
+/**
+ * @brief compares random operations on a HashMap with a std::unordered_map
+ * @param mode - the FILTER_MODE, INCREMENTAL_MODE and WIDE_KEYS_MODE bits of the run
+ */
+static void testRandomOperations(int mode)
+{
+    std::mt19937 random((unsigned int)mode);
+    HashMap<int, int> map;
+    map.setIncrementalRehash((mode & INCREMENTAL_MODE) != 0);
+    map.setMembershipFilter((mode & FILTER_MODE) != 0);
+    std::unordered_map<int, int> reference;
+    int range = (mode & WIDE_KEYS_MODE) ? WIDE_KEYS : NARROW_KEYS;
+    for (int step = 0; step < RANDOM_STEPS; step++)
+    {
+        int key = (int)(random() % range);
+        int operation = (int)(random() % 10);
+        if (operation < 4)
+        {
+            TEST_CHECK(map.insert(key, step) == reference.emplace(key, step).second);
+        }
+        else if (operation < 7)
+        {
+            TEST_CHECK(map.erase(key) == (reference.erase(key) > 0));
+        }
+        else if (operation < 8)
+        {
+            map.insert_or_assign(key, step);
+            reference[key] = step;
+        }
+        else if (operation < 9)
+        {
+            TEST_CHECK(map.containsKey(key) == (reference.count(key) > 0));
+        }
+        else
+        {
+            TEST_CHECK(map[key] == reference[key]);
+        }
+        TEST_CHECK(map.size() == (int)reference.size());
+
+        // Resizes that may land in the middle of a migration
+        if (step % RESIZE_EVERY == 0)
+        {
+            (random() % 2 == 0) ? map.reserve((int)(random() % MAX_RESERVE))
+                                : map.rehash((int)(random() % MAX_REHASH));
+        }
+        if (step % COMPARE_EVERY == 0)
+        {
+            checkSame(map, reference);
+            HashMap<int, int> copy(map);
+            checkSame(copy, reference);
+            TEST_CHECK(copy == map);
+            HashMap<int, int> moved(std::move(copy));
+            checkSame(moved, reference);
+            copy = moved;
+            checkSame(copy, reference);
+        }
+        if (step == RANDOM_STEPS / 2)
+        {
+            map.setMembershipFilter((mode & FILTER_MODE) == 0);
+            checkSame(map, reference);
+            map.setMembershipFilter((mode & FILTER_MODE) != 0);
+        }
+    }
+    checkSame(map, reference);
+    map.clear();
+    reference.clear();
+    checkSame(map, reference);
+    TEST_CHECK((map.stats().filterBytes > 0) == ((mode & FILTER_MODE) != 0));
+}
+
+/**
+ * @brief checks the membership filter with string keys, string_view lookups and an arena
+ */
+static void testFilter()
+{
+    HashMap<std::string, int> strings;
+    for (int i = 0; i < STRING_KEYS; i++)
+    {
+        strings.insert("key" + std::to_string(i), i);
+    }
+    strings.setMembershipFilter(true);
+    for (int i = 0; i < STRING_KEYS; i++)
+    {
+        TEST_CHECK(strings.containsKey("key" + std::to_string(i)));
+        TEST_CHECK(!strings.containsKey("miss" + std::to_string(i)));
+    }
+    std::string_view text("xkey7x");
+    TEST_CHECK(strings.containsKey(text.substr(1, 4)) && !strings.containsKey(text.substr(0, 4)));
+
+    HashMap<std::string, int> built(std::vector<std::string>{"a", "b"}, std::vector<int>{1, 2});
+    built.setMembershipFilter(true);
+    TEST_CHECK(built.at("a") == 1 && !built.containsKey(std::string_view("c")));
+
+    std::pmr::monotonic_buffer_resource arena;
+    PmrHashMap<std::pmr::string, int> pmrMap{
+            std::pmr::polymorphic_allocator<std::pair<std::pmr::string, int>>(&arena)};
+    pmrMap.setMembershipFilter(true);
+    for (int i = 0; i < ARENA_KEYS; i++)
+    {
+        pmrMap.emplace(std::pmr::string(std::to_string(i)), i);
+    }
+    for (int i = 0; i < 2 * ARENA_KEYS; i++)
+    {
+        TEST_CHECK(pmrMap.containsKey(std::pmr::string(std::to_string(i))) == (i < ARENA_KEYS));
+    }
+    PmrHashMap<std::pmr::string, int> moved(pmrMap.get_allocator());
+    moved = std::move(pmrMap);
+    TEST_CHECK(moved.size() == ARENA_KEYS && moved.containsKey(std::pmr::string("0")));
+}
+
+/**
+ * @brief runs the tests of HashMap
+ * @return EXIT_SUCCESS if all the checks passed
+ */
+int main()
+{
+    for (int mode = 0; mode < NUM_OF_MODES; mode++)
+    {
+        testRandomOperations(mode);
+    }
+    testFilter();
+    std::cout << "HashMapTest: all checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
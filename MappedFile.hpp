@@ -0,0 +1,115 @@
+// MappedFile.hpp
+
+#ifndef CPP_EX3_MAPPEDFILE_HPP
+#define CPP_EX3_MAPPEDFILE_HPP
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <string>
+#include <cstddef>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ------------------------------------------- class declaration -----------------------------------
+
+/**
+ * @brief a read-only memory mapping of a whole file. The file is not read or copied, it's pages
+ *        are loaded by the operating system when they are touched
+ */
+class MappedFile
+{
+public:
+
+    /**
+     * @brief maps the file
+     * @param filePath - the path of the file
+     * @throw std::runtime_error if the file can't be opened or mapped
+     */
+    explicit MappedFile(const std::string& filePath);
+
+    /**
+     * @brief unmaps the file
+     */
+    ~MappedFile() noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief returns the content of the file
+     * @return a pointer to the first byte of the file (nullptr for an empty file)
+     */
+    const char* data() const
+    {
+        return _data;
+    }
+
+    /**
+     * @brief returns the size of the file
+     * @return the size of the file in bytes
+     */
+    size_t size() const
+    {
+        return _size;
+    }
+
+    /**
+     * @brief tells the operating system the file is going to be read from start to end
+     */
+    void adviseSequential() const
+    {
+        if (_size > 0)
+        {
+            madvise(const_cast<char*>(_data), _size, MADV_SEQUENTIAL);
+        }
+    }
+
+private:
+    const char* _data; // the mapped content of the file
+    size_t _size;      // the size of the file
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+inline MappedFile::MappedFile(const std::string& filePath): _data(nullptr), _size(0)
+{
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw std::runtime_error("Can't open " + filePath);
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode))
+    {
+        close(fd);
+        throw std::runtime_error("Not a regular file " + filePath);
+    }
+
+    // An empty file can't be mapped, it is kept as an empty buffer
+    _size = (size_t)fileStat.st_size;
+    if (_size > 0)
+    {
+        void* mapped = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error("Can't map " + filePath);
+        }
+        _data = static_cast<const char*>(mapped);
+    }
+    close(fd);
+}
+
+inline MappedFile::~MappedFile() noexcept
+{
+    if (_data != nullptr)
+    {
+        munmap(const_cast<char*>(_data), _size);
+    }
+}
+
+#endif //CPP_EX3_MAPPEDFILE_HPP
@@ -0,0 +1,292 @@
+// MatchKernel.hpp
+
+#ifndef CPP_EX3_MATCHKERNEL_HPP
+#define CPP_EX3_MATCHKERNEL_HPP
+
+#define KERNEL_FIRST_UPPER_CHAR 65
+#define KERNEL_LAST_UPPER_CHAR 92
+#define KERNEL_LOWER_CASE_OFFSET 32
+#define SSE2_WIDTH 16
+#define AVX2_WIDTH 32
+
+// The vector paths are compiled on x86 with GCC or Clang. SSE2 is always there on x86-64, AVX2 is
+// compiled for the function only and used if the cpu supports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define MATCH_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <cstddef>
+#include <cstring>
+
+// ------------------------------------------- class declaration -----------------------------------
+
+/**
+ * @brief vectorized kernels for case-insensitive phrase matching: case folding (bytes 65..92 to
+ *        lower case, exactly like the scalar check of the program) a whole register at a time, and
+ *        counting of (overlapping) appearances of a phrase in a text, that skips all the positions
+ *        where the first and last bytes of the phrase don't match. Every kernel has an SSE2, an AVX2
+ *        and a scalar version that give identical results, the best one is chosen at runtime
+ */
+class MatchKernel
+{
+public:
+
+    /**
+     * @brief the instruction sets of the kernels
+     */
+    enum Isa
+    {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * @brief returns the best instruction set of the cpu (checked once)
+     * @return the instruction set the kernels use by default
+     */
+    static Isa bestIsa();
+
+    /**
+     * @brief copies bytes and folds the upper case letters to lower case. The source and the
+     *        destination can be the same buffer
+     * @param src - the bytes to fold
+     * @param length - the number of bytes
+     * @param dst - the buffer to write the folded bytes into
+     * @param isa - the instruction set to use
+     */
+    static void foldCopy(const char* src, size_t length, char* dst, Isa isa = bestIsa());
+
+    /**
+     * @brief counts the number of times a phrase appears in a text, the appearances may overlap.
+     *        The bytes are compared as they are, so both should be folded for a case-insensitive
+     *        count
+     * @param text - the text
+     * @param length - the length of the text
+     * @param pattern - the phrase
+     * @param patternLength - the length of the phrase
+     * @param isa - the instruction set to use
+     * @return the number of appearances (the length of the text for an empty phrase)
+     */
+    static int countOccurrences(const char* text, size_t length, const char* pattern,
+                                size_t patternLength, Isa isa = bestIsa());
+
+private:
+
+    // the scalar kernels
+    static void _foldScalar(const char* src, size_t length, char* dst);
+    static int _countScalar(const char* text, size_t length, const char* pattern,
+                            size_t patternLength);
+
+    // checks the middle bytes of a candidate whose first and last bytes match
+    static bool _middleMatches(const char* candidate, const char* pattern, size_t patternLength)
+    {
+        return patternLength <= 2 ||
+               std::memcmp(candidate + 1, pattern + 1, patternLength - 2) == 0;
+    }
+
+#ifdef MATCH_KERNEL_X86
+    // the SSE2 kernels
+    static void _foldSse2(const char* src, size_t length, char* dst);
+    static int _countSse2(const char* text, size_t length, const char* pattern,
+                          size_t patternLength);
+
+    // the AVX2 kernels
+    __attribute__((target("avx2")))
+    static void _foldAvx2(const char* src, size_t length, char* dst);
+    __attribute__((target("avx2")))
+    static int _countAvx2(const char* text, size_t length, const char* pattern,
+                          size_t patternLength);
+#endif
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+inline MatchKernel::Isa MatchKernel::bestIsa()
+{
+#ifdef MATCH_KERNEL_X86
+    static const Isa best = __builtin_cpu_supports("avx2") ? AVX2 : SSE2;
+    return best;
+#else
+    return SCALAR;
+#endif
+}
+
+inline void MatchKernel::foldCopy(const char* src, size_t length, char* dst, Isa isa)
+{
+#ifdef MATCH_KERNEL_X86
+    if (isa == AVX2)
+    {
+        _foldAvx2(src, length, dst);
+        return;
+    }
+    if (isa == SSE2)
+    {
+        _foldSse2(src, length, dst);
+        return;
+    }
+#endif
+    (void)isa;
+    _foldScalar(src, length, dst);
+}
+
+inline int MatchKernel::countOccurrences(const char* text, size_t length, const char* pattern,
+                                         size_t patternLength, Isa isa)
+{
+    // The reference scan finds the empty phrase at every position of the text
+    if (patternLength == 0)
+    {
+        return (int)length;
+    }
+    if (patternLength > length)
+    {
+        return 0;
+    }
+#ifdef MATCH_KERNEL_X86
+    if (isa == AVX2)
+    {
+        return _countAvx2(text, length, pattern, patternLength);
+    }
+    if (isa == SSE2)
+    {
+        return _countSse2(text, length, pattern, patternLength);
+    }
+#endif
+    (void)isa;
+    return _countScalar(text, length, pattern, patternLength);
+}
+
+inline void MatchKernel::_foldScalar(const char* src, size_t length, char* dst)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = src[i];
+        dst[i] = (c >= KERNEL_FIRST_UPPER_CHAR && c <= KERNEL_LAST_UPPER_CHAR)
+                 ? (char)(c + KERNEL_LOWER_CASE_OFFSET) : c;
+    }
+}
+
+inline int MatchKernel::_countScalar(const char* text, size_t length, const char* pattern,
+                                     size_t patternLength)
+{
+    if (patternLength > length)
+    {
+        return 0;
+    }
+
+    // Jumps with memchr from one appearance of the first byte to the next
+    int count = 0;
+    const char* last = text + length - patternLength;
+    const char* curr = text;
+    while (curr <= last)
+    {
+        curr = static_cast<const char*>(std::memchr(curr, pattern[0], last - curr + 1));
+        if (curr == nullptr)
+        {
+            break;
+        }
+        if (curr[patternLength - 1] == pattern[patternLength - 1] &&
+            _middleMatches(curr, pattern, patternLength))
+        {
+            count++;
+        }
+        curr++;
+    }
+    return count;
+}
+
+#ifdef MATCH_KERNEL_X86
+
+inline void MatchKernel::_foldSse2(const char* src, size_t length, char* dst)
+{
+    // The upper case range is compared as signed bytes, the bytes above 127 are negative and stay
+    const __m128i belowFirst = _mm_set1_epi8(KERNEL_FIRST_UPPER_CHAR - 1);
+    const __m128i aboveLast = _mm_set1_epi8(KERNEL_LAST_UPPER_CHAR + 1);
+    const __m128i offset = _mm_set1_epi8(KERNEL_LOWER_CASE_OFFSET);
+    size_t i = 0;
+    for (; i + SSE2_WIDTH <= length; i += SSE2_WIDTH)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(bytes, belowFirst),
+                                        _mm_cmplt_epi8(bytes, aboveLast));
+        bytes = _mm_add_epi8(bytes, _mm_and_si128(isUpper, offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+    }
+    _foldScalar(src + i, length - i, dst + i);
+}
+
+inline int MatchKernel::_countSse2(const char* text, size_t length, const char* pattern,
+                                   size_t patternLength)
+{
+    // Compares a block of positions with the first byte of the phrase and the block that ends the
+    // phrase at each of those positions with the last byte, only the positions where both match are
+    // checked
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[patternLength - 1]);
+    int count = 0;
+    size_t i = 0;
+    for (; i + patternLength - 1 + SSE2_WIDTH <= length; i += SSE2_WIDTH)
+    {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        __m128i blockLast = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(text + i + patternLength - 1));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last)));
+        while (mask != 0)
+        {
+            count += _middleMatches(text + i + __builtin_ctz(mask), pattern, patternLength);
+            mask &= mask - 1;
+        }
+    }
+    return count + _countScalar(text + i, length - i, pattern, patternLength);
+}
+
+__attribute__((target("avx2")))
+inline void MatchKernel::_foldAvx2(const char* src, size_t length, char* dst)
+{
+    const __m256i belowFirst = _mm256_set1_epi8(KERNEL_FIRST_UPPER_CHAR - 1);
+    const __m256i aboveLast = _mm256_set1_epi8(KERNEL_LAST_UPPER_CHAR + 1);
+    const __m256i offset = _mm256_set1_epi8(KERNEL_LOWER_CASE_OFFSET);
+    size_t i = 0;
+    for (; i + AVX2_WIDTH <= length; i += AVX2_WIDTH)
+    {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i isUpper = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, belowFirst),
+                                           _mm256_cmpgt_epi8(aboveLast, bytes));
+        bytes = _mm256_add_epi8(bytes, _mm256_and_si256(isUpper, offset));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+    }
+    _foldSse2(src + i, length - i, dst + i);
+}
+
+__attribute__((target("avx2")))
+inline int MatchKernel::_countAvx2(const char* text, size_t length, const char* pattern,
+                                   size_t patternLength)
+{
+    const __m256i first = _mm256_set1_epi8(pattern[0]);
+    const __m256i last = _mm256_set1_epi8(pattern[patternLength - 1]);
+    int count = 0;
+    size_t i = 0;
+    for (; i + patternLength - 1 + AVX2_WIDTH <= length; i += AVX2_WIDTH)
+    {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        __m256i blockLast = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(text + i + patternLength - 1));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first),
+                                 _mm256_cmpeq_epi8(blockLast, last)));
+        while (mask != 0)
+        {
+            count += _middleMatches(text + i + __builtin_ctz(mask), pattern, patternLength);
+            mask &= mask - 1;
+        }
+    }
+    return count + _countSse2(text + i, length - i, pattern, patternLength);
+}
+
+#endif
+
+#endif //CPP_EX3_MATCHKERNEL_HPP
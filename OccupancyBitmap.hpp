@@ -0,0 +1,168 @@
+// OccupancyBitmap.hpp
+
+#ifndef CPP_EX3_OCCUPANCYBITMAP_HPP
+#define CPP_EX3_OCCUPANCYBITMAP_HPP
+
+#define BITMAP_WORD_BITS 64
+#define BITMAP_WORD_SHIFT 6
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// ------------------------------------------- class declaration -----------------------------------
+
+template <class Alloc = std::allocator<uint64_t>>
+
+/**
+ * @brief a bit per slot of a table (a bucket of a HashMap) that is set while the slot is occupied.
+ *        The next occupied slot is found a 64 bit word at a time with a count of trailing zeros,
+ *        so a sparse table is skipped without reading the slots themselves
+ * @tparam Alloc - the allocator of the words
+ */
+class OccupancyBitmap
+{
+public:
+
+    /**
+     * @brief creates a bitmap of no slots
+     * @param allocator - the allocator of the words
+     */
+    explicit OccupancyBitmap(const Alloc& allocator = Alloc()) : _words(allocator), _count(0)
+    {
+    }
+
+    /**
+     * @brief sizes the bitmap to the given number of slots, all of them empty
+     * @param count - the number of slots
+     */
+    void reset(size_t count)
+    {
+        _words.assign((count + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS, 0);
+        _count = count;
+    }
+
+    /**
+     * @brief frees the words of the bitmap, it has no slots
+     */
+    void release()
+    {
+        std::vector<uint64_t, Alloc>(_words.get_allocator()).swap(_words);
+        _count = 0;
+    }
+
+    /**
+     * @brief marks all the slots as empty
+     */
+    void clear()
+    {
+        std::fill(_words.begin(), _words.end(), 0);
+    }
+
+    /**
+     * @brief marks a slot as occupied
+     * @param index - the index of the slot
+     */
+    void set(size_t index)
+    {
+        _words[index >> BITMAP_WORD_SHIFT] |= (uint64_t)1 << (index & (BITMAP_WORD_BITS - 1));
+    }
+
+    /**
+     * @brief marks a slot as empty
+     * @param index - the index of the slot
+     */
+    void unset(size_t index)
+    {
+        _words[index >> BITMAP_WORD_SHIFT] &= ~((uint64_t)1 << (index & (BITMAP_WORD_BITS - 1)));
+    }
+
+    /**
+     * @brief returns the index of the first occupied slot from the given index on
+     * @param from - the index to search from
+     * @return the index of the slot, or the number of slots if there is no occupied slot
+     */
+    size_t next(size_t from) const;
+
+    /**
+     * @brief returns the number of slots
+     * @return the number of slots
+     */
+    size_t size() const
+    {
+        return _count;
+    }
+
+    /**
+     * @brief returns the number of bytes of the words of the bitmap
+     * @return the number of bytes
+     */
+    size_t bytes() const
+    {
+        return _words.size() * sizeof(uint64_t);
+    }
+
+    /**
+     * @brief exchanges the words of two bitmaps, the bitmaps must have equal allocators
+     * @param other - the other bitmap
+     */
+    void swap(OccupancyBitmap& other) noexcept
+    {
+        _words.swap(other._words);
+        std::swap(_count, other._count);
+    }
+
+private:
+    std::vector<uint64_t, Alloc> _words; // the bits of the slots
+    size_t _count;                       // the number of slots
+
+    // returns the index of the lowest set bit of a word that is not zero
+    static int _lowestBit(uint64_t word);
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+template <class Alloc>
+int OccupancyBitmap<Alloc>::_lowestBit(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while ((word & 1) == 0)
+    {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+template <class Alloc>
+size_t OccupancyBitmap<Alloc>::next(size_t from) const
+{
+    if (from >= _count)
+    {
+        return _count;
+    }
+
+    // The bits of the first word before the index are dropped, then the words are skipped until
+    // one of them has a set bit
+    size_t wordIndex = from >> BITMAP_WORD_SHIFT;
+    uint64_t word = _words[wordIndex] & (~(uint64_t)0 << (from & (BITMAP_WORD_BITS - 1)));
+    while (word == 0)
+    {
+        if (++wordIndex == _words.size())
+        {
+            return _count;
+        }
+        word = _words[wordIndex];
+    }
+    return std::min(_count, (wordIndex << BITMAP_WORD_SHIFT) + (size_t)_lowestBit(word));
+}
+
+#endif //CPP_EX3_OCCUPANCYBITMAP_HPP
@@ -0,0 +1,135 @@
+// RcuPointer.hpp
+
+#ifndef CPP_EX3_RCUPOINTER_HPP
+#define CPP_EX3_RCUPOINTER_HPP
+
+#define FIRST_VERSION 1
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include "EpochReclaimer.hpp"
+
+// ------------------------------------------- class declaration -----------------------------------
+
+template <class T>
+
+/**
+ * @brief a pointer to an immutable object that can be replaced while it is read (read-copy-update).
+ *        Readers take a handle without any lock, and keep using the version they got until the
+ *        handle is destroyed. A writer publishes a new version with an atomic swap, and the old
+ *        version is deleted once no handle uses it
+ * @tparam T - the type of the object
+ */
+class RcuPointer
+{
+public:
+
+    /**
+     * @brief a read of the current version (an RAII guard), the version is not deleted while the
+     *        handle is alive
+     */
+    class ReadHandle
+    {
+    public:
+        /**
+         * @brief starts a read of the current version
+         * @param pointer - the pointer to read
+         */
+        explicit ReadHandle(const RcuPointer& pointer)
+                : _guard(pointer._reclaimer),
+                  _object(pointer._current.load(std::memory_order_acquire))
+        {
+        }
+
+        ReadHandle(const ReadHandle&) = delete;
+        ReadHandle& operator=(const ReadHandle&) = delete;
+
+        const T& operator*() const
+        {
+            return *_object;
+        }
+
+        const T* operator->() const
+        {
+            return _object;
+        }
+
+    private:
+        EpochReclaimer::ReadGuard _guard; // keeps the version alive
+        const T* _object;                 // the version that is read
+    };
+
+    /**
+     * @brief creates a pointer to the first version
+     * @param object - the first version
+     */
+    explicit RcuPointer(std::unique_ptr<T> object);
+
+    /**
+     * @brief deletes the current version, there must be no readers
+     */
+    ~RcuPointer() noexcept;
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    /**
+     * @brief replaces the current version. Readers that already have a handle go on with the old
+     *        version, new readers get the new one. Waits until the old version is not used, and
+     *        deletes it (the readers don't wait)
+     * @param object - the new version
+     * @return the number of the new version
+     */
+    uint64_t publish(std::unique_ptr<T> object);
+
+    /**
+     * @brief returns the number of the current version (the first version is FIRST_VERSION)
+     * @return the number of the current version
+     */
+    uint64_t version() const
+    {
+        return _version.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<T*> _current;           // the current version
+    std::atomic<uint64_t> _version;     // the number of the current version
+    std::mutex _publishMutex;           // one publish at a time
+    mutable EpochReclaimer _reclaimer;  // deletes the old versions
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+template <class T>
+RcuPointer<T>::RcuPointer(std::unique_ptr<T> object) : _current(object.release()),
+                                                       _version(FIRST_VERSION)
+{
+}
+
+template <class T>
+RcuPointer<T>::~RcuPointer() noexcept
+{
+    delete _current.load(std::memory_order_relaxed);
+}
+
+template <class T>
+uint64_t RcuPointer<T>::publish(std::unique_ptr<T> object)
+{
+    uint64_t version;
+    {
+        std::lock_guard<std::mutex> lock(_publishMutex);
+        T* old = _current.exchange(object.release(), std::memory_order_acq_rel);
+        version = _version.fetch_add(1, std::memory_order_acq_rel) + 1;
+        _reclaimer.retire(old);
+    }
+
+    // The wait for the readers of the old version is paid by the writer
+    _reclaimer.reclaim();
+    return version;
+}
+
+#endif //CPP_EX3_RCUPOINTER_HPP
@@ -0,0 +1,233 @@
+// RollingHashMatcher.hpp
+
+#ifndef CPP_EX3_ROLLINGHASHMATCHER_HPP
+#define CPP_EX3_ROLLINGHASHMATCHER_HPP
+
+#define ROLLING_HASH_BASE 0x100000001b3ULL
+#define ROLLING_LENGTH_MIX 0x9e3779b97f4a7c15ULL
+#define NO_CANDIDATE (-1)
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include "HashMap.hpp"
+#include "MatchKernel.hpp"
+
+// ------------------------------------------- class declaration -----------------------------------
+
+/**
+ * @brief a multi-pattern matcher over a table of scored phrases that is built on a HashMap. The
+ *        phrases are grouped by their length, and a rolling hash of the last bytes of the text is
+ *        kept for every distinct length. At every byte of the text the hash of each length is
+ *        looked up in a map of (length, hash) to the phrases, and the bytes of the candidates are
+ *        compared. A scan costs one lookup per byte per distinct length, however many phrases
+ *        there are. Phrases are matched case-insensitively and may overlap, like the phrase by
+ *        phrase scan
+ */
+class RollingHashMatcher
+{
+public:
+
+    /**
+     * @brief builds the matcher from a map of phrases and their scores
+     * @tparam MapT - a map type that can be iterated over pairs of <std::string, int>
+     * @param phrases - the phrases and their scores
+     */
+    template <class MapT>
+    explicit RollingHashMatcher(const MapT& phrases);
+
+    /**
+     * @brief calculates the total score of a text (times each phrase appears * it's score)
+     * @param text - the text to score
+     * @return the total score of the text
+     */
+    int score(const std::string& text) const;
+
+    /**
+     * @brief counts the number of times each phrase appears in the text
+     * @param text - the text to scan
+     * @return a vector with the number of appearances of each phrase, by the phrase id (the order
+     *         the phrases were given in)
+     */
+    std::vector<int> countMatches(const std::string& text) const;
+
+    /**
+     * @brief returns the number of phrases in the matcher
+     * @return the number of phrases
+     */
+    int patternCount() const
+    {
+        return (int)_patterns.size();
+    }
+
+    /**
+     * @brief returns the number of distinct lengths of the phrases (the number of lookups per
+     *        byte of a text)
+     * @return the number of distinct lengths
+     */
+    int lengthCount() const
+    {
+        return (int)_lengths.size();
+    }
+
+private:
+    std::vector<std::string> _patterns;   // the folded phrases, by id
+    std::vector<int> _scores;             // the scores of the phrases, by id
+    std::vector<size_t> _lengths;         // the distinct lengths of the phrases, sorted
+    std::vector<uint64_t> _topPowers;     // ROLLING_HASH_BASE^(length - 1) for every length
+    HashMap<uint64_t, int> _firstCandidate; // the first phrase with each (length, hash) key
+    std::vector<int> _nextCandidate;      // the next phrase with the same key, by id
+
+    // returns the rolling hash of bytes
+    static uint64_t _hashOf(const char* data, size_t length);
+
+    // returns the key of a phrase of the given length and rolling hash in _firstCandidate
+    static uint64_t _keyOf(size_t length, uint64_t hash)
+    {
+        return hash ^ ((uint64_t)length * ROLLING_LENGTH_MIX);
+    }
+
+    // calls onMatch(id) for every appearance of every phrase in the text
+    template <class F>
+    void _forEachMatch(const std::string& text, F onMatch) const;
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+template <class MapT>
+RollingHashMatcher::RollingHashMatcher(const MapT& phrases)
+{
+    for (auto it = phrases.begin(); it != phrases.end(); it++)
+    {
+        std::string pattern(it->first);
+        MatchKernel::foldCopy(pattern.data(), pattern.size(), &pattern[0]);
+        _patterns.push_back(std::move(pattern));
+        _scores.push_back(it->second);
+    }
+
+    // Links the phrases with the same key, an empty phrase never matches
+    _firstCandidate.reserve((int)_patterns.size());
+    _nextCandidate.assign(_patterns.size(), NO_CANDIDATE);
+    for (int id = (int)_patterns.size() - 1; id >= 0; id--)
+    {
+        const std::string& pattern = _patterns[id];
+        if (pattern.empty())
+        {
+            continue;
+        }
+        uint64_t key = _keyOf(pattern.size(), _hashOf(pattern.data(), pattern.size()));
+        auto found = _firstCandidate.try_emplace(key, id);
+        if (!found.second)
+        {
+            _nextCandidate[id] = found.first->second;
+            _firstCandidate.insert_or_assign(key, id);
+        }
+        _lengths.push_back(pattern.size());
+    }
+    // Almost all the lookups of a scan are of windows that are not phrases, the filter of the
+    // map rejects most of them without reading it's buckets
+    _firstCandidate.setMembershipFilter(true);
+
+    std::sort(_lengths.begin(), _lengths.end());
+    _lengths.erase(std::unique(_lengths.begin(), _lengths.end()), _lengths.end());
+
+    for (size_t length : _lengths)
+    {
+        uint64_t power = 1;
+        for (size_t i = 1; i < length; i++)
+        {
+            power *= ROLLING_HASH_BASE;
+        }
+        _topPowers.push_back(power);
+    }
+}
+
+inline uint64_t RollingHashMatcher::_hashOf(const char* data, size_t length)
+{
+    uint64_t hash = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = hash * ROLLING_HASH_BASE + (unsigned char)data[i];
+    }
+    return hash;
+}
+
+template <class F>
+void RollingHashMatcher::_forEachMatch(const std::string& text, F onMatch) const
+{
+    if (_lengths.empty() || text.empty())
+    {
+        return;
+    }
+
+    std::string folded(text.size(), '\0');
+    MatchKernel::foldCopy(text.data(), text.size(), &folded[0]);
+    const char* data = folded.data();
+
+    // The hash of the last bytes of the text, for every length. The hashes are all computed the
+    // same way (mod 2^64), so a hash of a window is the hash of the phrase with the same bytes
+    std::vector<uint64_t> hashes(_lengths.size(), 0);
+    for (size_t end = 0; end < folded.size(); end++)
+    {
+        uint64_t in = (unsigned char)data[end];
+        for (size_t g = 0; g < _lengths.size(); g++)
+        {
+            size_t length = _lengths[g];
+            if (end >= length)
+            {
+                hashes[g] -= (uint64_t)(unsigned char)data[end - length] * _topPowers[g];
+            }
+            hashes[g] = hashes[g] * ROLLING_HASH_BASE + in;
+            if (end + 1 < length)
+            {
+                continue;
+            }
+
+            HashMap<uint64_t, int>::const_iterator found = _firstCandidate.find(
+                    _keyOf(length, hashes[g]));
+            if (found == _firstCandidate.end())
+            {
+                continue;
+            }
+
+            // Compares the bytes of the candidates, different phrases may have the same key
+            const char* window = data + end + 1 - length;
+            for (int id = found->second; id != NO_CANDIDATE; id = _nextCandidate[id])
+            {
+                const std::string& pattern = _patterns[id];
+                if (pattern.size() == length && std::memcmp(window, pattern.data(), length) == 0)
+                {
+                    onMatch(id);
+                }
+            }
+        }
+    }
+}
+
+inline int RollingHashMatcher::score(const std::string& text) const
+{
+    int total = 0;
+    _forEachMatch(text, [this, &total](int id)
+    {
+        total += _scores[id];
+    });
+    return total;
+}
+
+inline std::vector<int> RollingHashMatcher::countMatches(const std::string& text) const
+{
+    std::vector<int> counts(_patterns.size(), 0);
+    _forEachMatch(text, [&counts](int id)
+    {
+        counts[id]++;
+    });
+    return counts;
+}
+
+#endif //CPP_EX3_ROLLINGHASHMATCHER_HPP
@@ -0,0 +1,162 @@
+/**
+* @file    RollingHashMatcherTest.cpp
+* @author  user
+* @version 1.0
+* @brief   Tests for RollingHashMatcher
+* @section builds random phrase tables (of a small alphabet with upper and lower case letters,
+*          the folded bytes '[' and '\', ']' that is not folded and a byte above 0x7F, so phrases
+*          overlap, repeat in other cases and share their lengths) and random texts of the same
+*          alphabet, and compares the counts and the scores of the RollingHashMatcher with the
+*          AhoCorasick automaton and with a naive count of the overlapping appearances of every
+*          phrase.
+*          Build: g++ -std=c++17 -O1 -g -fsanitize=address,undefined RollingHashMatcherTest.cpp
+*                 -o RollingHashMatcherTest
+*          Usage: RollingHashMatcherTest, exits with EXIT_FAILURE on the first failed check
+*/
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <string>
+#include <vector>
+#include <random>
+#include "RollingHashMatcher.hpp"
+#include "AhoCorasick.hpp"
+#include "HashMap.hpp"
+#include "TestCheck.hpp"
+
+#define TEST_SEED 9
+#define NUM_OF_TABLES 200
+#define MAX_PHRASES 40
+#define MAX_PHRASE_LENGTH 12
+#define MAX_TEXT_LENGTH 400
+#define MAX_SCORE 5
+#define ALPHABET "abAB[\\]\xC3"
+#define ALPHABET_SIZE_OF_TEST 8
+#define FOLD_FIRST 'A'
+#define FOLD_LAST '\\'
+#define FOLD_DISTANCE ('a' - 'A')
+
+// ------------------------------------------- functions -------------------------------------------
+
+/**
+ * @brief folds a string like the matchers do (the bytes from 'A' to '\' to lower case)
+ * @param text - the string
+ * @return the folded string
+ */
+static std::string fold(const std::string& text)
+{
+    std::string folded(text);
+    for (char& c : folded)
+    {
+        if (c >= FOLD_FIRST && c <= FOLD_LAST)
+        {
+            c = (char)(c + FOLD_DISTANCE);
+        }
+    }
+    return folded;
+}
+
+/**
+ * @brief counts the overlapping appearances of a phrase in a text, one position at a time
+ * @param text - the folded text
+ * @param phrase - the folded phrase
+ * @return the number of appearances (0 for an empty phrase)
+ */
+static int naiveCount(const std::string& text, const std::string& phrase)
+{
+    int count = 0;
+    for (size_t start = 0; !phrase.empty() && start + phrase.size() <= text.size(); start++)
+    {
+        if (text.compare(start, phrase.size(), phrase) == 0)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief makes a random string of the alphabet of the test
+ * @param random - the random generator
+ * @param length - the length of the string
+ * @return the string
+ */
+static std::string randomString(std::mt19937& random, int length)
+{
+    std::string result;
+    for (int i = 0; i < length; i++)
+    {
+        result += ALPHABET[random() % ALPHABET_SIZE_OF_TEST];
+    }
+    return result;
+}
+
+/**
+ * @brief compares the rolling hash matcher with the automaton and the naive count on random
+ *        phrase tables and texts
+ */
+static void testRandomTables()
+{
+    std::mt19937 random(TEST_SEED);
+    for (int table = 0; table < NUM_OF_TABLES; table++)
+    {
+        HashMap<std::string, int> phrases;
+        int numOfPhrases = 1 + (int)(random() % MAX_PHRASES);
+        for (int i = 0; i < numOfPhrases; i++)
+        {
+            phrases.insert_or_assign(randomString(random, 1 + (int)(random() % MAX_PHRASE_LENGTH)),
+                                     (int)(random() % MAX_SCORE));
+        }
+        RollingHashMatcher rolling(phrases);
+        AhoCorasick automaton(phrases);
+
+        for (int text = 0; text < MAX_PHRASES; text++)
+        {
+            std::string email = randomString(random, (int)(random() % MAX_TEXT_LENGTH));
+            std::string folded = fold(email);
+            std::vector<int> expected;
+            int expectedScore = 0;
+            for (auto it = phrases.begin(); it != phrases.end(); ++it)
+            {
+                expected.push_back(naiveCount(folded, fold(it->first)));
+                expectedScore += expected.back() * it->second;
+            }
+            TEST_CHECK(rolling.countMatches(email) == expected);
+            TEST_CHECK(automaton.countMatches(email) == expected);
+            TEST_CHECK(rolling.score(email) == expectedScore);
+            TEST_CHECK(automaton.score(email) == expectedScore);
+        }
+    }
+}
+
+/**
+ * @brief checks the edge cases: an empty table, an empty text, phrases longer than the text and
+ *        phrases that differ only in their case
+ */
+static void testEdgeCases()
+{
+    HashMap<std::string, int> empty;
+    RollingHashMatcher noPhrases(empty);
+    TEST_CHECK(noPhrases.score("abc") == 0 && noPhrases.countMatches("abc").empty());
+
+    HashMap<std::string, int> phrases;
+    phrases.insert("Hello", 2);
+    phrases.insert("hELLO", 3);
+    phrases.insert("a much longer phrase than the text", 7);
+    phrases.insert("l", 1);
+    RollingHashMatcher rolling(phrases);
+    TEST_CHECK(rolling.score("") == 0);
+    TEST_CHECK(rolling.score("HELLO hello") == 2 * 2 + 2 * 3 + 4 * 1);
+}
+
+/**
+ * @brief runs the tests of RollingHashMatcher
+ * @return EXIT_SUCCESS if all the checks passed
+ */
+int main()
+{
+    testRandomTables();
+    testEdgeCases();
+    std::cout << "RollingHashMatcherTest: all checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -1,313 +1,1992 @@
-/**
-* @file    SpamDetector.cpp
-* @author  user
-* @version 1.0
-* @brief   The program gets a file with 'bad sentences', an email file and threshold, and checks if
-*          the email file is spam
-* @section calculates the total score of the email file (times each bad sentence appears * it's
-*          score), if the total score is bigger then the threshold - the file is spam
-*/
-
-// -------------------------------------- includes -------------------------------------------------
-
-#include <iostream>
-#include <list>
-#include <vector>
-#include "HashMap.hpp"
-#include <boost/tokenizer.hpp>
-#include <string>
-#include <fstream>
-#include <sstream>
-#include <boost/filesystem.hpp>
-
-#define USAGE_ERR         "Usage: SpamDetector <database path> <message path> <threshold>"
-#define INVALID_INPUT_ERR "Invalid input"
-#define SPAM_STR "SPAM"
-#define NOT_SPAM_STR "NOT_SPAM"
-#define NUMBER_OF_ARGS 4
-#define DEFAULT_NUM_OF_ARGS_IN_LINE 2
-#define INVALID_THRESHOLD 0
-#define MIN_TIMES_CHAR 1
-
-// ------------------------------------------- function declaration --------------------------------
-
-/**
- * @brief gets a string and checks if the string is valid
- * @param value - the string to check
- * @return - true if the string is valid, false otherwise
- */
-bool isValidString(std::string& value)
-{
-    // check if the string contains only integers
-    for (char j : value)
-    {
-        if (((j < '0') || (j > '9')))
-        {
-            return false;
-        }
-    }
-    return true;
-}
-
-/**
- * @brief gets a path to a database file, reads the file and saves each sentence and it's score
- *        into hashMap
- * @param filePath - the path to the database file
- * @param hashMap  - the Hash Map to save the values into
- */
-void readDataBaseFile(std::string& filePath, HashMap<std::string, int>& hashMap)
-{
-    // Checks if the db file exists
-    if (!boost::filesystem::exists(filePath))
-    {
-        throw std::exception();
-    }
-
-    // Opens the file
-    std::ifstream fout;
-    fout.open(filePath);
-
-    // go over the file , reads each pair and saves in the map
-    std::string currLine;
-    typedef boost::tokenizer<boost::char_separator<char>> tokenizer;
-    boost::char_separator<char> sep{","};
-
-    std::vector<std::string> valuesInLineArray; // array of items in each line
-    std::vector<std::string> keys;
-    std::vector<int> values;
-
-    // Reads information while the file isn't empty
-    while (getline(fout, currLine))
-    {
-        char toCheck = ',';
-        int count = 0;
-
-        // Checks if the char ',' appears more than one time in the line (more than two columns)
-        for (int i = 0; i < (int)currLine.size(); i++)
-        {
-            // Checks if the current char equals ','
-            if (currLine[i] == toCheck)
-            {
-                count++;
-            }
-        }
-
-        // Checks if there are exactly two columns in the line
-        if (count != MIN_TIMES_CHAR)
-        {
-            fout.close();
-            throw std::exception();
-        }
-
-        // creates a tokenizer object to separate the line
-        tokenizer tokenizer1{currLine, sep};
-
-        // Inserts the values in the line into an array
-        for (const auto &item : tokenizer1)
-        {
-            valuesInLineArray.push_back((item));
-        }
-
-        // Checks if the size of arguments in line is correct
-        if ((int) valuesInLineArray.size() != DEFAULT_NUM_OF_ARGS_IN_LINE)
-        {
-            fout.close();
-            throw std::exception();
-        }
-
-        std::string keyStr   = valuesInLineArray[0]; // saves the string in the current line
-        std::string valueStr = valuesInLineArray[1]; // saves the score in the current line
-
-        // Checks if the score string is valid
-        if (!isValidString(valueStr))
-        {
-            fout.close();
-            throw std::exception();
-        }
-
-        // Converts the score string to integer
-        std::stringstream s(valueStr);
-        double valueScore = 0;
-        s >> valueScore;
-
-        keys.push_back(keyStr);
-        values.push_back(valueScore);
-        valuesInLineArray.clear();
-    }
-
-    HashMap<std::string, int> hashMap1(keys, values);
-    hashMap = hashMap1;
-    fout.close();
-} // end of readDataBaseFile function
-
-/**
- * @brief gets a path to an email text file, reads the file and saves the text into a string
- * @param filePath - the path for the email text file
- * @param strEmail - the string to save the text into
- */
-void readEmailFile(std::string& filePath, std::string& strEmail)
-{
-    // Checks if the file exists
-    if (!boost::filesystem::exists(filePath))
-    {
-         throw std::exception();
-    }
-
-    // Opens the file
-    std::ifstream fout;
-    fout.open(filePath);
-    std::string currLine;
-
-    // Reads information while the file isn't empty and saves into the string
-    while (getline(fout, currLine))
-    {
-        strEmail += currLine;
-    }
-    fout.close();
-}
-
-/**
- * @brief function that gets a hash map with sentences and a string, counts the number of times each
- *        sentence appears in the string, multiplies by the string's score and counts the total
- *        score of the email file
- * @param stringsMap - a hash map that contains pairs of strings and their score
- * @param stringEmail - a string that contains the text in the email file
- * @return - the total score
- */
-int findStringsInEmail( HashMap<std::string, int>& stringsMap,  std::string& stringEmail)
-{
-    int totalScoreOfEmail = 0;
-
-   // Goes over the words in the map. Counts the appearance of each word in the email string and
-   // saves the total score
-   for (HashMap<std::string, int>::const_iterator it = stringsMap.begin(); it != stringsMap.end
-   (); it++)
-   {
-        std::string strValue = it->first;
-        int count = 0; // counts the number of times the string appears in the email file
-
-        // Goes over the string and changes every upper letter to lower letter
-        for (int j = 0; j < (int)strValue.length(); j++)
-        {
-            if (strValue[j] >= 65 && strValue[j] <= 92)
-            {
-                strValue[j] = strValue[j] + 32;
-            }
-        }
-
-        int strLength        = strValue.length();
-        int lengthOfEmailStr = stringEmail.length();
-
-        // Goes over the email string and counts how many times the string appears in the email
-        // string
-        for (int i = 0; i < lengthOfEmailStr; i++)
-        {
-            std::string currSubString = stringEmail.substr(i , strLength); // current sub string
-
-            // Go over the sub string, change upper letters to lower letters
-            for (int j = 0; j < (int)currSubString.length(); j++)
-            {
-                if (currSubString[j] >= 65 && currSubString[j] <= 92)
-                {
-                    currSubString[j] = currSubString[j] + 32;
-                }
-            }
-
-            // Checks if the current sub string equals the string
-            if (currSubString == strValue)
-            {
-                count++;
-            }
-        }
-
-        int scoreOfStr = count * it->second;
-        totalScoreOfEmail += scoreOfStr;
-   }
-    return totalScoreOfEmail;
-} // end of findStringsInEmail function
-
-/**
- * @brief the main function. Gets a path to a db file and a text file and a threshold number. Reads
- *        the db file and saves the values in a hash map. Then it counts how many times each string
- *        in the db file appears in the email file, calculates the total score and prints if the
- *        text file is a spam file or not.
- * @param argc - the number of arguments
- * @param argv - the arguments
- * @return 0 if success, 1 if failure
- */
-int main(int argc, char *argv[])
-{
-    // Checks if the number of arguments is not valid
-    if (argc != NUMBER_OF_ARGS)
-    {
-        std::cout << USAGE_ERR << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
-    std::string dataBaseFilePath = argv[1];
-    std::string emailFilePath = argv[2];
-    std::string thresholdStr = argv[3];
-
-    // check validity for threshold,  etc. contains only integers
-    if (!isValidString(thresholdStr))
-    {
-        std::cerr << INVALID_INPUT_ERR << std::endl;
-        return EXIT_FAILURE;
-    }
-
-    // Converts the string to integer
-    std::stringstream s(thresholdStr);
-    double threshold = 0;
-    s >> threshold;
-
-    // Checks if the conversion worked
-    if (s.fail())
-    {
-        std::cerr << INVALID_INPUT_ERR << std::endl;
-        exit(EXIT_FAILURE);
-    }
-
-    // Checks if the threshold equals zero
-    if (threshold == INVALID_THRESHOLD)
-    {
-        std::cerr << INVALID_INPUT_ERR << std::endl;
-        return EXIT_FAILURE;
-    }
-
-    HashMap<std::string, int> stringsMap;
-
-    try
-    {
-        readDataBaseFile(dataBaseFilePath, stringsMap);
-    }
-    catch(std::exception& e)
-    {
-        std::cerr << INVALID_INPUT_ERR << std::endl;
-        return EXIT_FAILURE;
-    }
-
-    std::string strEmail;
-    try
-    {
-        readEmailFile(emailFilePath, strEmail);
-    }
-    catch (std::exception& e)
-    {
-        std::cerr << INVALID_INPUT_ERR << std::endl;
-        return EXIT_FAILURE;
-    }
-
-    int totalScore = findStringsInEmail(stringsMap, strEmail);
-
-    // Checks if the threshold is lower than the total score
-    if (threshold <= totalScore)
-    {
-        std::cout << SPAM_STR << std::endl;
-    }
-    else
-    {
-        std::cout << NOT_SPAM_STR << std::endl;
-    }
-
-    return 0;
-}
+/**
+* @file    SpamDetector.cpp
+* @author  user
+* @version 1.0
+* @brief   The program gets a file with 'bad sentences', an email file and threshold, and checks if
+*          the email file is spam
+* @section calculates the total score of the email file (times each bad sentence appears * it's
+*          score), if the total score is bigger then the threshold - the file is spam.
+*          In batch mode (--batch) the database is loaded once and many email files are checked in
+*          parallel, one output line per email file. The database can be compiled once
+*          (--compile) into a snapshot file that is mapped at startup instead of parsed.
+*          In server mode (--server) the database is loaded once and emails are checked on
+*          request, over a local socket (see serveRequest), --client sends emails to a server.
+*          The server reloads it's database on request (or SIGHUP) without pausing the scans.
+*          In explain mode (--explain) a single email is checked and a JSON report is printed
+*          instead of the verdict: every phrase that was found, how many times, it's part of the
+*          score and where it was first found in the file, and the time each stage took.
+*          The phrases are found with an Aho-Corasick automaton, --engine= picks another engine for
+*          a single email: "rolling" (a rolling hash per phrase length, looked up in a HashMap) or
+*          "scan" (the phrase by phrase reference scan)
+*/
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <iostream>
+#include <list>
+#include <vector>
+#include "HashMap.hpp"
+#include "FlatHashMap.hpp"
+#include "StringPoolMap.hpp"
+#include "AhoCorasick.hpp"
+#include "ThreadPool.hpp"
+#include "DatabaseSnapshot.hpp"
+#include "MappedFile.hpp"
+#include "MatchKernel.hpp"
+#include "UnixSocket.hpp"
+#include "RcuPointer.hpp"
+#include "RollingHashMatcher.hpp"
+#include <string>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <memory>
+#include <cmath>
+#include <climits>
+#include <csignal>
+#include <set>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <iterator>
+#include <chrono>
+#include <iomanip>
+#include <cstdio>
+#include <charconv>
+#include <thread>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/filesystem.hpp>
+
+#define USAGE_ERR         "Usage: SpamDetector <database path> <message path> <threshold>"
+#define BATCH_USAGE_ERR   "Usage: SpamDetector --batch [--threads=<n>] <database path> <threshold> " \
+                          "<message path | directory | ->..."
+#define COMPILE_USAGE_ERR "Usage: SpamDetector --compile <database path> <snapshot path>"
+#define SERVER_USAGE_ERR  "Usage: SpamDetector --server [--threads=<n>] <socket path> " \
+                          "<database path> <threshold>"
+#define CLIENT_USAGE_ERR  "Usage: SpamDetector --client <socket path> <threshold | -> " \
+                          "<message path>..."
+#define INVALID_INPUT_ERR "Invalid input"
+#define SPAM_STR "SPAM"
+#define NOT_SPAM_STR "NOT_SPAM"
+#define NUMBER_OF_ARGS 4
+#define INVALID_THRESHOLD 0
+#define NUMBER_OF_BATCH_ARGS 3
+#define NUMBER_OF_COMPILE_ARGS 2
+#define NUMBER_OF_SERVER_ARGS 3
+#define NUMBER_OF_CLIENT_ARGS 3
+#define OPTION_PREFIX "--"
+#define BATCH_OPTION "--batch"
+#define THREADS_OPTION "--threads="
+#define MAX_NUM_OF_THREADS 1024
+#define COMPILE_OPTION "--compile"
+#define MMAP_OPTION "--mmap"
+#define STREAM_OPTION "--stream"
+#define STREAM_CHUNK_SIZE 65536
+#define LINE_SEPARATOR '\n'
+#define EARLY_EXIT_OPTION "--early-exit"
+#define NO_SCORE_TARGET 0
+#define SCANNED_BYTES_MSG "Scanned bytes: "
+#define SCANNED_BYTES_OF " of "
+#define SERVER_OPTION "--server"
+#define CLIENT_OPTION "--client"
+#define REQUEST_BODY "BODY"
+#define REQUEST_PATH "PATH"
+#define REQUEST_RELOAD "RELOAD"
+#define RESPONSE_OK "OK "
+#define DEFAULT_THRESHOLD_STR "-"
+#define RESPONSE_ERROR "ERROR "
+#define MAX_REQUEST_LINE_LENGTH 4096
+#define MAX_REQUEST_BODY_LENGTH (4 << 20)
+#define MAX_REQUEST_BODY_DIGITS 10
+#define MAX_REQUEST_SIZE (MAX_REQUEST_LINE_LENGTH + 1 + MAX_REQUEST_BODY_LENGTH)
+#define SERVER_POLL_MILLIS 200
+#define SERVER_IO_TIMEOUT_MILLIS 30000
+#define SERVER_POLLED_FDS 2
+#define SERVER_WAKE_BUFFER_SIZE 256
+#define SERVER_MAX_CONNECTIONS 1000
+#define SERVER_MIN_PENDING_REQUESTS 16
+#define PIPE_READ_END 0
+#define PIPE_WRITE_END 1
+#define STDIN_PATH "-"
+#define EXPLAIN_OPTION "--explain"
+#define EXPLAIN_MAX_OFFSETS 8
+#define NANOS_IN_MILLI 1e6
+#define JSON_CONTROL_CHAR 0x20
+#define ASCII_LIMIT 0x80
+#define UTF8_CONTINUATION_MASK 0xC0
+#define UTF8_CONTINUATION 0x80
+#define LOADER_MIN_PIECE_SIZE (1 << 20)
+#define ENGINE_OPTION "--engine="
+#define ENGINE_AUTOMATON "automaton"
+#define ENGINE_ROLLING_HASH "rolling"
+#define ENGINE_PHRASE_SCAN "scan"
+
+// The map that saves the sentences of the database and their scores, all the sentences are
+// interned into one pool. Compile with -DUSE_FLAT_HASH_MAP to use the open addressing FlatHashMap,
+// or with -DUSE_NODE_HASH_MAP to use HashMap (a std::string key per list node) instead
+#if defined(USE_FLAT_HASH_MAP)
+typedef FlatHashMap<std::string, int> PhraseTable;
+#elif defined(USE_NODE_HASH_MAP)
+typedef HashMap<std::string, int> PhraseTable;
+#else
+typedef StringPoolMap<int> PhraseTable;
+#endif
+
+/**
+ * @brief the ways an email file can be read
+ */
+enum EmailReadMode
+{
+    READ_WHOLE,   // reads the lines of the file into one string, then scores the string
+    READ_MAPPED,  // maps the file and scores it in place, without copying it
+    READ_STREAMED // reads and scores the file in chunks of STREAM_CHUNK_SIZE bytes
+};
+
+/**
+ * @brief the ways the phrases of the database can be found in an email
+ */
+enum MatchEngine
+{
+    ENGINE_AHO_CORASICK, // the compiled automaton, a single pass over the email
+    ENGINE_ROLLING,      // the RollingHashMatcher, a lookup per byte per distinct phrase length
+    ENGINE_SCAN          // findStringsInEmail, a pass over the email per phrase
+};
+
+/**
+ * @brief the score of an email file and how much of it was scanned to get the score
+ */
+struct EmailScore
+{
+    int totalScore;      // the score of the scanned part of the email
+    size_t bytesScanned; // the number of bytes of the email that were scanned
+    size_t bytesTotal;   // the number of bytes of the email
+};
+
+/**
+ * @brief the settings of the server mode
+ */
+struct ServerConfig
+{
+    std::string dataBaseFilePath; // the database the server was started with (and reloads)
+    double threshold;             // the threshold of the requests that don't give one
+    EmailReadMode readMode;       // the way to read the email files of PATH requests
+    bool earlyExit;               // true to stop scanning an email once the threshold is reached
+};
+
+/**
+ * @brief the ways a request of the server mode can end
+ */
+enum RequestOutcome
+{
+    OUTCOME_SERVED, // the request was answered, the connection waits for the next one
+    OUTCOME_RELOAD, // a RELOAD request, it is answered when the reload is done
+    OUTCOME_CLOSED  // the client closed the connection, or it failed
+};
+
+/**
+ * @brief the connections of the server mode, they are passed between the poll loop, the workers
+ *        of the pool and the reload thread
+ */
+struct ServerConnections
+{
+    std::mutex mutex;                                   // guards the members below
+    std::set<UnixSocket*> open;                         // all the open connections
+    std::vector<std::shared_ptr<UnixSocket>> returned;  // served, for the poll loop to take back
+
+    // The reloads to run, the connections that asked for them (null for SIGHUP)
+    std::deque<std::shared_ptr<UnixSocket>> reloads;
+    std::condition_variable reloadAvailable;            // wakes up the reload thread
+    bool stopping = false;                              // true when the server stops
+    int wakeFds[2] = {-1, -1};                          // a pipe that wakes up the poll loop
+};
+
+/**
+ * @brief a connection of the server mode that waits in the poll loop for it's next request
+ */
+struct IdleConnection
+{
+    std::shared_ptr<UnixSocket> socket;                 // the connection
+    std::chrono::steady_clock::time_point partialSince; // when the first bytes of the request came
+};
+
+/**
+ * @brief the appearances of a phrase of the database in an email, for the explain mode
+ */
+struct PhraseReport
+{
+    int id;                      // the id of the phrase in the automaton
+    int hits;                    // the number of times the phrase appears in the email
+    std::vector<size_t> offsets; // the offsets in the file of the first EXPLAIN_MAX_OFFSETS hits
+};
+
+// Set by SIGINT and SIGTERM to stop the server mode, and by SIGHUP to reload the database
+static volatile std::sig_atomic_t serverStopping = 0;
+static volatile std::sig_atomic_t serverReloading = 0;
+
+// ------------------------------------------- function declaration --------------------------------
+
+/**
+ * @brief gets a string and checks if the string is valid
+ * @param value - the string to check
+ * @return - true if the string is valid, false otherwise
+ */
+bool isValidString(std::string& value)
+{
+    // check if the string contains only integers
+    for (char j : value)
+    {
+        if (((j < '0') || (j > '9')))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief gets a piece of a database file that starts at the start of a line and ends right after a
+ *        line separator (or at the end of the file), checks that every line in it is valid
+ *        ("<sentence>,<score>", a single ',', a sentence that isn't empty and a score of digits)
+ *        and adds the sentences and the scores into the vectors, in the order of the lines. A
+ *        score above INT_MAX is saved as INT_MAX. The sentences are views of the piece, nothing is
+ *        copied
+ * @param begin - the start of the piece
+ * @param end - the end of the piece
+ * @param keys - the vector to add the sentences into
+ * @param values - the vector to add the scores into
+ * @return true if all the lines are valid, false otherwise
+ */
+bool parseDataBaseLines(const char* begin, const char* end, std::vector<std::string_view>& keys,
+                        std::vector<int>& values)
+{
+    const char* line = begin;
+    while (line < end)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(line, LINE_SEPARATOR,
+                                                                   end - line));
+        lineEnd = (lineEnd != nullptr) ? lineEnd : end;
+
+        // Checks that there are exactly two columns in the line, and none of them is empty
+        const char* comma = static_cast<const char*>(std::memchr(line, ',', lineEnd - line));
+        if (comma == nullptr || comma == line || comma + 1 == lineEnd ||
+            std::memchr(comma + 1, ',', lineEnd - comma - 1) != nullptr)
+        {
+            return false;
+        }
+
+        // Checks that the score contains only digits
+        const char* score = comma + 1;
+        for (const char* p = score; p < lineEnd; p++)
+        {
+            if (*p < '0' || *p > '9')
+            {
+                return false;
+            }
+        }
+
+        // A score that doesn't fit in an int is clamped to INT_MAX (a score of digits is never
+        // negative)
+        int value = 0;
+        if (std::from_chars(score, lineEnd, value).ec != std::errc())
+        {
+            value = INT_MAX;
+        }
+
+        keys.emplace_back(line, comma - line);
+        values.push_back(value);
+        line = lineEnd + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief gets a path to a database file, reads the file and saves each sentence and it's score
+ *        into hashMap. The file is mapped and parsed in place, a large file is split into pieces at
+ *        line separators and the pieces are parsed on separate threads. If a sentence appears
+ *        more than once, it's last score is saved
+ * @param filePath - the path to the database file
+ * @param hashMap  - the Hash Map to save the values into
+ */
+void readDataBaseFile(std::string& filePath, PhraseTable& hashMap)
+{
+    // Checks if the db file exists
+    if (!boost::filesystem::exists(filePath))
+    {
+        throw std::exception();
+    }
+    MappedFile file(filePath);
+    file.adviseSequential();
+    const char* data = file.data();
+    const char* end = data + file.size();
+
+    // Splits the file into pieces that start right after a line separator
+    size_t numOfPieces = std::max<size_t>(1, std::min<size_t>(
+            std::max(1u, std::thread::hardware_concurrency()),
+            file.size() / LOADER_MIN_PIECE_SIZE));
+    std::vector<const char*> bounds(numOfPieces + 1, end);
+    bounds[0] = data;
+    for (size_t i = 1; i < numOfPieces; i++)
+    {
+        const char* from = std::max(bounds[i - 1], data + file.size() / numOfPieces * i);
+        const char* separator = static_cast<const char*>(std::memchr(from, LINE_SEPARATOR,
+                                                                     end - from));
+        bounds[i] = (separator != nullptr) ? separator + 1 : end;
+    }
+
+    // Parses the pieces, the first one on this thread. A piece that fails (or runs out of memory)
+    // is invalid
+    std::vector<std::vector<std::string_view>> pieceKeys(numOfPieces);
+    std::vector<std::vector<int>> pieceValues(numOfPieces);
+    std::vector<char> valid(numOfPieces, false); // not a std::vector<bool>, threads write it
+    auto parsePiece = [&bounds, &pieceKeys, &pieceValues, &valid](size_t i)
+    {
+        try
+        {
+            valid[i] = parseDataBaseLines(bounds[i], bounds[i + 1], pieceKeys[i], pieceValues[i]);
+        }
+        catch (std::exception& e)
+        {
+            valid[i] = false;
+        }
+    };
+
+    // If a thread can't be started, the pieces that have no thread are parsed on this thread
+    std::vector<std::thread> threads;
+    size_t firstUnstarted = numOfPieces;
+    for (size_t i = 1; i < numOfPieces; i++)
+    {
+        try
+        {
+            threads.emplace_back(parsePiece, i);
+        }
+        catch (std::system_error& e)
+        {
+            firstUnstarted = i;
+            break;
+        }
+    }
+    parsePiece(0);
+    for (size_t i = firstUnstarted; i < numOfPieces; i++)
+    {
+        parsePiece(i);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Joins the pieces in the order of the file
+    std::vector<std::string_view> keys;
+    std::vector<int> values;
+    for (size_t i = 0; i < numOfPieces; i++)
+    {
+        if (!valid[i])
+        {
+            throw std::exception();
+        }
+        if (i == 0)
+        {
+            keys = std::move(pieceKeys[0]);
+            values = std::move(pieceValues[0]);
+            continue;
+        }
+        keys.insert(keys.end(), pieceKeys[i].begin(), pieceKeys[i].end());
+        values.insert(values.end(), pieceValues[i].begin(), pieceValues[i].end());
+    }
+
+    // Copies the sentences out of the file (into the pool of the map, or into strings for the
+    // other maps) and moves the map into the output, without copying the pairs
+#if defined(USE_FLAT_HASH_MAP) || defined(USE_NODE_HASH_MAP)
+    PhraseTable hashMap1(std::vector<std::string>(keys.begin(), keys.end()), std::move(values));
+#else
+    PhraseTable hashMap1(keys, values);
+#endif
+    hashMap = std::move(hashMap1);
+} // end of readDataBaseFile function
+
+/**
+ * @brief gets a path to an email text file, reads the file and saves the text into a string
+ * @param filePath - the path for the email text file
+ * @param strEmail - the string to save the text into
+ */
+void readEmailFile(std::string& filePath, std::string& strEmail)
+{
+    // Checks if the file exists
+    if (!boost::filesystem::exists(filePath))
+    {
+         throw std::exception();
+    }
+
+    // Opens the file
+    std::ifstream fout;
+    fout.open(filePath);
+    std::string currLine;
+
+    // Reads information while the file isn't empty and saves into the string
+    while (getline(fout, currLine))
+    {
+        strEmail += currLine;
+    }
+    fout.close();
+}
+
+/**
+ * @brief gets a path to an email text file, maps it and scores it in place. The file is not
+ *        copied, and the line separators are skipped so the score is the score of the joined
+ *        lines (like readEmailFile)
+ * @param filePath - the path for the email text file
+ * @param matcher - the automaton of the database
+ * @param target - the score to stop scanning at, NO_SCORE_TARGET to scan the whole email
+ * @return the score of the email
+ */
+EmailScore scoreMappedEmail(std::string& filePath, const AhoCorasick& matcher, int target)
+{
+    MappedFile file(filePath);
+    file.adviseSequential();
+    EmailScore result = {0, file.size(), file.size()};
+    int state = ROOT_STATE;
+    if (target == NO_SCORE_TARGET)
+    {
+        result.totalScore = matcher.scanSkipping(state, file.data(), file.size(), LINE_SEPARATOR);
+    }
+    else
+    {
+        result.bytesScanned = matcher.scanSkippingUntil(state, file.data(), file.size(),
+                                                        result.totalScore, target, LINE_SEPARATOR);
+    }
+    return result;
+}
+
+/**
+ * @brief gets a path to an email text file, reads it in fixed size chunks and scores each chunk
+ *        as it is read. The state of the automaton is carried from chunk to chunk, so sentences
+ *        that cross the end of a chunk are found, and the memory used doesn't depend on the size
+ *        of the file
+ * @param filePath - the path for the email text file
+ * @param matcher - the automaton of the database
+ * @param target - the score to stop reading at, NO_SCORE_TARGET to read the whole email
+ * @return the score of the email
+ */
+EmailScore scoreStreamedEmail(std::string& filePath, const AhoCorasick& matcher, int target)
+{
+    // Checks if the file exists
+    if (!boost::filesystem::exists(filePath))
+    {
+        throw std::exception();
+    }
+
+    boost::system::error_code error;
+    uintmax_t fileSize = boost::filesystem::file_size(filePath, error);
+    EmailScore result = {0, 0, error ? 0 : (size_t)fileSize};
+
+    std::ifstream fout(filePath, std::ios::binary);
+    std::vector<char> chunk(STREAM_CHUNK_SIZE);
+    int state = ROOT_STATE;
+    while (fout.read(chunk.data(), (std::streamsize)chunk.size()) || fout.gcount() > 0)
+    {
+        size_t length = (size_t)fout.gcount();
+        if (target == NO_SCORE_TARGET)
+        {
+            result.totalScore += matcher.scanSkipping(state, chunk.data(), length,
+                                                      LINE_SEPARATOR);
+            result.bytesScanned += length;
+            continue;
+        }
+
+        // Stops reading as soon as the target is reached
+        result.bytesScanned += matcher.scanSkippingUntil(state, chunk.data(), length,
+                                                         result.totalScore, target,
+                                                         LINE_SEPARATOR);
+        if (result.totalScore >= target)
+        {
+            break;
+        }
+    }
+    fout.close();
+    return result;
+}
+
+/**
+ * @brief gets a path to an email text file and calculates it's score
+ * @param filePath - the path for the email text file
+ * @param matcher - the automaton of the database
+ * @param readMode - the way to read the file
+ * @param target - the score to stop scanning at (the email is spam once it's score reaches the
+ *                 threshold), NO_SCORE_TARGET to calculate the full score
+ * @return the score of the email
+ */
+EmailScore scoreEmailFile(std::string& filePath, const AhoCorasick& matcher,
+                          EmailReadMode readMode, int target)
+{
+    switch (readMode)
+    {
+        case READ_MAPPED:
+            return scoreMappedEmail(filePath, matcher, target);
+        case READ_STREAMED:
+            return scoreStreamedEmail(filePath, matcher, target);
+        default:
+        {
+            std::string strEmail;
+            readEmailFile(filePath, strEmail);
+            EmailScore result = {0, strEmail.size(), strEmail.size()};
+            int state = ROOT_STATE;
+            if (target == NO_SCORE_TARGET)
+            {
+                result.totalScore = matcher.score(strEmail);
+            }
+            else
+            {
+                result.bytesScanned = matcher.scanUntil(state, strEmail.data(), strEmail.size(),
+                                                        result.totalScore, target);
+            }
+            return result;
+        }
+    }
+}
+
+/**
+ * @brief gets a threshold and returns the score target of the early exit: the smallest integer
+ *        score that is not lower than the threshold
+ * @param threshold - the threshold
+ * @return the score target
+ */
+int scoreTargetOf(double threshold)
+{
+    return (threshold >= (double)INT_MAX) ? INT_MAX : (int)std::ceil(threshold);
+}
+
+/**
+ * @brief function that gets a hash map with sentences and a string, counts the number of times each
+ *        sentence appears in the string, multiplies by the string's score and counts the total
+ *        score of the email file. This is the reference (phrase by phrase) scan, the program
+ *        itself scores the email with an AhoCorasick automaton that gives the same total
+ * @param stringsMap - a hash map that contains pairs of strings and their score
+ * @param stringEmail - a string that contains the text in the email file
+ * @return - the total score
+ */
+int findStringsInEmail(PhraseTable& stringsMap, std::string& stringEmail)
+{
+    int totalScoreOfEmail = 0;
+
+    // Changes every upper letter of the email to lower letter once, a whole register at a time
+    std::string foldedEmail(stringEmail.size(), '\0');
+    MatchKernel::foldCopy(stringEmail.data(), stringEmail.size(), &foldedEmail[0]);
+
+   // Goes over the words in the map. Counts the appearance of each word in the email string and
+   // saves the total score. Every word is folded into the same buffer, no word is copied
+   std::string strValue;
+   for (PhraseTable::const_iterator it = stringsMap.begin(); it != stringsMap.end(); it++)
+   {
+        std::string_view word(it->first);
+        strValue.resize(word.size());
+        MatchKernel::foldCopy(word.data(), word.size(), &strValue[0]);
+
+        // Counts how many times the string appears in the email string, only the positions that
+        // start with the first char of the string and end with it's last char are compared
+        int count = MatchKernel::countOccurrences(foldedEmail.data(), foldedEmail.size(),
+                                                  strValue.data(), strValue.size());
+
+        int scoreOfStr = count * it->second;
+        totalScoreOfEmail += scoreOfStr;
+   }
+    return totalScoreOfEmail;
+} // end of findStringsInEmail function
+
+/**
+ * @brief gets a threshold string, checks that it is a valid threshold and converts it to a number
+ * @param thresholdStr - the threshold string
+ * @param threshold - the number to save the threshold into
+ * @return true if the threshold is valid, false otherwise
+ */
+bool readThreshold(std::string& thresholdStr, double& threshold)
+{
+    // check validity for threshold,  etc. contains only integers
+    if (!isValidString(thresholdStr))
+    {
+        return false;
+    }
+
+    // Converts the string to integer
+    std::stringstream s(thresholdStr);
+    threshold = 0;
+    s >> threshold;
+
+    // Checks if the conversion worked and if the threshold equals zero
+    return !s.fail() && threshold != INVALID_THRESHOLD;
+}
+
+/**
+ * @brief gets a path to a database and builds the automaton of it's sentences. A compiled snapshot
+ *        (see runCompile) is mapped and used as is, a database text file is read and compiled
+ * @param filePath - the path to the database file or snapshot
+ * @return the automaton
+ */
+std::unique_ptr<AhoCorasick> loadMatcher(std::string& filePath)
+{
+    if (isSnapshotFile(filePath))
+    {
+        return std::unique_ptr<AhoCorasick>(new AhoCorasick(loadSnapshot(filePath)));
+    }
+
+    PhraseTable stringsMap;
+    readDataBaseFile(filePath, stringsMap);
+    return std::unique_ptr<AhoCorasick>(new AhoCorasick(stringsMap));
+}
+
+/**
+ * @brief gets a path to a database and saves each sentence and it's score into stringsMap. The
+ *        sentences of a compiled snapshot are taken from it's automaton
+ * @param filePath - the path to the database file or snapshot
+ * @param stringsMap - the map to save the sentences into
+ */
+void loadPhraseTable(std::string& filePath, PhraseTable& stringsMap)
+{
+    if (!isSnapshotFile(filePath))
+    {
+        readDataBaseFile(filePath, stringsMap);
+        return;
+    }
+
+    AhoCorasick matcher(loadSnapshot(filePath));
+    std::vector<std::string> keys;
+    std::vector<int> values;
+    for (int id = 0; id < matcher.patternCount(); id++)
+    {
+        keys.emplace_back(matcher.pattern(id));
+        values.push_back(matcher.patternScore(id));
+    }
+    PhraseTable loaded(std::move(keys), std::move(values));
+    stringsMap = std::move(loaded);
+}
+
+/**
+ * @brief gets a path to an email text file and calculates it's score with an engine that scores
+ *        the whole email in memory (the RollingHashMatcher or the phrase by phrase scan)
+ * @param dataBaseFilePath - the path to the database file or snapshot
+ * @param emailFilePath - the path for the email text file
+ * @param engine - the engine
+ * @return the score of the email
+ */
+int scoreWithEngine(std::string& dataBaseFilePath, std::string& emailFilePath,
+                    MatchEngine engine)
+{
+    PhraseTable stringsMap;
+    loadPhraseTable(dataBaseFilePath, stringsMap);
+    std::string strEmail;
+    readEmailFile(emailFilePath, strEmail);
+
+    if (engine == ENGINE_ROLLING)
+    {
+        RollingHashMatcher matcher(stringsMap);
+        return matcher.score(strEmail);
+    }
+    return findStringsInEmail(stringsMap, strEmail);
+}
+
+/**
+ * @brief returns the number of milliseconds since the given time
+ * @param start - the time
+ * @return the number of milliseconds
+ */
+double millisSince(std::chrono::steady_clock::time_point start)
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count() / NANOS_IN_MILLI;
+}
+
+/**
+ * @brief returns the length of the UTF-8 sequence of a non-ASCII char that starts at the given
+ *        index of a text, if it is a valid sequence (not an overlong form, a surrogate or a code
+ *        point past U+10FFFF)
+ * @param text - the text
+ * @param index - the index of the first byte of the sequence
+ * @return the number of bytes of the sequence, or 0 if it is not a valid sequence
+ */
+size_t utf8SequenceLength(std::string_view text, size_t index)
+{
+    unsigned char lead = (unsigned char)text[index];
+
+    // The length of the sequence and the range of it's second byte, by the first byte
+    size_t length = 0;
+    unsigned char low = UTF8_CONTINUATION;
+    unsigned char high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        length = 2;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        length = 3;
+        low = (lead == 0xE0) ? 0xA0 : low;
+        high = (lead == 0xED) ? 0x9F : high;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        length = 4;
+        low = (lead == 0xF0) ? 0x90 : low;
+        high = (lead == 0xF4) ? 0x8F : high;
+    }
+    if (length == 0 || index + length > text.size())
+    {
+        return 0;
+    }
+
+    unsigned char second = (unsigned char)text[index + 1];
+    if (second < low || second > high)
+    {
+        return 0;
+    }
+    for (size_t i = 2; i < length; i++)
+    {
+        if (((unsigned char)text[index + i] & UTF8_CONTINUATION_MASK) != UTF8_CONTINUATION)
+        {
+            return 0;
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief gets a text and returns it as a JSON string, in quotes and with the special chars escaped.
+ *        The database and the emails are arbitrary bytes: valid UTF-8 sequences are kept, and
+ *        every other byte of 0x80 and above is escaped as \u00XX (the char with it's value), so
+ *        the result is always valid JSON
+ * @param text - the text
+ * @return the JSON string
+ */
+std::string jsonString(std::string_view text)
+{
+    std::string result = "\"";
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        char c = text[i];
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+            result += c;
+            continue;
+        }
+        if ((unsigned char)c >= JSON_CONTROL_CHAR && (unsigned char)c < ASCII_LIMIT)
+        {
+            result += c;
+            continue;
+        }
+
+        size_t length = ((unsigned char)c < ASCII_LIMIT) ? 0 : utf8SequenceLength(text, i);
+        if (length > 0)
+        {
+            result.append(text.data() + i, length);
+            i += length - 1;
+        }
+        else
+        {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)(unsigned char)c);
+            result += escaped;
+        }
+    }
+    return result + "\"";
+}
+
+/**
+ * @brief gets a path to an email text file and reads all of it's bytes (with the line separators)
+ * @param filePath - the path for the email text file
+ * @param bytes - the string to save the bytes into
+ */
+void readEmailBytes(std::string& filePath, std::string& bytes)
+{
+    // Checks if the file exists
+    if (!boost::filesystem::exists(filePath))
+    {
+        throw std::exception();
+    }
+    std::ifstream fout(filePath, std::ios::binary);
+    std::ostringstream buffer;
+    buffer << fout.rdbuf();
+    bytes = buffer.str();
+}
+
+/**
+ * @brief finds every appearance of every phrase in the bytes of an email file. The line separators
+ *        are skipped, so the phrases are found in the joined lines like scoreEmailFile finds them,
+ *        but the offsets are offsets in the file
+ * @param email - the bytes of the email file
+ * @param matcher - the automaton of the database
+ * @return a report of every phrase that was found, the phrases with the largest part of the score
+ *         first
+ */
+std::vector<PhraseReport> explainEmail(const std::string& email, const AhoCorasick& matcher)
+{
+    std::vector<PhraseReport> reports(matcher.patternCount());
+    for (int id = 0; id < matcher.patternCount(); id++)
+    {
+        reports[id].id = id;
+        reports[id].hits = 0;
+    }
+
+    int state = ROOT_STATE;
+    size_t runStart = 0;
+    while (runStart < email.size())
+    {
+        size_t runEnd = std::min(email.find(LINE_SEPARATOR, runStart), email.size());
+        matcher.forEachMatch(state, email.data() + runStart, runEnd - runStart,
+                             [&reports, &email, &matcher, runStart](int id, size_t last)
+        {
+            PhraseReport& report = reports[id];
+            report.hits++;
+            if (report.offsets.size() >= EXPLAIN_MAX_OFFSETS)
+            {
+                return;
+            }
+
+            // Goes back over the phrase to it's first byte, the skipped separators are counted
+            // in the offset but not in the length of the phrase
+            size_t offset = runStart + last;
+            for (size_t left = matcher.pattern(id).size() - 1; left > 0; left--)
+            {
+                do
+                {
+                    offset--;
+                } while (email[offset] == LINE_SEPARATOR);
+            }
+            report.offsets.push_back(offset);
+        });
+        runStart = runEnd + 1;
+    }
+
+    // Keeps the phrases that were found, sorted by their part of the score
+    reports.erase(std::remove_if(reports.begin(), reports.end(), [](const PhraseReport& report)
+    {
+        return report.hits == 0;
+    }), reports.end());
+    std::stable_sort(reports.begin(), reports.end(),
+                     [&matcher](const PhraseReport& a, const PhraseReport& b)
+    {
+        return (long long)a.hits * matcher.patternScore(a.id) >
+               (long long)b.hits * matcher.patternScore(b.id);
+    });
+    return reports;
+}
+
+/**
+ * @brief the explain mode. Loads the database, reads and scans the email, and prints a JSON report
+ *        of the score: the total, every phrase that was found with it's number of hits, it's part
+ *        of the score and the offsets of it's first hits, and the time each stage took. The
+ *        regular modes don't collect any of it
+ * @param dataBaseFilePath - the path to the database file or snapshot
+ * @param emailFilePath - the path for the email text file
+ * @param threshold - the threshold
+ * @return 0 if success, 1 if failure
+ */
+int runExplain(std::string& dataBaseFilePath, std::string& emailFilePath, double threshold)
+{
+    std::unique_ptr<AhoCorasick> matcher;
+    std::string email;
+    std::vector<PhraseReport> reports;
+    double loadMillis = 0;
+    double readMillis = 0;
+    double scanMillis = 0;
+    try
+    {
+        auto start = std::chrono::steady_clock::now();
+        matcher = loadMatcher(dataBaseFilePath);
+        loadMillis = millisSince(start);
+
+        start = std::chrono::steady_clock::now();
+        readEmailBytes(emailFilePath, email);
+        readMillis = millisSince(start);
+
+        start = std::chrono::steady_clock::now();
+        reports = explainEmail(email, *matcher);
+        scanMillis = millisSince(start);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The parts of the score are summed in long long, the hits of a phrase with a big score
+    // don't overflow
+    long long totalScore = 0;
+    for (const PhraseReport& report : reports)
+    {
+        totalScore += (long long)report.hits * matcher->patternScore(report.id);
+    }
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n";
+    json << "  \"database\": " << jsonString(dataBaseFilePath) << ",\n";
+    json << "  \"email\": " << jsonString(emailFilePath) << ",\n";
+    json << "  \"email_bytes\": " << email.size() << ",\n";
+    // The threshold is a whole number (see readThreshold), it is printed without a fraction
+    json << "  \"threshold\": " << std::setprecision(0) << threshold << std::setprecision(3)
+         << ",\n";
+    json << "  \"total_score\": " << totalScore << ",\n";
+    json << "  \"verdict\": \"" << ((threshold <= totalScore) ? SPAM_STR : NOT_SPAM_STR) << "\",\n";
+    json << "  \"timings_ms\": {\"database_load\": " << loadMillis << ", \"email_read\": "
+         << readMillis << ", \"scan\": " << scanMillis << "},\n";
+    json << "  \"phrases\": [";
+    for (size_t i = 0; i < reports.size(); i++)
+    {
+        const PhraseReport& report = reports[i];
+        int score = matcher->patternScore(report.id);
+        json << ((i == 0) ? "\n" : ",\n");
+        json << "    {\"phrase\": " << jsonString(matcher->pattern(report.id))
+             << ", \"hits\": " << report.hits << ", \"score\": " << score
+             << ", \"contribution\": " << (long long)report.hits * score
+             << ", \"first_offsets\": [";
+        for (size_t k = 0; k < report.offsets.size(); k++)
+        {
+            json << ((k == 0) ? "" : ", ") << report.offsets[k];
+        }
+        json << "]}";
+    }
+    json << (reports.empty() ? "]\n" : "\n  ]\n") << "}\n";
+    std::cout << json.str();
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief the compile mode. Reads a database file, compiles it's sentences into an automaton and
+ *        writes the automaton into a snapshot file, that can be given instead of the database
+ * @param argc - the number of arguments (after the options)
+ * @param argv - the arguments: <database path> <snapshot path>
+ * @return 0 if success, 1 if failure
+ */
+int runCompile(int argc, char *argv[])
+{
+    if (argc != NUMBER_OF_COMPILE_ARGS)
+    {
+        std::cout << COMPILE_USAGE_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string dataBaseFilePath = argv[0];
+    std::string snapshotFilePath = argv[1];
+    try
+    {
+        PhraseTable stringsMap;
+        readDataBaseFile(dataBaseFilePath, stringsMap);
+        AhoCorasick matcher(stringsMap);
+        writeSnapshot(matcher, snapshotFilePath);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief gets an input of the batch mode and adds the paths of the email files it stands for: all
+ *        the files in a directory (sorted by name), the paths listed in the standard input (one per
+ *        line) for "-", or the path itself otherwise
+ * @param input - the input argument
+ * @param paths - the vector to add the paths into
+ */
+void collectMessagePaths(const std::string& input, std::vector<std::string>& paths)
+{
+    if (input == STDIN_PATH)
+    {
+        std::string currLine;
+        while (getline(std::cin, currLine))
+        {
+            if (!currLine.empty())
+            {
+                paths.push_back(currLine);
+            }
+        }
+        return;
+    }
+
+    boost::system::error_code error;
+    if (!boost::filesystem::is_directory(input, error))
+    {
+        paths.push_back(input);
+        return;
+    }
+
+    std::vector<std::string> filesInDir;
+    for (boost::filesystem::directory_iterator it(input, error), end; !error && it != end;
+         it.increment(error))
+    {
+        if (boost::filesystem::is_regular_file(it->path(), error))
+        {
+            filesInDir.push_back(it->path().string());
+        }
+    }
+    std::sort(filesInDir.begin(), filesInDir.end());
+    paths.insert(paths.end(), filesInDir.begin(), filesInDir.end());
+}
+
+/**
+ * @brief the batch mode. Loads the database once and checks many email files in parallel on a
+ *        thread pool, then prints one line per email file ("<path> SPAM" or "<path> NOT_SPAM"),
+ *        in the order of the inputs
+ * @param argc - the number of arguments (after the options)
+ * @param argv - the arguments: <database path | snapshot path> <threshold>
+ *               <message path | directory | ->...
+ * @param numOfThreads - the number of threads, 0 for the number of hardware threads
+ * @param readMode - the way to read the email files
+ * @param earlyExit - true to stop scanning each email once it's score reaches the threshold, and
+ *                    print the number of bytes that were scanned
+ * @return 0 if success, 1 if failure
+ */
+int runBatch(int argc, char *argv[], int numOfThreads, EmailReadMode readMode, bool earlyExit)
+{
+    if (argc < NUMBER_OF_BATCH_ARGS)
+    {
+        std::cout << BATCH_USAGE_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string dataBaseFilePath = argv[0];
+    std::string thresholdStr = argv[1];
+    double threshold = 0;
+    if (!readThreshold(thresholdStr, threshold))
+    {
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::unique_ptr<AhoCorasick> loaded;
+    try
+    {
+        loaded = loadMatcher(dataBaseFilePath);
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+    const AhoCorasick& matcher = *loaded;
+
+    std::vector<std::string> paths;
+    for (int i = NUMBER_OF_BATCH_ARGS - 1; i < argc; i++)
+    {
+        collectMessagePaths(argv[i], paths);
+    }
+
+    // Submits the biggest files first, so a big file doesn't start last and delay the end of the
+    // batch. The workers steal the remaining files from each other
+    std::vector<uintmax_t> sizes(paths.size(), 0);
+    std::vector<int> order(paths.size());
+    for (int i = 0; i < (int)paths.size(); i++)
+    {
+        boost::system::error_code error;
+        uintmax_t size = boost::filesystem::file_size(paths[i], error);
+        sizes[i] = error ? 0 : size;
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&sizes](int a, int b)
+    {
+        return sizes[a] > sizes[b];
+    });
+
+    int target = earlyExit ? scoreTargetOf(threshold) : NO_SCORE_TARGET;
+    std::vector<const char*> results(paths.size(), INVALID_INPUT_ERR);
+    std::vector<EmailScore> scores(paths.size(), EmailScore{0, 0, 0});
+    try
+    {
+        ThreadPool pool(numOfThreads);
+        for (int i : order)
+        {
+            pool.submit([&paths, &results, &scores, &matcher, threshold, readMode, target, i]
+            {
+                std::string path = paths[i];
+                try
+                {
+                    scores[i] = scoreEmailFile(path, matcher, readMode, target);
+                }
+                catch (std::exception& e)
+                {
+                    return;
+                }
+                results[i] = (threshold <= scores[i].totalScore) ? SPAM_STR : NOT_SPAM_STR;
+            });
+        }
+        pool.wait();
+    }
+    catch (std::system_error& e)
+    {
+        // Not even one worker could be started
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Prints the results in the order of the inputs
+    int exitCode = EXIT_SUCCESS;
+    for (int i = 0; i < (int)paths.size(); i++)
+    {
+        std::cout << paths[i] << " " << results[i] << "\n";
+        if (std::strcmp(results[i], INVALID_INPUT_ERR) == 0)
+        {
+            exitCode = EXIT_FAILURE;
+        }
+    }
+    std::cout.flush();
+
+    if (earlyExit)
+    {
+        size_t bytesScanned = 0;
+        size_t bytesTotal = 0;
+        for (const EmailScore& score : scores)
+        {
+            bytesScanned += score.bytesScanned;
+            bytesTotal += score.bytesTotal;
+        }
+        std::cerr << SCANNED_BYTES_MSG << bytesScanned << SCANNED_BYTES_OF << bytesTotal
+                  << std::endl;
+    }
+    return exitCode;
+}
+
+/**
+ * @brief scores an email that is already in memory, the line separators are skipped like in
+ *        readEmailFile
+ * @param body - the text of the email
+ * @param matcher - the automaton of the database
+ * @param target - the score to stop scanning at, NO_SCORE_TARGET to scan the whole email
+ * @return the score of the email
+ */
+EmailScore scoreEmailBody(const std::string& body, const AhoCorasick& matcher, int target)
+{
+    EmailScore result = {0, body.size(), body.size()};
+    int state = ROOT_STATE;
+    if (target == NO_SCORE_TARGET)
+    {
+        result.totalScore = matcher.scanSkipping(state, body.data(), body.size(), LINE_SEPARATOR);
+    }
+    else
+    {
+        result.bytesScanned = matcher.scanSkippingUntil(state, body.data(), body.size(),
+                                                        result.totalScore, target, LINE_SEPARATOR);
+    }
+    return result;
+}
+
+/**
+ * @brief gets the length of the body of a request, checks that it is a valid length and converts
+ *        it to a number
+ * @param lengthStr - the length string
+ * @param length - the number to save the length into
+ * @return true if the length is valid, false otherwise
+ */
+bool readBodyLength(std::string& lengthStr, size_t& length)
+{
+    if (lengthStr.empty() || lengthStr.size() > MAX_REQUEST_BODY_DIGITS ||
+        !isValidString(lengthStr))
+    {
+        return false;
+    }
+    length = std::stoull(lengthStr);
+    return length <= MAX_REQUEST_BODY_LENGTH;
+}
+
+/**
+ * @brief checks if the whole next request of a connection of the server mode (the line, and the
+ *        body of a BODY request) was received into it's buffer, so a worker can serve it without
+ *        waiting for the client. A request that is surely invalid counts as whole, a worker
+ *        answers it
+ * @param connection - the connection
+ * @return true if the request can be served without waiting, false otherwise
+ */
+bool isRequestBuffered(const UnixSocket& connection)
+{
+    std::string_view buffered = connection.bufferedBytes();
+    size_t lineEnd = buffered.find('\n');
+    if (lineEnd == std::string_view::npos)
+    {
+        return buffered.size() > MAX_REQUEST_LINE_LENGTH;
+    }
+
+    std::string_view line = buffered.substr(0, lineEnd);
+    size_t firstSpace = line.find(' ');
+    if (line.substr(0, firstSpace) != REQUEST_BODY)
+    {
+        return true;
+    }
+    size_t secondSpace = (firstSpace == std::string_view::npos) ? std::string_view::npos
+                                                                : line.find(' ', firstSpace + 1);
+    std::string lengthStr = (secondSpace == std::string_view::npos) ? ""
+            : std::string(line.substr(secondSpace + 1));
+    size_t bodyLength = 0;
+    return !readBodyLength(lengthStr, bodyLength) || buffered.size() - lineEnd - 1 >= bodyLength;
+}
+
+/**
+ * @brief loads a database (or snapshot) and publishes it's automaton as the new version of the
+ *        server. Requests that already started finish with the old version, and it is deleted
+ *        when they are done
+ * @param matcher - the versions of the automaton of the server
+ * @param filePath - the path to the database file or snapshot
+ * @return the response to a reload request: "OK <version>" or "ERROR Invalid input"
+ */
+std::string reloadMatcher(RcuPointer<AhoCorasick>& matcher, std::string& filePath)
+{
+    std::unique_ptr<AhoCorasick> loaded;
+    try
+    {
+        loaded = loadMatcher(filePath);
+    }
+    catch (std::exception& e)
+    {
+        return std::string(RESPONSE_ERROR) + INVALID_INPUT_ERR + "\n";
+    }
+    uint64_t version = matcher.publish(std::move(loaded));
+    return std::string(RESPONSE_OK) + std::to_string(version) + "\n";
+}
+
+/**
+ * @brief reads and answers a single request of a connection of the server mode. Every request is
+ *        a line, and is answered with one line:
+ *        "BODY <threshold | -> <length>" followed by <length> bytes of an email text (up to
+ *        MAX_REQUEST_BODY_LENGTH, a bigger email is sent as a file), or
+ *        "PATH <threshold | -> <path of an email file>" are answered with "SPAM <score>" or
+ *        "NOT_SPAM <score>", "-" stands for the threshold the server was started with.
+ *        "RELOAD" loads the database the server was started with again while the other requests
+ *        go on, and is answered with "OK <version>". A client can't pick the database, so RELOAD
+ *        with an argument is invalid. An invalid request is answered with "ERROR Invalid input"
+ * @param connection - the connection
+ * @param matcher - the versions of the automaton of the server
+ * @param config - the settings of the server
+ * @return OUTCOME_SERVED if the request was answered, OUTCOME_RELOAD if it is a RELOAD request
+ *         (that is not answered yet), or OUTCOME_CLOSED if the connection should be closed
+ */
+RequestOutcome serveRequest(UnixSocket& connection, RcuPointer<AhoCorasick>& matcher,
+                            ServerConfig& config)
+{
+    std::string line;
+    std::string body;
+    if (!connection.readLine(line, MAX_REQUEST_LINE_LENGTH))
+    {
+        return OUTCOME_CLOSED;
+    }
+
+    // Splits the line into the request, the threshold and the argument
+    size_t firstSpace = line.find(' ');
+    size_t secondSpace = (firstSpace == std::string::npos) ? std::string::npos
+                                                           : line.find(' ', firstSpace + 1);
+    std::string request = line.substr(0, firstSpace);
+    std::string thresholdStr = (secondSpace == std::string::npos) ? ""
+            : line.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+    std::string argument = (secondSpace == std::string::npos) ? ""
+                                                             : line.substr(secondSpace + 1);
+
+    if (request == REQUEST_RELOAD && firstSpace == std::string::npos)
+    {
+        return OUTCOME_RELOAD;
+    }
+
+    // A body must be read even if the request is invalid, to get to the next request
+    bool isBody = (request == REQUEST_BODY);
+    size_t bodyLength = 0;
+    if (isBody)
+    {
+        if (!readBodyLength(argument, bodyLength) || !connection.readBytes(bodyLength, body))
+        {
+            connection.writeAll(std::string(RESPONSE_ERROR) + INVALID_INPUT_ERR + "\n");
+            return OUTCOME_CLOSED;
+        }
+    }
+
+    double threshold = config.threshold;
+    bool valid = (isBody || (request == REQUEST_PATH && !argument.empty())) &&
+                 (thresholdStr == DEFAULT_THRESHOLD_STR || readThreshold(thresholdStr,
+                                                                         threshold));
+    std::string response;
+    if (valid)
+    {
+        int target = config.earlyExit ? scoreTargetOf(threshold) : NO_SCORE_TARGET;
+        try
+        {
+            // The version is kept alive until the end of the scan, even if it is replaced
+            RcuPointer<AhoCorasick>::ReadHandle current(matcher);
+            EmailScore score = isBody ? scoreEmailBody(body, *current, target)
+                                      : scoreEmailFile(argument, *current, config.readMode,
+                                                       target);
+            response = std::string((threshold <= score.totalScore) ? SPAM_STR : NOT_SPAM_STR)
+                       + " " + std::to_string(score.totalScore) + "\n";
+        }
+        catch (std::exception& e)
+        {
+            valid = false;
+        }
+    }
+    if (!valid)
+    {
+        response = std::string(RESPONSE_ERROR) + INVALID_INPUT_ERR + "\n";
+    }
+    return connection.writeAll(response) ? OUTCOME_SERVED : OUTCOME_CLOSED;
+}
+
+/**
+ * @brief gives a connection whose request was answered back to the poll loop of the server, and
+ *        wakes the loop up so it waits for the next request of the connection
+ * @param server - the connections of the server
+ * @param connection - the connection
+ */
+void returnConnection(ServerConnections& server, const std::shared_ptr<UnixSocket>& connection)
+{
+    {
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.returned.push_back(connection);
+    }
+    char wake = 0;
+    ssize_t written = ::write(server.wakeFds[PIPE_WRITE_END], &wake, 1);
+    (void)written; // a full pipe already wakes the loop up
+}
+
+/**
+ * @brief forgets a connection that is closed, it's socket is closed with it's last owner
+ * @param server - the connections of the server
+ * @param connection - the connection
+ */
+void closeConnection(ServerConnections& server, const std::shared_ptr<UnixSocket>& connection)
+{
+    std::lock_guard<std::mutex> lock(server.mutex);
+    server.open.erase(connection.get());
+}
+
+/**
+ * @brief the task of a worker of the server pool: serves the next request of a connection (that
+ *        has bytes to read), then gives the connection back to the poll loop, or passes a RELOAD
+ *        request to the reload thread
+ * @param server - the connections of the server
+ * @param connection - the connection
+ * @param matcher - the versions of the automaton of the server
+ * @param config - the settings of the server
+ */
+void serveRequestTask(ServerConnections& server, const std::shared_ptr<UnixSocket>& connection,
+                      RcuPointer<AhoCorasick>& matcher, ServerConfig& config)
+{
+    switch (serveRequest(*connection, matcher, config))
+    {
+        case OUTCOME_SERVED:
+            returnConnection(server, connection);
+            break;
+        case OUTCOME_RELOAD:
+        {
+            std::lock_guard<std::mutex> lock(server.mutex);
+            server.reloads.push_back(connection);
+            server.reloadAvailable.notify_one();
+            break;
+        }
+        case OUTCOME_CLOSED:
+            closeConnection(server, connection);
+            break;
+    }
+}
+
+/**
+ * @brief the loop of the reload thread of the server: loads the database of the server again for
+ *        the RELOAD requests and SIGHUP, one after the other, so a reload never takes a worker of
+ *        the pool from the scans. Returns when the server stops
+ * @param server - the connections of the server
+ * @param matcher - the versions of the automaton of the server
+ * @param config - the settings of the server
+ */
+void runReloads(ServerConnections& server, RcuPointer<AhoCorasick>& matcher,
+                ServerConfig& config)
+{
+    std::unique_lock<std::mutex> lock(server.mutex);
+    while (true)
+    {
+        server.reloadAvailable.wait(lock, [&server]
+        {
+            return server.stopping || !server.reloads.empty();
+        });
+        if (server.stopping)
+        {
+            return;
+        }
+        std::shared_ptr<UnixSocket> connection = std::move(server.reloads.front());
+        server.reloads.pop_front();
+        lock.unlock();
+
+        // A reload of SIGHUP has no connection to answer
+        std::string response = reloadMatcher(matcher, config.dataBaseFilePath);
+        if (connection != nullptr)
+        {
+            if (connection->writeAll(response))
+            {
+                returnConnection(server, connection);
+            }
+            else
+            {
+                closeConnection(server, connection);
+            }
+        }
+        lock.lock();
+    }
+}
+
+/**
+ * @brief stops the server mode, the handler of SIGINT and SIGTERM
+ * @param signal - the signal
+ */
+extern "C" void stopServer(int signal)
+{
+    (void)signal;
+    serverStopping = 1;
+}
+
+/**
+ * @brief asks the server mode to reload it's database, the handler of SIGHUP
+ * @param signal - the signal
+ */
+extern "C" void reloadServer(int signal)
+{
+    (void)signal;
+    serverReloading = 1;
+}
+
+/**
+ * @brief the server mode. Loads the database once and listens on a local socket until SIGINT or
+ *        SIGTERM. A single loop waits (with poll) for new connections and for the next request of
+ *        every idle connection, and every request that arrives is served by a task of the thread
+ *        pool (see serveRequest), so an idle connection doesn't hold a worker. Reloads (RELOAD
+ *        requests and SIGHUP) run on a thread of their own, the workers only score emails.
+ *        The memory of the requests is bounded: the server holds at most the larger of
+ *        SERVER_MIN_PENDING_REQUESTS and the number of workers requests at once (the others wait
+ *        in their sockets), a request that doesn't arrive in full in SERVER_IO_TIMEOUT_MILLIS
+ *        closes it's connection, and at most SERVER_MAX_CONNECTIONS connections are open
+ * @param argc - the number of arguments (after the options)
+ * @param argv - the arguments: <socket path> <database path | snapshot path> <threshold>
+ * @param numOfThreads - the number of threads, 0 for the number of hardware threads
+ * @param readMode - the way to read the email files of PATH requests
+ * @param earlyExit - true to stop scanning an email once it's score reaches the threshold
+ * @return 0 if success, 1 if failure
+ */
+int runServer(int argc, char *argv[], int numOfThreads, EmailReadMode readMode, bool earlyExit)
+{
+    if (argc != NUMBER_OF_SERVER_ARGS)
+    {
+        std::cout << SERVER_USAGE_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string socketPath = argv[0];
+    ServerConfig config = {argv[1], 0, readMode, earlyExit};
+    std::string thresholdStr = argv[2];
+    if (!readThreshold(thresholdStr, config.threshold))
+    {
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::unique_ptr<AhoCorasick> loaded;
+    UnixSocket listener;
+    ServerConnections server;
+    try
+    {
+        loaded = loadMatcher(config.dataBaseFilePath);
+        listener = UnixSocket::listenOn(socketPath);
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (::pipe2(server.wakeFds, O_NONBLOCK | O_CLOEXEC) == -1)
+    {
+        ::unlink(socketPath.c_str());
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+    RcuPointer<AhoCorasick> matcher(std::move(loaded));
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = stopServer;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    action.sa_handler = reloadServer;
+    sigaction(SIGHUP, &action, nullptr);
+
+    // The reload thread starts first, the pool can go on with fewer workers than asked for. If not
+    // even one worker can start, the reload thread is stopped before the server fails
+    std::thread reloader;
+    std::unique_ptr<ThreadPool> pool;
+    try
+    {
+        reloader = std::thread(runReloads, std::ref(server), std::ref(matcher), std::ref(config));
+        pool.reset(new ThreadPool(numOfThreads));
+    }
+    catch (std::system_error& e)
+    {
+        if (reloader.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(server.mutex);
+                server.stopping = true;
+            }
+            server.reloadAvailable.notify_all();
+            reloader.join();
+        }
+        ::unlink(socketPath.c_str());
+        ::close(server.wakeFds[PIPE_READ_END]);
+        ::close(server.wakeFds[PIPE_WRITE_END]);
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+    {
+        auto dispatch = [&pool, &server, &matcher, &config](std::shared_ptr<UnixSocket> connection)
+        {
+            pool->submit([connection, &server, &matcher, &config]
+            {
+                serveRequestTask(server, connection, matcher, config);
+            });
+        };
+
+        // The requests the server holds in memory at once (received in part, or being served),
+        // a connection that has no bytes of it's next request is not read while there are more
+        size_t maxPending = std::max((size_t)SERVER_MIN_PENDING_REQUESTS, (size_t)pool->size());
+
+        // The connections that wait for their next request, they are owned by the loop
+        std::vector<IdleConnection> idle;
+        std::vector<pollfd> waitFor;
+        while (!serverStopping)
+        {
+            if (serverReloading)
+            {
+                serverReloading = 0;
+                std::lock_guard<std::mutex> lock(server.mutex);
+                server.reloads.push_back(nullptr);
+                server.reloadAvailable.notify_one();
+            }
+
+            // Takes back the connections that were served, a connection whose next request was
+            // already received into it's buffer is served again right away
+            std::vector<std::shared_ptr<UnixSocket>> returned;
+            {
+                std::lock_guard<std::mutex> lock(server.mutex);
+                returned.swap(server.returned);
+            }
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            for (std::shared_ptr<UnixSocket>& connection : returned)
+            {
+                if (isRequestBuffered(*connection))
+                {
+                    dispatch(std::move(connection));
+                }
+                else
+                {
+                    connection->shrinkBuffer();
+                    idle.push_back({std::move(connection), now});
+                }
+            }
+
+            // Closes the connections whose request didn't arrive in full in time, and counts the
+            // requests the server holds: the connections that are not idle are being served
+            size_t kept = 0;
+            size_t partial = 0;
+            for (size_t i = 0; i < idle.size(); i++)
+            {
+                if (!idle[i].socket->bufferedBytes().empty())
+                {
+                    if (now - idle[i].partialSince >
+                        std::chrono::milliseconds(SERVER_IO_TIMEOUT_MILLIS))
+                    {
+                        closeConnection(server, idle[i].socket);
+                        continue;
+                    }
+                    partial++;
+                }
+                idle[kept++] = std::move(idle[i]);
+            }
+            idle.resize(kept);
+            size_t numOfOpen = 0;
+            {
+                std::lock_guard<std::mutex> lock(server.mutex);
+                numOfOpen = server.open.size();
+            }
+            bool readNewRequests = (numOfOpen - idle.size()) + partial < maxPending;
+
+            // A negative descriptor is skipped by poll
+            waitFor.assign({{numOfOpen < SERVER_MAX_CONNECTIONS ? listener.fd() : -1, POLLIN, 0},
+                            {server.wakeFds[PIPE_READ_END], POLLIN, 0}});
+            for (const IdleConnection& connection : idle)
+            {
+                bool read = readNewRequests || !connection.socket->bufferedBytes().empty();
+                waitFor.push_back({read ? connection.socket->fd() : -1, POLLIN, 0});
+            }
+            if (::poll(waitFor.data(), waitFor.size(), SERVER_POLL_MILLIS) <= 0)
+            {
+                continue;
+            }
+
+            char drained[SERVER_WAKE_BUFFER_SIZE];
+            while (::read(server.wakeFds[PIPE_READ_END], drained, sizeof(drained)) > 0)
+            {
+            }
+
+            // Receives the bytes of the connections that have any, and serves the connections
+            // whose request arrived in full (or that ended). A client that sends a part of a
+            // request doesn't hold a worker while the rest of it is on the way
+            now = std::chrono::steady_clock::now();
+            kept = 0;
+            for (size_t i = 0; i < idle.size(); i++)
+            {
+                if (waitFor[i + SERVER_POLLED_FDS].revents != 0)
+                {
+                    UnixSocket& connection = *idle[i].socket;
+                    bool started = connection.bufferedBytes().empty();
+                    if (!connection.receiveAvailable(MAX_REQUEST_SIZE) ||
+                        isRequestBuffered(connection))
+                    {
+                        dispatch(std::move(idle[i].socket));
+                        continue;
+                    }
+                    if (started)
+                    {
+                        idle[i].partialSince = now;
+                    }
+                }
+                idle[kept++] = std::move(idle[i]);
+            }
+            idle.resize(kept);
+
+            if (waitFor[0].revents != 0)
+            {
+                UnixSocket accepted = listener.accept(0);
+                if (accepted.valid())
+                {
+                    // A client that doesn't read it's responses can't hold a worker forever
+                    accepted.setTimeout(SERVER_IO_TIMEOUT_MILLIS);
+                    std::shared_ptr<UnixSocket> connection = std::make_shared<UnixSocket>(
+                            std::move(accepted));
+                    {
+                        std::lock_guard<std::mutex> lock(server.mutex);
+                        server.open.insert(connection.get());
+                    }
+                    idle.push_back({std::move(connection), now});
+                }
+            }
+        }
+
+        // Stops accepting and reloading, and wakes up the workers that wait for requests
+        listener.close();
+        ::unlink(socketPath.c_str());
+        {
+            std::lock_guard<std::mutex> lock(server.mutex);
+            server.stopping = true;
+            for (UnixSocket* connection : server.open)
+            {
+                connection->shutdownStream();
+            }
+        }
+        server.reloadAvailable.notify_all();
+        reloader.join();
+        pool.reset();
+    }
+    ::close(server.wakeFds[PIPE_READ_END]);
+    ::close(server.wakeFds[PIPE_WRITE_END]);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief the client mode. Sends email files to a server (see serveRequest) and prints a line
+ *        for each one: "<path> SPAM <score>", "<path> NOT_SPAM <score>" or "<path> Invalid input"
+ *        (also for an email file larger than MAX_REQUEST_BODY_LENGTH)
+ * @param argc - the number of arguments (after the options)
+ * @param argv - the arguments: <socket path> <threshold | -> <message path>...
+ * @return 0 if success, 1 if failure
+ */
+int runClient(int argc, char *argv[])
+{
+    if (argc < NUMBER_OF_CLIENT_ARGS)
+    {
+        std::cout << CLIENT_USAGE_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string socketPath = argv[0];
+    std::string thresholdStr = argv[1];
+    UnixSocket connection;
+    try
+    {
+        connection = UnixSocket::connectTo(socketPath);
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    for (int i = NUMBER_OF_CLIENT_ARGS - 1; i < argc; i++)
+    {
+        std::string path = argv[i];
+        std::ifstream file(path, std::ios::binary);
+        if (!file || boost::filesystem::is_directory(path))
+        {
+            std::cout << path << " " << INVALID_INPUT_ERR << std::endl;
+            exitCode = EXIT_FAILURE;
+            continue;
+        }
+        std::string body((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (body.size() > MAX_REQUEST_BODY_LENGTH)
+        {
+            std::cout << path << " " << INVALID_INPUT_ERR << std::endl;
+            exitCode = EXIT_FAILURE;
+            continue;
+        }
+
+        std::string response;
+        std::string request = std::string(REQUEST_BODY) + " " + thresholdStr + " " +
+                              std::to_string(body.size()) + "\n";
+        if (!connection.writeAll(request) || !connection.writeAll(body) ||
+            !connection.readLine(response, MAX_REQUEST_LINE_LENGTH))
+        {
+            std::cerr << INVALID_INPUT_ERR << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (response.compare(0, std::strlen(RESPONSE_ERROR), RESPONSE_ERROR) == 0)
+        {
+            response = response.substr(std::strlen(RESPONSE_ERROR));
+            exitCode = EXIT_FAILURE;
+        }
+        std::cout << path << " " << response << std::endl;
+    }
+    return exitCode;
+}
+
+// The benchmarks include this file for the functions of the program, and define
+// SPAM_DETECTOR_NO_MAIN to leave out it's main
+#ifndef SPAM_DETECTOR_NO_MAIN
+
+/**
+ * @brief the main function. Gets a path to a db file and a text file and a threshold number. Reads
+ *        the db file and saves the values in a hash map. Then it counts how many times each string
+ *        in the db file appears in the email file, calculates the total score and prints if the
+ *        text file is a spam file or not. Options (before the other arguments): --batch to check
+ *        many email files (see runBatch), --threads=<n> for the number of threads of the batch
+ *        or the server (up to MAX_NUM_OF_THREADS), --compile to compile the db file into a
+ *        snapshot (see runCompile). The db path can be a snapshot in all modes. --mmap maps the
+ *        email files and --stream reads them in chunks, instead of reading them into a string.
+ *        --early-exit stops scanning an email as soon as it's score reaches the threshold (the
+ *        verdict is decided, the full score is not calculated) and prints the number of bytes
+ *        scanned to the standard error. --server runs the server mode (see runServer) and
+ *        --client the client mode (see runClient).
+ *        --explain prints a JSON report of a single email instead of the verdict (see
+ *        runExplain). --engine=<automaton | rolling | scan> picks the way the phrases are found
+ *        in a single email: the Aho-Corasick automaton (the default), the RollingHashMatcher or
+ *        the phrase by phrase scan. The other engines read the whole email, and can't be used
+ *        with --explain, --early-exit, --mmap, --stream or the other modes
+ * @param argc - the number of arguments
+ * @param argv - the arguments
+ * @return 0 if success, 1 if failure
+ */
+int main(int argc, char *argv[])
+{
+    // Reads the options, all of them come before the other arguments
+    bool batchMode = false;
+    bool compileMode = false;
+    EmailReadMode readMode = READ_WHOLE;
+    MatchEngine engine = ENGINE_AHO_CORASICK;
+    bool earlyExit = false;
+    bool serverMode = false;
+    bool clientMode = false;
+    bool explainMode = false;
+    int numOfThreads = 0;
+    int argIndex = 1;
+    for (; argIndex < argc && std::strncmp(argv[argIndex], OPTION_PREFIX,
+                                           std::strlen(OPTION_PREFIX)) == 0; argIndex++)
+    {
+        std::string option = argv[argIndex];
+        if (option == BATCH_OPTION)
+        {
+            batchMode = true;
+        }
+        else if (option == COMPILE_OPTION)
+        {
+            compileMode = true;
+        }
+        else if (option == MMAP_OPTION)
+        {
+            readMode = READ_MAPPED;
+        }
+        else if (option == STREAM_OPTION)
+        {
+            readMode = READ_STREAMED;
+        }
+        else if (option == EARLY_EXIT_OPTION)
+        {
+            earlyExit = true;
+        }
+        else if (option == SERVER_OPTION)
+        {
+            serverMode = true;
+        }
+        else if (option == CLIENT_OPTION)
+        {
+            clientMode = true;
+        }
+        else if (option == EXPLAIN_OPTION)
+        {
+            explainMode = true;
+        }
+        else if (option.compare(0, std::strlen(ENGINE_OPTION), ENGINE_OPTION) == 0)
+        {
+            std::string value = option.substr(std::strlen(ENGINE_OPTION));
+            if (value == ENGINE_AUTOMATON)
+            {
+                engine = ENGINE_AHO_CORASICK;
+            }
+            else if (value == ENGINE_ROLLING_HASH)
+            {
+                engine = ENGINE_ROLLING;
+            }
+            else if (value == ENGINE_PHRASE_SCAN)
+            {
+                engine = ENGINE_SCAN;
+            }
+            else
+            {
+                std::cerr << INVALID_INPUT_ERR << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (option.compare(0, std::strlen(THREADS_OPTION), THREADS_OPTION) == 0)
+        {
+            // A number that doesn't fit an int, or more threads than MAX_NUM_OF_THREADS, is
+            // invalid like any other bad number
+            std::string value = option.substr(std::strlen(THREADS_OPTION));
+            const char* valueEnd = value.data() + value.size();
+            if (value.empty() || !isValidString(value) ||
+                std::from_chars(value.data(), valueEnd, numOfThreads).ec != std::errc() ||
+                numOfThreads > MAX_NUM_OF_THREADS)
+            {
+                std::cerr << INVALID_INPUT_ERR << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            std::cout << USAGE_ERR << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // The explain mode and the other engines check a single email, the other engines read it
+    // whole and scan all of it
+    bool otherEngine = engine != ENGINE_AHO_CORASICK;
+    if ((explainMode || otherEngine) && (serverMode || clientMode || compileMode || batchMode))
+    {
+        std::cout << USAGE_ERR << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (otherEngine && (explainMode || earlyExit || readMode != READ_WHOLE))
+    {
+        std::cout << USAGE_ERR << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (serverMode)
+    {
+        return runServer(argc - argIndex, argv + argIndex, numOfThreads, readMode, earlyExit);
+    }
+    if (clientMode)
+    {
+        return runClient(argc - argIndex, argv + argIndex);
+    }
+    if (compileMode)
+    {
+        return runCompile(argc - argIndex, argv + argIndex);
+    }
+    if (batchMode)
+    {
+        return runBatch(argc - argIndex, argv + argIndex, numOfThreads, readMode, earlyExit);
+    }
+
+    // Checks if the number of arguments is not valid
+    if (argc - argIndex != NUMBER_OF_ARGS - 1)
+    {
+        std::cout << USAGE_ERR << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::string dataBaseFilePath = argv[argIndex];
+    std::string emailFilePath = argv[argIndex + 1];
+    std::string thresholdStr = argv[argIndex + 2];
+
+    // check validity for threshold
+    double threshold = 0;
+    if (!readThreshold(thresholdStr, threshold))
+    {
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (explainMode)
+    {
+        return runExplain(dataBaseFilePath, emailFilePath, threshold);
+    }
+    if (otherEngine)
+    {
+        int totalScore = 0;
+        try
+        {
+            totalScore = scoreWithEngine(dataBaseFilePath, emailFilePath, engine);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << INVALID_INPUT_ERR << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << ((threshold <= totalScore) ? SPAM_STR : NOT_SPAM_STR) << std::endl;
+        return 0;
+    }
+
+    // Compiles all the sentences into one automaton that scores the email in a single pass (or
+    // maps an automaton that was already compiled into a snapshot)
+    std::unique_ptr<AhoCorasick> matcher;
+    try
+    {
+        matcher = loadMatcher(dataBaseFilePath);
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Scores the email, in the early exit mode only until the score reaches the threshold
+    EmailScore score = {0, 0, 0};
+    try
+    {
+        score = scoreEmailFile(emailFilePath, *matcher, readMode,
+                               earlyExit ? scoreTargetOf(threshold) : NO_SCORE_TARGET);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << INVALID_INPUT_ERR << std::endl;
+        return EXIT_FAILURE;
+    }
+    int totalScore = score.totalScore;
+
+    // Checks if the threshold is lower than the total score
+    if (threshold <= totalScore)
+    {
+        std::cout << SPAM_STR << std::endl;
+    }
+    else
+    {
+        std::cout << NOT_SPAM_STR << std::endl;
+    }
+
+    if (earlyExit)
+    {
+        std::cerr << SCANNED_BYTES_MSG << score.bytesScanned << SCANNED_BYTES_OF
+                  << score.bytesTotal << std::endl;
+    }
+    return 0;
+}
+
+#endif //SPAM_DETECTOR_NO_MAIN
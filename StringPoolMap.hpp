@@ -0,0 +1,676 @@
+// StringPoolMap.hpp
+
+#ifndef CPP_EX3_STRINGPOOLMAP_HPP
+#define CPP_EX3_STRINGPOOLMAP_HPP
+
+#define POOL_MIN_CAPACITY 16
+#define POOL_MAX_LOAD_NUMERATOR 3
+#define POOL_MAX_LOAD_DENOMINATOR 4
+#define POOL_EMPTY_SLOT 0
+#define POOL_TAG_SHIFT 32
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include "FastHash.hpp"
+
+// ------------------------------------------- class declaration -----------------------------------
+
+template <class ValueT>
+
+/**
+ * @brief a map from strings to values that interns all it's keys into one contiguous pool of
+ *        characters. The pairs are saved one after the other in the order they were inserted, as a
+ *        std::string_view of the key in the pool and the value, and a table of slots (the index of
+ *        a pair and 32 bits of the hash of it's key, open addressing with linear probing) finds
+ *        them. There is no allocation per key, and iterating over the map reads the pairs and the
+ *        keys sequentially. The pool only grows: the characters of an erased key stay in it until
+ *        the map is copied. Fits tables of many short strings that are built once, like the
+ *        sentences of the database
+ * @tparam ValueT - the template parameter that represents the value
+ */
+class StringPoolMap
+{
+    typedef std::pair<std::string_view, ValueT> pair;
+
+    // a slot of the table: the index of the pair + 1 (POOL_EMPTY_SLOT if the slot is empty) and
+    // the high bits of the hash of it's key, so most keys are rejected without reading the pair
+    struct Slot
+    {
+        uint32_t entry; // the index of the pair + 1, or POOL_EMPTY_SLOT
+        uint32_t tag;   // the high 32 bits of the hash of the key
+    };
+
+private:
+    std::vector<char> _pool;   // the characters of the keys, one after the other
+    std::vector<pair> _pairs;  // the pairs, their keys are views of the pool
+    std::vector<Slot> _slots;  // the table of slots, a power of two size
+    uint64_t _seed;            // the seed of the hash of the keys
+
+//-----------------------------------------private functions----------------------------------------
+
+    // Gets a key and calculates it's hash
+    uint64_t _hashOf(std::string_view key) const
+    {
+        return FastHashCore::hashBytes(key.data(), key.size(), _seed);
+    }
+
+    // returns the tag of a hash in it's slot
+    static uint32_t _tagOf(uint64_t hash)
+    {
+        return (uint32_t)(hash >> POOL_TAG_SHIFT);
+    }
+
+    // returns the index of the slot of the key, or the index of the empty slot it would be
+    // inserted into
+    size_t _findSlot(std::string_view key, uint64_t hash) const;
+
+    // copies the characters of a key to the end of the pool and returns the view of the copy. If
+    // the pool grows, the views of all the keys are moved to the new pool. The key may be a view
+    // into the pool
+    std::string_view _intern(std::string_view key);
+
+    // moves the views of the keys from the previous pool to the current one
+    void _rebase(const char* previous);
+
+    // builds the table of slots again with the given number of slots
+    void _rehash(size_t capacity);
+
+    // makes sure there is room in the table for the given number of pairs
+    void _reserveSlots(size_t count);
+
+    // inserts a pair<key, value> if the key doesn't exist, returns the index of the pair of the
+    // key and true if it was inserted
+    std::pair<size_t, bool> _tryInsert(std::string_view key, const ValueT& value);
+
+    // inserts the pairs of the vectors, a later value of a key overrides an earlier one
+    template <class Keys>
+    void _bulkInsert(const Keys& keys, const std::vector<ValueT>& values);
+
+public:
+
+    /**
+     * @brief a const iterator over the pairs of the map, in the order they were inserted. The key
+     *        of a pair is a std::string_view of the pool (valid until the pool grows)
+     */
+    typedef typename std::vector<pair>::const_iterator const_iterator;
+
+    /**
+     * @brief returns iterator to the begin of the map
+     * @return iterator to the begin of the map
+     */
+    const_iterator begin() const
+    {
+        return _pairs.begin();
+    }
+
+    /**
+     * @brief returns an iterator to the end of the map
+     * @return an iterator to the end of the map
+     */
+    const_iterator end() const
+    {
+        return _pairs.end();
+    }
+
+    /**
+     * @brief returns iterator to the begin of the map
+     * @return iterator to the begin of the map
+     */
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    /**
+     * @brief returns an iterator to the end of the map
+     * @return an iterator to the end of the map
+     */
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /**
+     * @brief default constructor, initializes an empty map
+     * @param seed - the seed of the hash of the keys
+     */
+    explicit StringPoolMap(uint64_t seed = FastHashCore::defaultSeed());
+
+    /**
+     * @brief a constructor for the map, receives a vector of keys and a vector of values. The
+     *        pool and the table are sized for all the keys first. If a key appears more than
+     *        once, it's last value is saved
+     * @param keys   - a vector that contains keys (views of strings that are copied into the pool)
+     * @param values - a vector that contains values
+     * @throw std::invalid_argument if the vectors have different sizes
+     */
+    StringPoolMap(const std::vector<std::string_view>& keys, const std::vector<ValueT>& values);
+
+    /**
+     * @brief a constructor for the map, receives a vector of keys and a vector of values
+     * @param keys   - a vector that contains keys
+     * @param values - a vector that contains values
+     * @throw std::invalid_argument if the vectors have different sizes
+     */
+    StringPoolMap(const std::vector<std::string>& keys, const std::vector<ValueT>& values);
+
+    /**
+     * @brief copy constructor, the pool of the copy has only the keys that are in the map
+     * @param other - the other map
+     */
+    StringPoolMap(const StringPoolMap& other);
+
+    /**
+     * @brief move constructor, takes the pool, the pairs and the table of the other map (the
+     *        views of the keys stay valid). The other map is left empty
+     * @param other - the other map
+     */
+    StringPoolMap(StringPoolMap&& other) noexcept;
+
+    /**
+     * @brief copies the other map into the current map
+     * @param other - the other map
+     * @return the current map
+     */
+    StringPoolMap& operator=(const StringPoolMap& other);
+
+    /**
+     * @brief moves the other map into the current map, the other map is left empty
+     * @param other - the other map
+     * @return the current map
+     */
+    StringPoolMap& operator=(StringPoolMap&& other) noexcept;
+
+    /**
+     * @brief inserts a new pair<key, value> into the map, the key is copied into the pool
+     * @param key - the key to insert
+     * @param value - the value to insert
+     * @return true if the pair was inserted, false if the key exists
+     */
+    bool insert(std::string_view key, const ValueT& value);
+
+    /**
+     * @brief inserts the pair<key, value> if the key doesn't exist, otherwise overrides the value
+     *        of the key
+     * @param key - the key
+     * @param value - the value
+     * @return true if the pair was inserted, false if the value was overridden
+     */
+    bool insert_or_assign(std::string_view key, const ValueT& value);
+
+    /**
+     * @brief searches the key in the map
+     * @param key - the key
+     * @return an iterator to the pair of the key, or end() if the key doesn't exist
+     */
+    const_iterator find(std::string_view key) const;
+
+    /**
+     * @brief checks if the key exists in the map
+     * @param key - the key to check if exist
+     * @return true if the key exists, false otherwise
+     */
+    bool containsKey(std::string_view key) const
+    {
+        return find(key) != end();
+    }
+
+    /**
+     * @brief gets a key, checks if the key exists in the map, if yes, returns it's value
+     * @param key - the key
+     * @return - the value of the key
+     * @throw std::invalid_argument if the key doesn't exist
+     */
+    ValueT& at(std::string_view key);
+
+    /**
+     * @brief gets a key, checks if the key exists in the map, if yes, returns it's value (const)
+     * @param key - the key
+     * @return - the value of the key (const)
+     * @throw std::invalid_argument if the key doesn't exist
+     */
+    const ValueT& at(std::string_view key) const;
+
+    /**
+     * @brief returns the value of the key, inserts a default value if the key doesn't exist
+     * @param key - the key
+     * @return - the value of the key
+     */
+    ValueT& operator[](std::string_view key);
+
+    /**
+     * @brief erases the pair of the key. The last pair of the map is moved into it's place, and
+     *        the characters of the key stay in the pool
+     * @param key - the key
+     * @return - true if the key was erased, false if it doesn't exist
+     */
+    bool erase(std::string_view key);
+
+    /**
+     * @brief returns true if the map is empty
+     * @return true if the map is empty, false otherwise
+     */
+    bool empty() const
+    {
+        return _pairs.empty();
+    }
+
+    /**
+     * @brief returns the number of pairs
+     * @return - the number of pairs in the map
+     */
+    int size() const
+    {
+        return (int)_pairs.size();
+    }
+
+    /**
+     * @brief returns the number of slots of the table
+     * @return - the capacity of the map
+     */
+    int capacity() const
+    {
+        return (int)_slots.size();
+    }
+
+    /**
+     * @brief return the load factor
+     * @return the number of pairs per slot
+     */
+    double getLoadFactor() const
+    {
+        return _slots.empty() ? 0 : (double)_pairs.size() / _slots.size();
+    }
+
+    /**
+     * @brief makes sure the map can hold the given number of pairs, and keys with the given
+     *        number of characters in all, without growing
+     * @param count - the number of pairs
+     * @param poolBytes - the number of characters of the keys
+     */
+    void reserve(int count, size_t poolBytes = 0);
+
+    /**
+     * @brief returns the number of bytes the map allocated: the pool, the pairs and the slots
+     * @return the number of bytes
+     */
+    size_t bytes() const
+    {
+        return _pool.capacity() + _pairs.capacity() * sizeof(pair) +
+               _slots.capacity() * sizeof(Slot);
+    }
+
+    /**
+     * @brief clears the map and it's pool
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Checks if the current map equals other map
+     * @param other - the other map
+     * @return true if the maps have the same pairs, false otherwise
+     */
+    bool operator==(const StringPoolMap& other) const;
+
+    /**
+     * @brief Checks if the current map not equals other map
+     * @param other - the other map
+     * @return true if the maps are not equal, false otherwise
+     */
+    bool operator!=(const StringPoolMap& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+template <class ValueT>
+StringPoolMap<ValueT>::StringPoolMap(uint64_t seed) : _seed(seed)
+{
+}
+
+template <class ValueT>
+StringPoolMap<ValueT>::StringPoolMap(const std::vector<std::string_view>& keys,
+                                     const std::vector<ValueT>& values)
+        : StringPoolMap()
+{
+    _bulkInsert(keys, values);
+}
+
+template <class ValueT>
+StringPoolMap<ValueT>::StringPoolMap(const std::vector<std::string>& keys,
+                                     const std::vector<ValueT>& values)
+        : StringPoolMap()
+{
+    _bulkInsert(keys, values);
+}
+
+template <class ValueT>
+StringPoolMap<ValueT>::StringPoolMap(const StringPoolMap& other) : StringPoolMap(other._seed)
+{
+    size_t poolBytes = 0;
+    for (const pair& item : other._pairs)
+    {
+        poolBytes += item.first.size();
+    }
+    _pool.reserve(poolBytes);
+    _pairs.reserve(other._pairs.size());
+
+    // The pairs keep their order, so the slots of the other map are copied as they are
+    for (const pair& item : other._pairs)
+    {
+        _pairs.emplace_back(_intern(item.first), item.second);
+    }
+    _slots = other._slots;
+}
+
+template <class ValueT>
+StringPoolMap<ValueT>::StringPoolMap(StringPoolMap&& other) noexcept
+        : _pool(std::move(other._pool)), _pairs(std::move(other._pairs)),
+          _slots(std::move(other._slots)), _seed(other._seed)
+{
+    other.clear();
+}
+
+template <class ValueT>
+StringPoolMap<ValueT>& StringPoolMap<ValueT>::operator=(const StringPoolMap& other)
+{
+    if (this != &other)
+    {
+        StringPoolMap copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+template <class ValueT>
+StringPoolMap<ValueT>& StringPoolMap<ValueT>::operator=(StringPoolMap&& other) noexcept
+{
+    if (this != &other)
+    {
+        _pool = std::move(other._pool);
+        _pairs = std::move(other._pairs);
+        _slots = std::move(other._slots);
+        _seed = other._seed;
+        other.clear();
+    }
+    return *this;
+}
+
+template <class ValueT>
+template <class Keys>
+void StringPoolMap<ValueT>::_bulkInsert(const Keys& keys, const std::vector<ValueT>& values)
+{
+    // Checks if the size of the vectors are different, if yes, throws exception
+    if (keys.size() != values.size())
+    {
+        throw std::invalid_argument("Invalid args");
+    }
+
+    // Sizes the pool and the table for all the keys at once, so they never grow while the map is
+    // filled
+    size_t poolBytes = 0;
+    for (const auto& key : keys)
+    {
+        poolBytes += key.size();
+    }
+    reserve((int)keys.size(), poolBytes);
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        insert_or_assign(keys[i], values[i]);
+    }
+}
+
+template <class ValueT>
+size_t StringPoolMap<ValueT>::_findSlot(std::string_view key, uint64_t hash) const
+{
+    size_t mask = _slots.size() - 1;
+    uint32_t tag = _tagOf(hash);
+    for (size_t index = (size_t)hash & mask; ; index = (index + 1) & mask)
+    {
+        const Slot& slot = _slots[index];
+        if (slot.entry == POOL_EMPTY_SLOT ||
+            (slot.tag == tag && _pairs[slot.entry - 1].first == key))
+        {
+            return index;
+        }
+    }
+}
+
+template <class ValueT>
+std::string_view StringPoolMap<ValueT>::_intern(std::string_view key)
+{
+    // The key may be a view into the pool itself (a key of the map, or a part of one), it's
+    // offset is saved so it can be read again from the new pool after the pool grows
+    std::less<const char*> before;
+    bool inPool = !before(key.data(), _pool.data()) &&
+                  before(key.data(), _pool.data() + _pool.size());
+    size_t keyOffset = inPool ? (size_t)(key.data() - _pool.data()) : 0;
+    if (_pool.size() + key.size() > _pool.capacity())
+    {
+        const char* previous = _pool.data();
+        _pool.reserve(std::max(_pool.capacity() * 2, _pool.size() + key.size()));
+        _rebase(previous);
+        if (inPool)
+        {
+            key = std::string_view(_pool.data() + keyOffset, key.size());
+        }
+    }
+
+    // The pool has room for the key now, so resizing it doesn't move it, and the characters are
+    // copied from before the old end to after it (the ranges never overlap)
+    size_t offset = _pool.size();
+    _pool.resize(offset + key.size());
+    std::copy(key.begin(), key.end(), _pool.begin() + (std::ptrdiff_t)offset);
+    return std::string_view(_pool.data() + offset, key.size());
+}
+
+template <class ValueT>
+void StringPoolMap<ValueT>::_rebase(const char* previous)
+{
+    if (previous == _pool.data())
+    {
+        return;
+    }
+    for (pair& item : _pairs)
+    {
+        item.first = std::string_view(_pool.data() + (item.first.data() - previous),
+                                      item.first.size());
+    }
+}
+
+template <class ValueT>
+void StringPoolMap<ValueT>::_rehash(size_t capacity)
+{
+    // The keys are hashed again, in the order of the pairs (the pool is read sequentially)
+    _slots.assign(capacity, Slot{POOL_EMPTY_SLOT, 0});
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < _pairs.size(); i++)
+    {
+        uint64_t hash = _hashOf(_pairs[i].first);
+        size_t index = (size_t)hash & mask;
+        while (_slots[index].entry != POOL_EMPTY_SLOT)
+        {
+            index = (index + 1) & mask;
+        }
+        _slots[index] = Slot{(uint32_t)(i + 1), _tagOf(hash)};
+    }
+}
+
+template <class ValueT>
+void StringPoolMap<ValueT>::_reserveSlots(size_t count)
+{
+    size_t capacity = std::max<size_t>(_slots.size(), POOL_MIN_CAPACITY);
+    while (count * POOL_MAX_LOAD_DENOMINATOR > capacity * POOL_MAX_LOAD_NUMERATOR)
+    {
+        capacity *= 2;
+    }
+    if (capacity != _slots.size())
+    {
+        _rehash(capacity);
+    }
+}
+
+template <class ValueT>
+void StringPoolMap<ValueT>::reserve(int count, size_t poolBytes)
+{
+    _reserveSlots((size_t)std::max(count, 0));
+    _pairs.reserve((size_t)std::max(count, 0));
+    if (poolBytes > _pool.capacity())
+    {
+        const char* previous = _pool.data();
+        _pool.reserve(poolBytes);
+        _rebase(previous);
+    }
+}
+
+template <class ValueT>
+typename StringPoolMap<ValueT>::const_iterator
+StringPoolMap<ValueT>::find(std::string_view key) const
+{
+    if (_slots.empty())
+    {
+        return end();
+    }
+    const Slot& slot = _slots[_findSlot(key, _hashOf(key))];
+    return (slot.entry == POOL_EMPTY_SLOT) ? end() : begin() + (slot.entry - 1);
+}
+
+template <class ValueT>
+std::pair<size_t, bool> StringPoolMap<ValueT>::_tryInsert(std::string_view key,
+                                                          const ValueT& value)
+{
+    _reserveSlots(_pairs.size() + 1);
+    uint64_t hash = _hashOf(key);
+    size_t index = _findSlot(key, hash);
+    if (_slots[index].entry != POOL_EMPTY_SLOT)
+    {
+        return std::make_pair((size_t)_slots[index].entry - 1, false);
+    }
+    _pairs.emplace_back(_intern(key), value);
+    _slots[index] = Slot{(uint32_t)_pairs.size(), _tagOf(hash)};
+    return std::make_pair(_pairs.size() - 1, true);
+}
+
+template <class ValueT>
+bool StringPoolMap<ValueT>::insert(std::string_view key, const ValueT& value)
+{
+    return _tryInsert(key, value).second;
+}
+
+template <class ValueT>
+bool StringPoolMap<ValueT>::insert_or_assign(std::string_view key, const ValueT& value)
+{
+    std::pair<size_t, bool> result = _tryInsert(key, value);
+    if (!result.second)
+    {
+        _pairs[result.first].second = value;
+    }
+    return result.second;
+}
+
+template <class ValueT>
+ValueT& StringPoolMap<ValueT>::at(std::string_view key)
+{
+    return const_cast<ValueT&>(static_cast<const StringPoolMap&>(*this).at(key));
+}
+
+template <class ValueT>
+const ValueT& StringPoolMap<ValueT>::at(std::string_view key) const
+{
+    const_iterator it = find(key);
+    if (it == end())
+    {
+        throw std::invalid_argument("The key does not exist");
+    }
+    return it->second;
+}
+
+template <class ValueT>
+ValueT& StringPoolMap<ValueT>::operator[](std::string_view key)
+{
+    // inserts a default value only if the key doesn't exist
+    return _pairs[_tryInsert(key, ValueT()).first].second;
+}
+
+template <class ValueT>
+bool StringPoolMap<ValueT>::erase(std::string_view key)
+{
+    if (_slots.empty())
+    {
+        return false;
+    }
+    size_t mask = _slots.size() - 1;
+    size_t hole = _findSlot(key, _hashOf(key));
+    uint32_t entry = _slots[hole].entry;
+    if (entry == POOL_EMPTY_SLOT)
+    {
+        return false;
+    }
+
+    // Empties the slot and shifts back the slots after it that are not in their home slot, so no
+    // probe sequence is broken
+    _slots[hole].entry = POOL_EMPTY_SLOT;
+    for (size_t index = (hole + 1) & mask; _slots[index].entry != POOL_EMPTY_SLOT;
+         index = (index + 1) & mask)
+    {
+        size_t home = (size_t)_hashOf(_pairs[_slots[index].entry - 1].first) & mask;
+        if (((index - home) & mask) >= ((index - hole) & mask))
+        {
+            _slots[hole] = _slots[index];
+            _slots[index].entry = POOL_EMPTY_SLOT;
+            hole = index;
+        }
+    }
+
+    // Moves the last pair into the place of the erased pair, and points it's slot to it
+    size_t last = _pairs.size();
+    if (entry != last)
+    {
+        size_t index = _findSlot(_pairs[last - 1].first, _hashOf(_pairs[last - 1].first));
+        _slots[index].entry = entry;
+        _pairs[entry - 1] = std::move(_pairs[last - 1]);
+    }
+    _pairs.pop_back();
+    return true;
+}
+
+template <class ValueT>
+void StringPoolMap<ValueT>::clear() noexcept
+{
+    _pool.clear();
+    _pairs.clear();
+    _slots.clear();
+}
+
+template <class ValueT>
+bool StringPoolMap<ValueT>::operator==(const StringPoolMap& other) const
+{
+    if (size() != other.size())
+    {
+        return false;
+    }
+    for (const pair& item : _pairs)
+    {
+        const_iterator it = other.find(item.first);
+        if (it == other.end() || it->second != item.second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif //CPP_EX3_STRINGPOOLMAP_HPP
@@ -0,0 +1,199 @@
+/**
+* @file    StringPoolMapTest.cpp
+* @author  user
+* @version 1.0
+* @brief   Tests for StringPoolMap
+* @section runs a seeded random sequence of insert, insert_or_assign, erase, containsKey and
+*          operator[] on a StringPoolMap and on a std::unordered_map (the reference) and compares
+*          them, and their copies and moves, every few thousand operations. Then inserts keys that
+*          are views into the pool of the map itself (parts of it's own keys) while the pool grows,
+*          and checks the bulk constructors and the errors.
+*          Build: g++ -std=c++17 -O1 -g -fsanitize=address,undefined StringPoolMapTest.cpp
+*                 -o StringPoolMapTest
+*          Usage: StringPoolMapTest, exits with EXIT_FAILURE on the first failed check
+*/
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <random>
+#include "StringPoolMap.hpp"
+#include "TestCheck.hpp"
+
+#define TEST_SEED 1
+#define RANDOM_STEPS 300000
+#define RANDOM_KEYS 5000
+#define COMPARE_EVERY 30000
+#define SELF_INSERTS 5000
+
+// ------------------------------------------- functions -------------------------------------------
+
+/**
+ * @brief checks that a map has exactly the pairs of the reference, by lookups and by iteration
+ * @param map - the map
+ * @param reference - the reference
+ */
+static void checkSame(const StringPoolMap<int>& map,
+                      const std::unordered_map<std::string, int>& reference)
+{
+    TEST_CHECK(map.size() == (int)reference.size());
+    for (const auto& item : reference)
+    {
+        TEST_CHECK(map.containsKey(item.first));
+        TEST_CHECK(map.at(item.first) == item.second);
+    }
+    int count = 0;
+    for (const auto& item : map)
+    {
+        auto found = reference.find(std::string(item.first));
+        TEST_CHECK(found != reference.end() && found->second == item.second);
+        count++;
+    }
+    TEST_CHECK(count == (int)reference.size());
+}
+
+/**
+ * @brief compares random operations on a StringPoolMap with a std::unordered_map
+ */
+static void testRandomOperations()
+{
+    std::mt19937 random(TEST_SEED);
+    StringPoolMap<int> map;
+    std::unordered_map<std::string, int> reference;
+    for (int step = 0; step < RANDOM_STEPS; step++)
+    {
+        std::string key = "k" + std::to_string(random() % RANDOM_KEYS) +
+                          std::string(random() % 3 * 10, 'z');
+        int operation = (int)(random() % 10);
+        if (operation < 4)
+        {
+            TEST_CHECK(map.insert(key, step) == reference.emplace(key, step).second);
+        }
+        else if (operation < 7)
+        {
+            TEST_CHECK(map.erase(key) == (reference.erase(key) > 0));
+        }
+        else if (operation < 8)
+        {
+            TEST_CHECK(map.insert_or_assign(key, step) == (reference.count(key) == 0));
+            reference[key] = step;
+        }
+        else if (operation < 9)
+        {
+            TEST_CHECK(map.containsKey(key) == (reference.count(key) > 0));
+        }
+        else
+        {
+            TEST_CHECK(map[key] == reference[key]);
+        }
+
+        if (step % COMPARE_EVERY == 0)
+        {
+            checkSame(map, reference);
+            StringPoolMap<int> copy(map);
+            checkSame(copy, reference);
+            TEST_CHECK(copy == map);
+            StringPoolMap<int> moved(std::move(copy));
+            checkSame(moved, reference);
+            TEST_CHECK(copy.empty());
+            copy = moved;
+            checkSame(copy, reference);
+        }
+    }
+    checkSame(map, reference);
+}
+
+/**
+ * @brief inserts keys that are views into the pool of the map, so the pool grows while the key
+ *        is read from it
+ */
+static void testKeysFromThePool()
+{
+    StringPoolMap<int> map;
+    std::unordered_map<std::string, int> reference;
+    map.insert("a long first key that the other keys are cut from", 0);
+    reference.emplace("a long first key that the other keys are cut from", 0);
+    std::mt19937 random(TEST_SEED);
+    for (int i = 1; i <= SELF_INSERTS; i++)
+    {
+        // a part of an existing key, the first key is a part of the last inserted one too
+        std::string_view source = (map.begin() + (std::ptrdiff_t)(random() % map.size()))->first;
+        std::string_view key = source.substr(random() % source.size());
+        std::string expected(key);
+        bool inserted = reference.emplace(expected, i).second;
+        TEST_CHECK(map.insert(key, i) == inserted);
+
+        // a key that grows by one character of it's own every time
+        std::string_view last = (map.end() - 1)->first;
+        std::string grown = std::string(last) + "x";
+        map.insert_or_assign(last, i);
+        reference[std::string(last)] = i;
+        map[std::string_view(grown).substr(0, last.size())] = i;
+        map.insert(grown, i);
+        reference.emplace(grown, i);
+    }
+    checkSame(map, reference);
+
+    // a key of the map inserted again after it was erased, it's characters are still in the pool
+    std::string_view first = map.begin()->first;
+    std::string firstKey(first);
+    TEST_CHECK(map.erase(firstKey));
+    reference.erase(firstKey);
+    TEST_CHECK(map.insert(first, -1));
+    reference.emplace(firstKey, -1);
+    checkSame(map, reference);
+
+    // a bulk build from views of another map's pool
+    std::vector<std::string_view> keys;
+    std::vector<int> values;
+    for (const auto& item : map)
+    {
+        keys.push_back(item.first);
+        values.push_back(item.second);
+    }
+    StringPoolMap<int> built(keys, values);
+    checkSame(built, reference);
+}
+
+/**
+ * @brief checks the bulk constructors, clear and the errors
+ */
+static void testConstructorsAndErrors()
+{
+    std::vector<std::string> keys{"a", "b", "a", ""};
+    std::vector<int> values{1, 2, 3, 4};
+    StringPoolMap<int> built(keys, values);
+    TEST_CHECK(built.size() == 3 && built.at("a") == 3 && built.at("") == 4);
+    TEST_CHECK(built.begin()->first == "a");
+
+    std::vector<std::string_view> views{"x", "y"};
+    StringPoolMap<int> fromViews(views, std::vector<int>{1, 2});
+    TEST_CHECK(fromViews.at("y") == 2);
+    TEST_THROWS(StringPoolMap<int>(views, std::vector<int>{1}), std::invalid_argument);
+    TEST_THROWS(fromViews.at("zz"), std::invalid_argument);
+
+    fromViews.clear();
+    TEST_CHECK(fromViews.empty() && !fromViews.containsKey("x") && !fromViews.erase("x"));
+    fromViews.insert("x", 1);
+    TEST_CHECK(fromViews.at("x") == 1);
+
+    StringPoolMap<int> moved(std::move(fromViews));
+    TEST_CHECK(!fromViews.containsKey("x"));
+    fromViews.insert("y", 2);
+    TEST_CHECK(fromViews.at("y") == 2 && moved.at("x") == 1);
+}
+
+/**
+ * @brief runs the tests of StringPoolMap
+ * @return EXIT_SUCCESS if all the checks passed
+ */
+int main()
+{
+    testRandomOperations();
+    testKeysFromThePool();
+    testConstructorsAndErrors();
+    std::cout << "StringPoolMapTest: all checks passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+// TestCheck.hpp
+
+#ifndef CPP_EX3_TESTCHECK_HPP
+#define CPP_EX3_TESTCHECK_HPP
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <iostream>
+#include <cstdlib>
+
+// ------------------------------------------- macros ----------------------------------------------
+
+/**
+ * @brief checks a condition of a test. If it is false, prints the condition with it's file and
+ *        line and exits with EXIT_FAILURE. Unlike assert, it is also checked with -DNDEBUG
+ */
+#define TEST_CHECK(condition)                                                                     \
+    do                                                                                            \
+    {                                                                                             \
+        if (!(condition))                                                                         \
+        {                                                                                         \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition            \
+                      << std::endl;                                                               \
+            std::exit(EXIT_FAILURE);                                                              \
+        }                                                                                         \
+    } while (false)
+
+/**
+ * @brief checks that a statement of a test throws the given exception type, if not, fails like
+ *        TEST_CHECK
+ */
+#define TEST_THROWS(statement, exception)                                                         \
+    do                                                                                            \
+    {                                                                                             \
+        bool thrown = false;                                                                      \
+        try                                                                                       \
+        {                                                                                         \
+            statement;                                                                            \
+        }                                                                                         \
+        catch (const exception&)                                                                  \
+        {                                                                                         \
+            thrown = true;                                                                        \
+        }                                                                                         \
+        TEST_CHECK(thrown && #statement " throws " #exception);                                   \
+    } while (false)
+
+#endif //CPP_EX3_TESTCHECK_HPP
@@ -0,0 +1,232 @@
+// ThreadPool.hpp
+
+#ifndef CPP_EX3_THREADPOOL_HPP
+#define CPP_EX3_THREADPOOL_HPP
+
+#define MIN_NUM_OF_THREADS 1
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <system_error>
+
+// ------------------------------------------- class declaration -----------------------------------
+
+/**
+ * @brief a pool of worker threads with work stealing. Every worker has it's own queue of tasks,
+ *        takes tasks from the back of it's queue, and when it is empty steals tasks from the front
+ *        of the queues of the other workers, so tasks of uneven length are balanced between the
+ *        workers
+ */
+class ThreadPool
+{
+public:
+
+    /**
+     * @brief creates the pool and starts the workers. If a thread can't be started, the pool goes
+     *        on with the workers that started
+     * @param numOfThreads - the number of workers, 0 for the number of hardware threads
+     * @throw std::system_error if not even one worker can be started
+     */
+    explicit ThreadPool(int numOfThreads = 0);
+
+    /**
+     * @brief runs the tasks that are left and stops the workers
+     */
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief adds a task to the pool. The tasks are spread between the queues of the workers
+     * @param task - the task to run
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief waits until all the tasks that were submitted are done
+     */
+    void wait();
+
+    /**
+     * @brief returns the number of workers in the pool
+     * @return the number of workers
+     */
+    int size() const
+    {
+        return (int)_threads.size();
+    }
+
+private:
+
+    /**
+     * @brief the queue of tasks of a single worker
+     */
+    struct WorkQueue
+    {
+        std::mutex mutex;                         // guards the tasks
+        std::deque<std::function<void()>> tasks;  // the tasks of the worker
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> _queues; // a queue for every worker
+    std::vector<std::thread> _threads;               // the workers
+    std::mutex _mutex;                               // guards the sleeping and the waiting
+    std::condition_variable _workAvailable;          // wakes up workers when a task is added
+    std::condition_variable _allDone;                // wakes up wait() when the tasks are done
+    std::atomic<int> _queued;                        // the number of tasks in the queues
+    std::atomic<int> _pending;                       // the number of tasks that are not done
+    std::atomic<unsigned int> _nextQueue;            // the queue of the next submitted task
+    bool _stopping;                                  // true when the pool is destroyed
+
+    // takes a task from the worker's own queue, or steals one from another queue
+    bool _popTask(int self, std::function<void()>& task);
+
+    // the loop of every worker: runs tasks, and sleeps when there are none
+    void _workerLoop(int self);
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+inline ThreadPool::ThreadPool(int numOfThreads): _queued(0), _pending(0), _nextQueue(0),
+                                                 _stopping(false)
+{
+    if (numOfThreads <= 0)
+    {
+        numOfThreads = (int)std::thread::hardware_concurrency();
+    }
+    if (numOfThreads < MIN_NUM_OF_THREADS)
+    {
+        numOfThreads = MIN_NUM_OF_THREADS;
+    }
+
+    for (int i = 0; i < numOfThreads; i++)
+    {
+        _queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+    }
+
+    // The workers steal from all the queues, so the tasks of a queue whose thread didn't start are
+    // still run by the others
+    _threads.reserve(numOfThreads);
+    for (int i = 0; i < numOfThreads; i++)
+    {
+        try
+        {
+            _threads.emplace_back(&ThreadPool::_workerLoop, this, i);
+        }
+        catch (const std::system_error&)
+        {
+            if (_threads.empty())
+            {
+                throw;
+            }
+            break;
+        }
+    }
+}
+
+inline ThreadPool::~ThreadPool() noexcept
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _workAvailable.notify_all();
+    for (std::thread& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+inline void ThreadPool::submit(std::function<void()> task)
+{
+    _pending++;
+    WorkQueue& queue = *_queues[_nextQueue++ % _queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queued++;
+    }
+    _workAvailable.notify_one();
+}
+
+inline void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _allDone.wait(lock, [this]
+    {
+        return _pending == 0;
+    });
+}
+
+inline bool ThreadPool::_popTask(int self, std::function<void()>& task)
+{
+    int numOfQueues = (int)_queues.size();
+
+    // Goes over the own queue first (from the back), then over the other queues (from the front)
+    for (int i = 0; i < numOfQueues; i++)
+    {
+        WorkQueue& queue = *_queues[(self + i) % numOfQueues];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+        {
+            continue;
+        }
+        if (i == 0)
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        _queued--;
+        return true;
+    }
+    return false;
+}
+
+inline void ThreadPool::_workerLoop(int self)
+{
+    std::function<void()> task;
+    while (true)
+    {
+        if (_popTask(self, task))
+        {
+            task();
+            task = nullptr;
+            if (--_pending == 0)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _allDone.notify_all();
+            }
+            continue;
+        }
+
+        // Sleeps until a task is added or the pool is destroyed
+        std::unique_lock<std::mutex> lock(_mutex);
+        _workAvailable.wait(lock, [this]
+        {
+            return _queued > 0 || _stopping;
+        });
+        if (_stopping && _queued == 0)
+        {
+            return;
+        }
+    }
+}
+
+#endif //CPP_EX3_THREADPOOL_HPP
@@ -0,0 +1,443 @@
+// UnixSocket.hpp
+
+#ifndef CPP_EX3_UNIXSOCKET_HPP
+#define CPP_EX3_UNIXSOCKET_HPP
+
+#define INVALID_SOCKET_FD (-1)
+#define SOCKET_BACKLOG 128
+#define SOCKET_READ_BUFFER_SIZE 65536
+#define SOCKET_MILLIS_IN_SECOND 1000
+#define SOCKET_MICROS_IN_MILLI 1000
+
+// -------------------------------------- includes -------------------------------------------------
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+// ------------------------------------------- class declaration -----------------------------------
+
+/**
+ * @brief a connected or listening stream socket in the Unix domain (a local socket file), with
+ *        buffered reads of lines and of fixed size blocks. The socket is closed when the object is
+ *        destroyed
+ */
+class UnixSocket
+{
+public:
+
+    /**
+     * @brief creates an object with no socket
+     */
+    UnixSocket() : _fd(INVALID_SOCKET_FD), _begin(0), _end(0)
+    {
+    }
+
+    /**
+     * @brief takes ownership of an open socket
+     * @param fd - the file descriptor of the socket
+     */
+    explicit UnixSocket(int fd) : _fd(fd), _begin(0), _end(0)
+    {
+    }
+
+    /**
+     * @brief closes the socket
+     */
+    ~UnixSocket() noexcept
+    {
+        close();
+    }
+
+    UnixSocket(const UnixSocket&) = delete;
+    UnixSocket& operator=(const UnixSocket&) = delete;
+
+    /**
+     * @brief moves the socket of the other object into a new object
+     * @param other - the other object, left with no socket
+     */
+    UnixSocket(UnixSocket&& other) noexcept : _fd(other._fd), _buffer(std::move(other._buffer)),
+                                              _begin(other._begin), _end(other._end)
+    {
+        other._fd = INVALID_SOCKET_FD;
+    }
+
+    /**
+     * @brief closes the socket and moves the socket of the other object into this one
+     * @param other - the other object, left with no socket
+     * @return this object
+     */
+    UnixSocket& operator=(UnixSocket&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            _fd = other._fd;
+            _buffer = std::move(other._buffer);
+            _begin = other._begin;
+            _end = other._end;
+            other._fd = INVALID_SOCKET_FD;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief creates a socket file at the path and listens on it. A stale socket file at the path
+     *        is removed first, any other file at the path is left as it is
+     * @param path - the path of the socket file
+     * @return the listening socket
+     * @throw std::runtime_error if the socket can't be created, or the path is a file that is not
+     *        a socket
+     */
+    static UnixSocket listenOn(const std::string& path);
+
+    /**
+     * @brief connects to a listening socket
+     * @param path - the path of the socket file
+     * @return the connected socket
+     * @throw std::runtime_error if the connection fails
+     */
+    static UnixSocket connectTo(const std::string& path);
+
+    /**
+     * @brief waits for a connection on a listening socket
+     * @param timeoutMillis - the longest time to wait, in milliseconds
+     * @return the connected socket, or an object with no socket if the time passed, the wait was
+     *         interrupted by a signal, or it failed
+     */
+    UnixSocket accept(int timeoutMillis) const;
+
+    /**
+     * @brief checks if the object has a socket
+     * @return true if the object has a socket, false otherwise
+     */
+    bool valid() const
+    {
+        return _fd != INVALID_SOCKET_FD;
+    }
+
+    /**
+     * @brief returns the file descriptor of the socket, to wait for it with poll
+     * @return the file descriptor, or INVALID_SOCKET_FD if the object has no socket
+     */
+    int fd() const
+    {
+        return _fd;
+    }
+
+    /**
+     * @brief returns the bytes that were received and not read yet, poll doesn't report them as
+     *        readable
+     * @return the unread bytes, valid until the next read from the socket
+     */
+    std::string_view bufferedBytes() const
+    {
+        return std::string_view(_buffer.data() + _begin, _end - _begin);
+    }
+
+    /**
+     * @brief receives bytes that already arrived (a single receive) without waiting for more, and
+     *        keeps them after the unread bytes of the buffer. The buffer grows as needed, up to the
+     *        given size, a full buffer receives nothing
+     * @param maxBuffered - the largest size of the buffer, in bytes
+     * @return false on the end of the stream or an error, true otherwise
+     */
+    bool receiveAvailable(size_t maxBuffered);
+
+    /**
+     * @brief frees the memory of the buffer that is not needed for the unread bytes, after a large
+     *        block was read. The buffer keeps at least SOCKET_READ_BUFFER_SIZE bytes
+     */
+    void shrinkBuffer();
+
+    /**
+     * @brief limits the time a single receive or send on the socket can block, a read or a write
+     *        that takes longer fails
+     * @param timeoutMillis - the longest time, in milliseconds
+     */
+    void setTimeout(int timeoutMillis) const;
+
+    /**
+     * @brief closes the socket (if any)
+     */
+    void close()
+    {
+        if (_fd != INVALID_SOCKET_FD)
+        {
+            ::close(_fd);
+            _fd = INVALID_SOCKET_FD;
+        }
+    }
+
+    /**
+     * @brief shuts down both directions of a connected socket, a blocked read on it returns
+     */
+    void shutdownStream() const
+    {
+        if (_fd != INVALID_SOCKET_FD)
+        {
+            ::shutdown(_fd, SHUT_RDWR);
+        }
+    }
+
+    /**
+     * @brief reads a line (without the '\n')
+     * @param line - the string to save the line into
+     * @param maxLength - the longest line that is accepted
+     * @return true if a line was read, false on the end of the stream, an error or a longer line
+     */
+    bool readLine(std::string& line, size_t maxLength);
+
+    /**
+     * @brief reads exactly the given number of bytes
+     * @param count - the number of bytes
+     * @param data - the string to save the bytes into
+     * @return true if all the bytes were read, false on the end of the stream or an error
+     */
+    bool readBytes(size_t count, std::string& data);
+
+    /**
+     * @brief writes all the bytes (a closed peer is reported as a failure, not as a signal)
+     * @param data - the bytes to write
+     * @return true if all the bytes were written, false otherwise
+     */
+    bool writeAll(const std::string& data);
+
+private:
+    int _fd;                   // the file descriptor of the socket
+    std::vector<char> _buffer; // the bytes that were received and not read yet
+    size_t _begin;             // the first unread byte in the buffer
+    size_t _end;               // the end of the received bytes in the buffer
+
+    // fills the buffer with the next bytes of the stream, returns false on the end or an error
+    bool _fill();
+
+    // fills the address of a socket file
+    static void _addressOf(const std::string& path, sockaddr_un& address);
+};
+
+// ------------------------------------------- implementation --------------------------------------
+
+inline void UnixSocket::_addressOf(const std::string& path, sockaddr_un& address)
+{
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Invalid socket path " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+}
+
+inline UnixSocket UnixSocket::listenOn(const std::string& path)
+{
+    sockaddr_un address;
+    _addressOf(path, address);
+    UnixSocket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (!socket.valid())
+    {
+        throw std::runtime_error("Can't create a socket");
+    }
+
+    // Only a socket file is removed, a path of another file is a mistake of the caller
+    struct stat status;
+    if (::lstat(path.c_str(), &status) == 0)
+    {
+        if (!S_ISSOCK(status.st_mode))
+        {
+            throw std::runtime_error("Not a socket file " + path);
+        }
+        ::unlink(path.c_str());
+    }
+    if (::bind(socket._fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+        ::listen(socket._fd, SOCKET_BACKLOG) == -1)
+    {
+        throw std::runtime_error("Can't listen on " + path);
+    }
+    return socket;
+}
+
+inline UnixSocket UnixSocket::connectTo(const std::string& path)
+{
+    sockaddr_un address;
+    _addressOf(path, address);
+    UnixSocket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (!socket.valid())
+    {
+        throw std::runtime_error("Can't create a socket");
+    }
+    if (::connect(socket._fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1)
+    {
+        throw std::runtime_error("Can't connect to " + path);
+    }
+    return socket;
+}
+
+inline void UnixSocket::setTimeout(int timeoutMillis) const
+{
+    timeval timeout;
+    timeout.tv_sec = timeoutMillis / SOCKET_MILLIS_IN_SECOND;
+    timeout.tv_usec = (timeoutMillis % SOCKET_MILLIS_IN_SECOND) * SOCKET_MICROS_IN_MILLI;
+    ::setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+inline UnixSocket UnixSocket::accept(int timeoutMillis) const
+{
+    pollfd waitFor = {_fd, POLLIN, 0};
+    if (::poll(&waitFor, 1, timeoutMillis) <= 0)
+    {
+        return UnixSocket();
+    }
+    return UnixSocket(::accept(_fd, nullptr, nullptr));
+}
+
+inline bool UnixSocket::_fill()
+{
+    if (_buffer.empty())
+    {
+        _buffer.resize(SOCKET_READ_BUFFER_SIZE);
+    }
+    _begin = 0;
+    _end = 0;
+    while (true)
+    {
+        ssize_t received = ::recv(_fd, _buffer.data(), _buffer.size(), 0);
+        if (received > 0)
+        {
+            _end = (size_t)received;
+            return true;
+        }
+        if (received == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        return false;
+    }
+}
+
+inline bool UnixSocket::receiveAvailable(size_t maxBuffered)
+{
+    // Moves the unread bytes to the start of the buffer, the new bytes are received after them
+    if (_begin > 0)
+    {
+        std::memmove(_buffer.data(), _buffer.data() + _begin, _end - _begin);
+        _end -= _begin;
+        _begin = 0;
+    }
+    if (_end == _buffer.size())
+    {
+        if (_end >= maxBuffered)
+        {
+            return true;
+        }
+        _buffer.resize(std::min(maxBuffered,
+                                std::max((size_t)SOCKET_READ_BUFFER_SIZE, _buffer.size() * 2)));
+    }
+    while (true)
+    {
+        ssize_t received = ::recv(_fd, _buffer.data() + _end, _buffer.size() - _end,
+                                  MSG_DONTWAIT);
+        if (received > 0)
+        {
+            _end += (size_t)received;
+            return true;
+        }
+        if (received == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        return received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+inline void UnixSocket::shrinkBuffer()
+{
+    size_t unread = _end - _begin;
+    size_t size = std::max((size_t)SOCKET_READ_BUFFER_SIZE, unread);
+    if (_buffer.size() <= size)
+    {
+        return;
+    }
+    std::vector<char> buffer(size);
+    std::memcpy(buffer.data(), _buffer.data() + _begin, unread);
+    _buffer.swap(buffer);
+    _begin = 0;
+    _end = unread;
+}
+
+inline bool UnixSocket::readLine(std::string& line, size_t maxLength)
+{
+    line.clear();
+    while (true)
+    {
+        if (_begin == _end && !_fill())
+        {
+            return false;
+        }
+        const char* begin = _buffer.data() + _begin;
+        const char* found = static_cast<const char*>(std::memchr(begin, '\n', _end - _begin));
+        size_t length = (found != nullptr) ? (size_t)(found - begin) : _end - _begin;
+        if (line.size() + length > maxLength)
+        {
+            return false;
+        }
+        line.append(begin, length);
+        if (found != nullptr)
+        {
+            _begin += length + 1;
+            return true;
+        }
+        _begin = _end;
+    }
+}
+
+inline bool UnixSocket::readBytes(size_t count, std::string& data)
+{
+    // Reserves only what was already received, the count comes from the peer
+    data.clear();
+    data.reserve(std::min(count, _end - _begin));
+    while (data.size() < count)
+    {
+        if (_begin == _end && !_fill())
+        {
+            return false;
+        }
+        size_t length = std::min(count - data.size(), _end - _begin);
+        data.append(_buffer.data() + _begin, length);
+        _begin += length;
+    }
+    return true;
+}
+
+inline bool UnixSocket::writeAll(const std::string& data)
+{
+    size_t written = 0;
+    while (written < data.size())
+    {
+        ssize_t sent = ::send(_fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (sent == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent <= 0)
+        {
+            return false;
+        }
+        written += (size_t)sent;
+    }
+    return true;
+}
+
+#endif //CPP_EX3_UNIXSOCKET_HPP